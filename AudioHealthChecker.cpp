@@ -1,5 +1,7 @@
 #include "AudioHealthChecker.h"
 
+#include "pcmutils.h"
+
 #include <QFile>
 #include <QDataStream>
 #include <QProcess>
@@ -82,7 +84,7 @@ QVector<AudioHealthChecker::ToneSpec> AudioHealthChecker::toneSpecs()
 }
 
 //---------------------------------------------------------------------------------------
-bool AudioHealthChecker::createTestWav(const QString &path, QString *error)
+QVector<double> AudioHealthChecker::buildTestSamples()
 {
     QVector<double> samples;
 
@@ -103,7 +105,31 @@ bool AudioHealthChecker::createTestWav(const QString &path, QString *error)
 
     appendSilence(samples, 0.5, TEST_SAMPLE_RATE);
 
-    return writePcm16MonoWav(path, samples, TEST_SAMPLE_RATE, error);
+    return samples;
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioHealthChecker::createTestWav(const QString &path, QString *error)
+{
+    return writePcm16MonoWav(path, buildTestSamples(), TEST_SAMPLE_RATE, error);
+}
+
+//---------------------------------------------------------------------------------------
+QVector<float> AudioHealthChecker::createTestSignal()
+{
+    const QVector<double> samples = buildTestSamples();
+
+    QVector<float> out(samples.size());
+    for (int i = 0; i < samples.size(); ++i)
+        out[i] = float(samples[i]);
+
+    return out;
+}
+
+//---------------------------------------------------------------------------------------
+int AudioHealthChecker::testSampleRate()
+{
+    return TEST_SAMPLE_RATE;
 }
 
 //---------------------------------------------------------------------------------------
@@ -257,21 +283,30 @@ bool AudioHealthChecker::readPcm16Wav(const QString &path,
     const int frameSize = blockAlign;
     const int frames = pcmBytes.size() / frameSize;
 
-    wav.samples.reserve(frames);
-
     const uchar *p = reinterpret_cast<const uchar *>(pcmBytes.constData());
 
+    wav.samples.resize(frames);
+    float *out = wav.samples.data();
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (channels == 1 && frameSize == 2) {
+        pcm::s16ToFloat(reinterpret_cast<const qint16 *>(p), out, frames);
+        return true;
+    }
+#endif
+
+    const float scale = 1.0f / (32768.0f * float(channels));
+
     for (int i = 0; i < frames; ++i) {
-        double acc = 0.0;
+        qint32 acc = 0;
 
         for (int ch = 0; ch < channels; ++ch) {
             const int idx = i * frameSize + ch * bytesPerSample;
             const quint16 u = quint16(p[idx]) | (quint16(p[idx + 1]) << 8);
-            const qint16 s = static_cast<qint16>(u);
-            acc += double(s) / 32768.0;
+            acc += static_cast<qint16>(u);
         }
 
-        wav.samples.append(acc / double(channels));
+        out[i] = float(acc) * scale;
     }
 
     return true;
@@ -344,274 +379,362 @@ bool AudioHealthChecker::runPipeWireTest(const QString &testWavPath,
 //---------------------------------------------------------------------------------------
 double AudioHealthChecker::dbfs(double linearRms)
 {
-    if (linearRms <= 1e-12)
-        return -120.0;
-
-    return 20.0 * std::log10(linearRms);
+    return pcm::toDbfs(linearRms);
 }
 
 //---------------------------------------------------------------------------------------
-double AudioHealthChecker::rmsDbfs(const QVector<double> &x, int start, int count)
+double AudioHealthChecker::rmsDbfs(const Signal &s, int start, int count)
 {
-    if (x.isEmpty() || count <= 0)
+    if (s.size == 0 || count <= 0)
         return -120.0;
 
     start = std::max(0, start);
-    const int end = std::min(start + count, static_cast<int>(x.size()));
+    const int end = std::min(start + count, s.size);
     if (end <= start)
         return -120.0;
 
-    double sum = 0.0;
-
-    for (int i = start; i < end; ++i)
-        sum += x[i] * x[i];
-
+    const double sum = std::max(0.0, s.sumSq[end] - s.sumSq[start]);
     const double rms = std::sqrt(sum / double(end - start));
     return dbfs(rms);
 }
 
 //---------------------------------------------------------------------------------------
-double AudioHealthChecker::peakDbfs(const QVector<double> &x)
+double AudioHealthChecker::dropoutPercent(const Signal &s,
+                                          int start,
+                                          int count)
 {
-    double peak = 0.0;
+    const int win = qRound(0.02 * s.sampleRate); // 20 ms
+
+    if (win <= 0 || count <= win)
+        return 0.0;
+
+    start = std::max(0, start);
+    const int end = std::min(start + count, s.size);
+
+    if (end <= start + win)
+        return 0.0;
+
+    // Bandingkan energi (tanpa log per window): -12 dB RMS = faktor 10^(-12/10) pada mean square
+    const double fullMeanSq = (s.sumSq[end] - s.sumSq[start]) / double(end - start);
+    const double thresholdSum = fullMeanSq * std::pow(10.0, -12.0 / 10.0) * double(win);
 
-    for (double v : x)
-        peak = std::max(peak, std::abs(v));
+    int total = 0;
+    int bad = 0;
+
+    for (int i = start; i + win < end; i += win) {
+        total++;
+
+        if (s.sumSq[i + win] - s.sumSq[i] < thresholdSum)
+            bad++;
+    }
+
+    if (total == 0)
+        return 0.0;
 
-    return dbfs(peak);
+    return 100.0 * double(bad) / double(total);
 }
 
 //---------------------------------------------------------------------------------------
-double AudioHealthChecker::toneLevelDbfs(const QVector<double> &x,
-                                         int start,
-                                         int count,
-                                         int sampleRate,
-                                         double freqHz)
+double AudioHealthChecker::thdDb(const double *levelDbfs, int toneCount)
 {
-    if (x.isEmpty() || count <= 0)
+    // levelDbfs[0] = fundamental, sisanya harmonik
+    if (toneCount < 2)
         return -120.0;
 
-    start = std::max(0, start);
-    const int end = std::min(start + count, static_cast<int>(x.size()));
+    const double fundRms = std::pow(10.0, levelDbfs[0] / 20.0);
+    const double fundPower = fundRms * fundRms;
 
-    if (end <= start)
+    if (fundPower <= 1e-12)
         return -120.0;
 
-    double sumCos = 0.0;
-    double sumSin = 0.0;
-
-    const int n = end - start;
-
-    for (int i = 0; i < n; ++i) {
-        const double t = double(i) / double(sampleRate);
-        const double angle = 2.0 * PI_D * freqHz * t;
-        const double v = x[start + i];
+    double harmonicPower = 0.0;
 
-        sumCos += v * std::cos(angle);
-        sumSin += v * std::sin(angle);
+    for (int k = 1; k < toneCount; ++k) {
+        const double hRms = std::pow(10.0, levelDbfs[k] / 20.0);
+        harmonicPower += hRms * hRms;
     }
 
-    const double peakAmp = 2.0 * std::sqrt(sumCos * sumCos + sumSin * sumSin) / double(n);
-    const double rms = peakAmp / std::sqrt(2.0);
+    if (harmonicPower <= 1e-12)
+        return -120.0;
 
-    return dbfs(rms);
+    return 10.0 * std::log10(harmonicPower / fundPower);
 }
 
 //---------------------------------------------------------------------------------------
-double AudioHealthChecker::dropoutPercent(const QVector<double> &x,
-                                          int start,
-                                          int count,
-                                          int sampleRate)
+void AudioHealthChecker::ToneAccumulator::reset(const double *freqHz,
+                                                int tones,
+                                                int sampleRate,
+                                                int segStart,
+                                                int segCount)
 {
-    const int win = qRound(0.02 * sampleRate); // 20 ms
+    if (segStart < 0) {
+        segCount += segStart;
+        segStart = 0;
+    }
 
-    if (win <= 0 || count <= win)
-        return 0.0;
+    start = segStart;
+    count = std::max(0, segCount);
+    done = 0;
+    toneCount = std::max(0, std::min(tones, MAX_TONES));
 
-    start = std::max(0, start);
-    const int end = std::min(start + count, static_cast<int>(x.size()));
+    for (int k = 0; k < MAX_TONES; ++k) {
+        coeff[k] = k < toneCount ? 2.0 * std::cos(2.0 * PI_D * freqHz[k] / double(sampleRate)) : 0.0;
+        s1[k] = 0.0;
+        s2[k] = 0.0;
+    }
 
-    if (end <= start + win)
-        return 0.0;
+    const double step = count > 1 ? 2.0 * PI_D / double(count - 1) : 0.0;
+    rotCos = std::cos(step);
+    rotSin = std::sin(step);
+    phCos = 1.0;
+    phSin = 0.0;
+    windowSum = 0.0;
+}
 
-    const double fullRmsDb = rmsDbfs(x, start, end - start);
-    const double thresholdDb = fullRmsDb - 12.0;
+//---------------------------------------------------------------------------------------
+void AudioHealthChecker::ToneAccumulator::feed(const float *x, int firstIndex, int n)
+{
+    // x[0] = sampel absolut firstIndex; ambil hanya bagian yang masuk segmen
+    const int from = std::max(firstIndex, start + done);
+    const int to = std::min(firstIndex + n, start + count);
+
+    if (to <= from)
+        return;
+
+    for (int i = from; i < to; ++i) {
+        const double w = 0.5 - 0.5 * phCos;
+        const double v = double(x[i - firstIndex]) * w;
+        windowSum += w;
+
+        // Lane independen berukuran tetap -> ter-vectorize
+        for (int k = 0; k < MAX_TONES; ++k) {
+            const double s0 = v + coeff[k] * s1[k] - s2[k];
+            s2[k] = s1[k];
+            s1[k] = s0;
+        }
 
-    int total = 0;
-    int bad = 0;
+        const double c = phCos * rotCos - phSin * rotSin;
+        phSin = phSin * rotCos + phCos * rotSin;
+        phCos = c;
+    }
 
-    for (int i = start; i + win < end; i += win) {
-        const double wDb = rmsDbfs(x, i, win);
-        total++;
+    done += to - from;
+}
 
-        if (wDb < thresholdDb)
-            bad++;
+//---------------------------------------------------------------------------------------
+void AudioHealthChecker::ToneAccumulator::levelsDbfs(double *levelDbfs) const
+{
+    for (int k = 0; k < toneCount; ++k) {
+        if (windowSum <= 0.0) {
+            levelDbfs[k] = -120.0;
+            continue;
+        }
+
+        const double power = std::max(0.0, s1[k] * s1[k] + s2[k] * s2[k] - coeff[k] * s1[k] * s2[k]);
+        const double peakAmp = 2.0 * std::sqrt(power) / windowSum;
+        levelDbfs[k] = dbfs(peakAmp / std::sqrt(2.0));
     }
+}
 
-    if (total == 0)
-        return 0.0;
+//---------------------------------------------------------------------------------------
+AudioHealthChecker::StreamAnalyzer::StreamAnalyzer(int sampleRate)
+    : m_sampleRate(sampleRate)
+{
+    // Stimulus + margin latency; feed() tetap bisa tumbuh kalau lebih panjang
+    const int expected = std::max(0, sampleRate) * 10;
+    m_samples.reserve(expected);
+    m_sumSq.reserve(expected + 1);
+    m_sumSq.append(0.0);
+}
 
-    return 100.0 * double(bad) / double(total);
+//---------------------------------------------------------------------------------------
+AudioHealthChecker::Signal AudioHealthChecker::StreamAnalyzer::view() const
+{
+    Signal s;
+    s.x = m_samples.constData();
+    s.size = int(m_samples.size());
+    s.sampleRate = m_sampleRate;
+    s.sumSq = m_sumSq.constData();
+    return s;
 }
 
 //---------------------------------------------------------------------------------------
-int AudioHealthChecker::findSyncStartSample(const QVector<double> &x, int sampleRate)
+void AudioHealthChecker::StreamAnalyzer::feed(const float *samples, int count)
 {
-    const int noiseCount = std::min(qRound(0.35 * sampleRate), static_cast<int>(x.size()));
-    const double noiseDb = rmsDbfs(x, 0, noiseCount);
-    const double noiseLinear = std::pow(10.0, noiseDb / 20.0);
+    if (!samples || count <= 0 || m_sampleRate <= 0)
+        return;
 
-    const double minThreshold = 0.02;
-    const double threshold = std::max(minThreshold, noiseLinear * 5.0);
+    const int first = int(m_samples.size());
 
-    const int win = qRound(0.02 * sampleRate); // 20 ms
-    const int hop = qRound(0.01 * sampleRate); // 10 ms
+    m_samples.resize(first + count);
+    m_sumSq.resize(first + count + 1);
 
-    for (int i = 0; i + win < x.size(); i += hop) {
-        double sum = 0.0;
+    float *dst = m_samples.data() + first;
+    double *sumSq = m_sumSq.data() + first;
 
-        for (int j = 0; j < win; ++j) {
-            const double v = x[i + j];
-            sum += v * v;
-        }
+    // Prefix sum berantai (serial); peak / clipping lewat kernel SIMD
+    std::copy(samples, samples + count, dst);
+
+    double acc = sumSq[0];
+    for (int i = 0; i < count; ++i) {
+        acc += double(dst[i]) * double(dst[i]);
+        sumSq[i + 1] = acc;
+    }
 
-        const double rms = std::sqrt(sum / double(win));
+    const pcm::Levels l = pcm::levels(samples, count, 0.98f);
+    m_peak = std::max(m_peak, l.peak);
+    m_clipped += l.clipped;
 
-        if (rms > threshold)
-            return i;
+    if (!syncFound()) {
+        // onSyncFound() mengejar semua sampel yang sudah tersimpan
+        detectSync();
+        return;
     }
 
-    return -1;
+    for (ToneAccumulator &tone : m_tones)
+        tone.feed(dst, first, count);
+    m_thd.feed(dst, first, count);
 }
 
 //---------------------------------------------------------------------------------------
-double AudioHealthChecker::thd1kDb(const QVector<double> &x,
-                                   int start,
-                                   int count,
-                                   int sampleRate)
+void AudioHealthChecker::StreamAnalyzer::detectSync()
 {
-    const double fundDb = toneLevelDbfs(x, start, count, sampleRate, 1000.0);
-    const double fundRms = std::pow(10.0, fundDb / 20.0);
-    const double fundPower = fundRms * fundRms;
+    const int size = int(m_samples.size());
+    const int win = qRound(0.02 * m_sampleRate); // 20 ms
+    const int hop = qRound(0.01 * m_sampleRate); // 10 ms
 
-    if (fundPower <= 1e-12)
-        return -120.0;
+    if (win <= 0 || hop <= 0)
+        return;
 
-    double harmonicPower = 0.0;
+    if (m_syncThresholdSum < 0.0) {
+        // Threshold dari noise 0.35 s pertama (sebelum sync beep di stimulus)
+        const int noiseCount = qRound(0.35 * m_sampleRate);
+        if (size < noiseCount)
+            return;
 
-    for (double h : {2000.0, 3000.0, 4000.0, 5000.0, 6000.0}) {
-        if (h >= sampleRate / 2.0)
-            continue;
+        const double noiseLinear = std::sqrt(m_sumSq[noiseCount] / double(noiseCount));
 
-        const double hDb = toneLevelDbfs(x, start, count, sampleRate, h);
-        const double hRms = std::pow(10.0, hDb / 20.0);
-        harmonicPower += hRms * hRms;
-    }
+        const double minThreshold = 0.02;
+        const double threshold = std::max(minThreshold, noiseLinear * 5.0);
 
-    if (harmonicPower <= 1e-12)
-        return -120.0;
+        m_syncThresholdSum = threshold * threshold * double(win);
+    }
 
-    return 10.0 * std::log10(harmonicPower / fundPower);
+    for (; m_syncScan + win < size; m_syncScan += hop) {
+        if (m_sumSq[m_syncScan + win] - m_sumSq[m_syncScan] > m_syncThresholdSum) {
+            onSyncFound(m_syncScan);
+            return;
+        }
+    }
 }
 
 //---------------------------------------------------------------------------------------
-AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &recordedWavPath,
-                                                                QString *error)
+void AudioHealthChecker::StreamAnalyzer::onSyncFound(int syncSample)
 {
-    Report report;
+    const int sr = m_sampleRate;
 
-    auto addIssue = [&](const QString &note, const QString &diagnose) {
-        report.notes << note;
-        report.diagnose << diagnose;
-    };
+    // Sync beep mulai 0.5 s setelah awal stimulus
+    m_syncSample = syncSample;
+    m_playbackOffset = syncSample - qRound(0.5 * sr);
+    m_endSample = 0;
+    m_tones.clear();
 
-    WavData wav;
+    // Trim awal dan akhir supaya fade-in/fade-out tidak ikut dianalisis.
+    const int trim = qRound(0.1 * sr);
 
-    if (!readPcm16Wav(recordedWavPath, wav, error)) {
-        report.ok = false;
-        report.verdict = "FAIL";
+    for (const ToneSpec &spec : toneSpecs()) {
+        const int segStart = m_playbackOffset + qRound(spec.startSec * sr) + trim;
+        const int segCount = qRound(spec.durationSec * sr) - 2 * trim;
 
-        addIssue(
-            "Recording WAV can't be read.",
-            "Check whether pw-record finished correctly, the file path is valid, the file permission is allowed, and the WAV format is PCM 16-bit."
-        );
+        ToneAccumulator tone;
+        tone.reset(&spec.frequencyHz, 1, sr, segStart, segCount);
+        m_tones.append(tone);
 
-        return report;
-    }
+        m_endSample = std::max(m_endSample, segStart + segCount);
 
-    if (wav.sampleRate != TEST_SAMPLE_RATE) {
-        addIssue(
-            QString("Recording sample rate is %1 Hz, expected %2 Hz.")
-                .arg(wav.sampleRate)
-                .arg(TEST_SAMPLE_RATE),
-            "Sample rate mismatch can affect tone detection, latency estimation, and frequency analysis. Use --rate 16000 in pw-record."
-        );
+        // Segment 1 kHz untuk THD kasar: fundamental + harmonik di bawah Nyquist
+        if (qRound(spec.frequencyHz) == 1000) {
+            double freqs[MAX_TONES];
+            int tones = 0;
+
+            freqs[tones++] = 1000.0;
+            for (double h : {2000.0, 3000.0, 4000.0, 5000.0, 6000.0}) {
+                if (h < sr / 2.0)
+                    freqs[tones++] = h;
+            }
+
+            m_thd.reset(freqs, tones, sr, segStart, segCount);
+        }
     }
 
-    const QVector<double> &x = wav.samples;
-    const int sr = wav.sampleRate;
+    // Kejar sampel yang sudah tertangkap sebelum sync terdeteksi
+    const float *x = m_samples.constData();
+    const int size = int(m_samples.size());
+
+    for (ToneAccumulator &tone : m_tones)
+        tone.feed(x, 0, size);
+    m_thd.feed(x, 0, size);
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioHealthChecker::StreamAnalyzer::isComplete() const
+{
+    return syncFound() && m_samples.size() >= m_endSample;
+}
 
-    if (x.isEmpty()) {
+//---------------------------------------------------------------------------------------
+void AudioHealthChecker::StreamAnalyzer::finish(Report &report) const
+{
+    if (m_samples.isEmpty()) {
         report.ok = false;
         report.verdict = "FAIL";
 
         addIssue(
-            "Recording WAV contains no audio samples.",
-            "The recorder may have stopped too early, the input device may be wrong, or pw-record failed to capture audio."
+            report,
+            "Recording contains no audio samples.",
+            "The recorder may have stopped too early, the input device may be wrong, or the capture stream failed."
         );
 
-        return report;
-    }
-
-    report.peakDbfs = peakDbfs(x);
-
-    int clipped = 0;
-    for (double v : x) {
-        if (std::abs(v) >= 0.98)
-            clipped++;
+        return;
     }
 
-    report.clippingPercent = 100.0 * double(clipped) / double(x.size());
+    const int sr = m_sampleRate;
+    const Signal s = view();
 
-    const int syncSample = findSyncStartSample(x, sr);
+    report.peakDbfs = dbfs(m_peak);
+    report.clippingPercent = 100.0 * double(m_clipped) / double(m_samples.size());
 
-    if (syncSample < 0) {
+    if (!syncFound()) {
         report.ok = false;
         report.verdict = "FAIL";
 
         addIssue(
+            report,
             "Sync beep was not detected in the recording.",
             "Possible causes: speaker volume is too low, speaker output device is wrong, microphone is muted, microphone target is wrong, or the microphone is too far from the speaker."
         );
 
-        return report;
+        return;
     }
 
-    const double syncStartRefSec = 0.5;
-    const int playbackOffsetSample = syncSample - qRound(syncStartRefSec * sr);
-    report.latencyMs = 1000.0 * double(playbackOffsetSample) / double(sr);
+    report.latencyMs = 1000.0 * double(m_playbackOffset) / double(sr);
 
-    const int noiseStart = std::max(0, playbackOffsetSample);
+    const int noiseStart = std::max(0, m_playbackOffset);
     const int noiseCount = qRound(0.35 * sr);
-    report.noiseFloorDbfs = rmsDbfs(x, noiseStart, noiseCount);
+    report.noiseFloorDbfs = rmsDbfs(s, noiseStart, noiseCount);
 
     double level1k = -120.0;
+    const QVector<ToneSpec> specs = toneSpecs();
 
-    for (const ToneSpec &spec : toneSpecs()) {
-        int segStart = playbackOffsetSample + qRound(spec.startSec * sr);
-        int segCount = qRound(spec.durationSec * sr);
-
-        // Trim awal dan akhir supaya fade-in/fade-out tidak ikut dianalisis.
-        const int trim = qRound(0.1 * sr);
-        segStart += trim;
-        segCount -= 2 * trim;
+    for (int i = 0; i < specs.size() && i < m_tones.size(); ++i) {
+        const ToneAccumulator &tone = m_tones[i];
 
         ToneResult tr;
-        tr.frequencyHz = spec.frequencyHz;
-        tr.levelDbfs = toneLevelDbfs(x, segStart, segCount, sr, spec.frequencyHz);
-        tr.dropoutPercent = dropoutPercent(x, segStart, segCount, sr);
+        tr.frequencyHz = specs[i].frequencyHz;
+        tone.levelsDbfs(&tr.levelDbfs);
+        tr.dropoutPercent = dropoutPercent(s, tone.start, tone.count);
 
-        if (qRound(spec.frequencyHz) == 1000)
+        if (qRound(tr.frequencyHz) == 1000)
             level1k = tr.levelDbfs;
 
         report.tones.append(tr);
@@ -624,21 +747,23 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
         tr.relativeTo1kDb = tr.levelDbfs - report.level1kDbfs;
     }
 
-    // Cari segment 1 kHz untuk THD kasar.
-    for (const ToneSpec &spec : toneSpecs()) {
-        if (qRound(spec.frequencyHz) == 1000) {
-            int segStart = playbackOffsetSample + qRound(spec.startSec * sr);
-            int segCount = qRound(spec.durationSec * sr);
+    double thdLevels[MAX_TONES];
+    m_thd.levelsDbfs(thdLevels);
+    report.thd1kDb = thdDb(thdLevels, m_thd.toneCount);
 
-            const int trim = qRound(0.1 * sr);
-            segStart += trim;
-            segCount -= 2 * trim;
+    judge(report);
+}
 
-            report.thd1kDb = thd1kDb(x, segStart, segCount, sr);
-            break;
-        }
-    }
+//---------------------------------------------------------------------------------------
+void AudioHealthChecker::addIssue(Report &report, const QString &note, const QString &diagnose)
+{
+    report.notes << note;
+    report.diagnose << diagnose;
+}
 
+//---------------------------------------------------------------------------------------
+void AudioHealthChecker::judge(Report &report)
+{
     bool fail = false;
     bool warn = false;
 
@@ -649,6 +774,7 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
         fail = true;
 
         addIssue(
+            report,
             QString("1 kHz tone level is too low: %1 dBFS.")
                 .arg(report.level1kDbfs, 0, 'f', 1),
             "Possible causes: speaker volume is too low, microphone gain is too low, microphone is not capturing audio properly, or the speaker-to-microphone distance is too far."
@@ -665,6 +791,7 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
         fail = true;
 
         addIssue(
+            report,
             QString("SNR is too low: %1 dB.")
                 .arg(report.snr1kDb, 0, 'f', 1),
             "Possible causes: room noise is too high, microphone noise floor is high, speaker signal is too weak, or the microphone gain is not properly adjusted."
@@ -681,6 +808,7 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
         fail = true;
 
         addIssue(
+            report,
             QString("High clipping detected: %1%.")
                 .arg(report.clippingPercent, 0, 'f', 2),
             "Possible causes: speaker volume is too high, microphone gain is too high, or automatic gain control is boosting the input too aggressively."
@@ -697,6 +825,7 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
         warn = true;
 
         addIssue(
+            report,
             QString("Noise floor is quite high: %1 dBFS.")
                 .arg(report.noiseFloorDbfs, 0, 'f', 1),
             "Possible causes: room is noisy, microphone gain is too high, fan noise is captured, electrical noise exists, or the microphone is too sensitive."
@@ -715,6 +844,7 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
                 warn = true;
 
                 addIssue(
+                    report,
                     QString("Tone %1 Hz differs too much from 1 kHz reference: %2 dB.")
                         .arg(tr.frequencyHz, 0, 'f', 0)
                         .arg(tr.relativeTo1kDb, 0, 'f', 1),
@@ -731,6 +861,7 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
             fail = true;
 
             addIssue(
+                report,
                 QString("High dropout detected at tone %1 Hz: %2%.")
                     .arg(tr.frequencyHz, 0, 'f', 0)
                     .arg(tr.dropoutPercent, 0, 'f', 1),
@@ -750,6 +881,7 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
         warn = true;
 
         addIssue(
+            report,
             QString("1 kHz distortion level may be high. THD ratio: %1 dB.")
                 .arg(report.thd1kDb, 0, 'f', 1),
             "Possible causes: speaker volume is too high, microphone input is overloaded, speaker is distorted, or the acoustic path is too close and causing nonlinear capture."
@@ -783,6 +915,43 @@ AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &r
 
         report.diagnose << "No critical audio issue detected. Playback, recording, level, SNR, clipping, and dropout are within acceptable limits.";
     }
+}
+
+//---------------------------------------------------------------------------------------
+AudioHealthChecker::Report AudioHealthChecker::analyzeRecording(const QString &recordedWavPath,
+                                                                QString *error)
+{
+    Report report;
+
+    WavData wav;
+
+    if (!readPcm16Wav(recordedWavPath, wav, error)) {
+        report.ok = false;
+        report.verdict = "FAIL";
+
+        addIssue(
+            report,
+            "Recording WAV can't be read.",
+            "Check whether pw-record finished correctly, the file path is valid, the file permission is allowed, and the WAV format is PCM 16-bit."
+        );
+
+        return report;
+    }
+
+    if (wav.sampleRate != TEST_SAMPLE_RATE) {
+        addIssue(
+            report,
+            QString("Recording sample rate is %1 Hz, expected %2 Hz.")
+                .arg(wav.sampleRate)
+                .arg(TEST_SAMPLE_RATE),
+            "Sample rate mismatch can affect tone detection, latency estimation, and frequency analysis. Use --rate 16000 in pw-record."
+        );
+    }
+
+    // Jalur yang sama dengan loopback streaming, satu blok
+    StreamAnalyzer analyzer(wav.sampleRate);
+    analyzer.feed(wav.samples.constData(), int(wav.samples.size()));
+    analyzer.finish(report);
 
     return report;
 }
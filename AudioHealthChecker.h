@@ -28,6 +28,10 @@ public:
         double latencyMs = 0.0;
         double thd1kDb = -120.0;
 
+        // Hanya diisi monitor pasif (MicHealthMonitor)
+        double rmsDbfs = -120.0;
+        double dropoutPercent = 0.0;
+
         QVector<ToneResult> tones;
         QStringList notes;
         QStringList diagnose;
@@ -48,11 +52,15 @@ public:
     void printAudioHealthReportCompact(const AudioHealthChecker::Report &report);
     QString formatReportCompact(const AudioHealthChecker::Report &report);
 
+    // Stimulus test di memory (mono, testSampleRate()); isinya sama dengan createTestWav()
+    static QVector<float> createTestSignal();
+    static int testSampleRate();
+
 private:
     struct WavData {
         int sampleRate = 0;
         int channels = 0;
-        QVector<double> samples;
+        QVector<float> samples;
     };
 
     struct ToneSpec {
@@ -61,7 +69,88 @@ private:
         double durationSec = 0.0;
     };
 
+    // View rekaman + prefix sum kuadrat: RMS window mana pun O(1)
+    struct Signal {
+        const float *x = nullptr;
+        int size = 0;
+        int sampleRate = 0;
+        const double *sumSq = nullptr;  // sumSq[i] = x[0]^2 + ... + x[i-1]^2
+    };
+
+    // Jumlah tone maksimum per pass Goertzel (lane tetap supaya loop ter-vectorize)
+    static constexpr int MAX_TONES = 8;
+
+    /*
+     * Goertzel ber-window Hann untuk beberapa tone sekaligus pada segmen
+     * [start, start + count). Sampel boleh datang per blok (feed berurutan);
+     * window dihitung lewat rotasi fasor, tanpa cos/sin per sampel.
+     */
+    struct ToneAccumulator {
+        void reset(const double *freqHz, int tones, int sampleRate, int segStart, int segCount);
+        void feed(const float *x, int firstIndex, int n);
+        bool isComplete() const { return done >= count; }
+        void levelsDbfs(double *levelDbfs) const;
+
+        int start = 0;
+        int count = 0;
+        int done = 0;
+        int toneCount = 0;
+
+        double coeff[MAX_TONES] = {};
+        double s1[MAX_TONES] = {};
+        double s2[MAX_TONES] = {};
+
+        double rotCos = 1.0;
+        double rotSin = 0.0;
+        double phCos = 1.0;
+        double phSin = 0.0;
+        double windowSum = 0.0;
+    };
+
+public:
+    /*
+     * Analisis inkremental: blok capture di-feed saat datang (prefix sum,
+     * deteksi sync, Goertzel per segmen tone), jadi hasil siap begitu
+     * segmen tone terakhir lewat. analyzeRecording() memakai jalur yang sama
+     * dengan satu blok.
+     */
+    class StreamAnalyzer
+    {
+    public:
+        explicit StreamAnalyzer(int sampleRate);
+
+        void feed(const float *samples, int count);
+        bool syncFound() const { return m_syncSample >= 0; }
+        bool isComplete() const;
+
+        // Isi pengukuran + verdict; notes/diagnose yang sudah ada di report dipertahankan
+        void finish(Report &report) const;
+
+    private:
+        void detectSync();
+        void onSyncFound(int syncSample);
+        Signal view() const;
+
+        int m_sampleRate = 0;
+        QVector<float> m_samples;
+        QVector<double> m_sumSq;
+
+        float m_peak = 0.0f;
+        qint64 m_clipped = 0;
+
+        double m_syncThresholdSum = -1.0;   // < 0: noise awal belum cukup
+        int m_syncScan = 0;
+        int m_syncSample = -1;
+        int m_playbackOffset = 0;
+        int m_endSample = 0;
+
+        QVector<ToneAccumulator> m_tones;   // satu per toneSpecs()
+        ToneAccumulator m_thd;              // 1 kHz + harmonik
+    };
+
+private:
     static QVector<ToneSpec> toneSpecs();
+    static QVector<double> buildTestSamples();
 
     static bool writePcm16MonoWav(const QString &path,
                                   const QVector<double> &samples,
@@ -72,23 +161,13 @@ private:
                              WavData &wav,
                              QString *error);
 
-    static double rmsDbfs(const QVector<double> &x, int start, int count);
-    static double peakDbfs(const QVector<double> &x);
-    static double toneLevelDbfs(const QVector<double> &x,
-                                int start,
-                                int count,
-                                int sampleRate,
-                                double freqHz);
-    static double dropoutPercent(const QVector<double> &x,
+    static double rmsDbfs(const Signal &s, int start, int count);
+    static double dropoutPercent(const Signal &s,
                                  int start,
-                                 int count,
-                                 int sampleRate);
-
-    static int findSyncStartSample(const QVector<double> &x, int sampleRate);
-    static double thd1kDb(const QVector<double> &x,
-                          int start,
-                          int count,
-                          int sampleRate);
+                                 int count);
+    static double thdDb(const double *levelDbfs, int toneCount);
+    static void judge(Report &report);
+    static void addIssue(Report &report, const QString &note, const QString &diagnose);
 
     static double dbfs(double linearRms);
 };
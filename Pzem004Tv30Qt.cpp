@@ -3,6 +3,8 @@
 #include <QIODevice>
 #include <QMetaType>
 
+#include "metrics.h"
+
 Pzem004Tv30Qt::Pzem004Tv30Qt(QObject *parent)
     : QObject(parent)
 {
@@ -132,7 +134,8 @@ void Pzem004Tv30Qt::onReadyRead()
 {
     QByteArray chunk = m_serial.readAll();
 
-    qDebug().noquote() << "PZEM RX chunk:" << chunk.toHex(' ').toUpper();
+    METRIC_COUNTER("pzem.rx_bytes").inc(quint64(chunk.size()));
+    qCDebug(lcHotPath).noquote() << "PZEM RX chunk:" << chunk.toHex(' ').toUpper();
 
     m_rxBuffer.append(chunk);
 
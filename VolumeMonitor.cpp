@@ -1,11 +1,6 @@
 #include "VolumeMonitor.h"
 #include <QMetaObject>
 
-struct SetVolumeData {
-    VolumeMonitor *self;
-    int percent;
-};
-
 VolumeMonitor::VolumeMonitor(QObject *parent)
     : QObject(parent)
 {
@@ -61,6 +56,8 @@ void VolumeMonitor::cleanup()
         m_context = nullptr;
     }
 
+    m_ready.store(false, std::memory_order_release);
+
     pa_threaded_mainloop_unlock(m_mainloop);
 
     pa_threaded_mainloop_stop(m_mainloop);
@@ -86,11 +83,14 @@ void VolumeMonitor::contextStateCallback(pa_context *c,
                                           subscribeCallback,
                                           self);
 
+        // SERVER: default sink bisa berganti (mis. HDMI <-> jack)
         pa_context_subscribe(c,
-                             PA_SUBSCRIPTION_MASK_SINK,
+                             pa_subscription_mask_t(PA_SUBSCRIPTION_MASK_SINK
+                                                    | PA_SUBSCRIPTION_MASK_SERVER),
                              nullptr,
                              nullptr);
 
+        self->m_ready.store(true, std::memory_order_release);
         self->requestSinkInfoInternal();
 
         QMetaObject::invokeMethod(self,
@@ -101,6 +101,9 @@ void VolumeMonitor::contextStateCallback(pa_context *c,
     case PA_CONTEXT_FAILED:
     case PA_CONTEXT_TERMINATED:
 
+        self->m_ready.store(false, std::memory_order_release);
+        self->m_sinkIndex = PA_INVALID_INDEX;
+
         QMetaObject::invokeMethod(self,
                                   &VolumeMonitor::disconnected,
                                   Qt::QueuedConnection);
@@ -119,8 +122,10 @@ void VolumeMonitor::subscribeCallback(pa_context *,
 {
     auto *self = static_cast<VolumeMonitor *>(userdata);
 
-    if ((type & PA_SUBSCRIPTION_EVENT_FACILITY_MASK)
-        == PA_SUBSCRIPTION_EVENT_SINK)
+    const auto facility = type & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+
+    if (facility == PA_SUBSCRIPTION_EVENT_SINK
+        || facility == PA_SUBSCRIPTION_EVENT_SERVER)
     {
         self->requestSinkInfoInternal();  // NO LOCK
     }
@@ -137,18 +142,40 @@ void VolumeMonitor::sinkInfoCallback(pa_context *,
 
     auto *self = static_cast<VolumeMonitor *>(userdata);
 
-    qDebug() << "Raw volume:"
-             << info->volume.values[0];
+    self->m_sinkIndex = info->index;
+    self->m_sinkChannels = info->volume.channels;
+
+    // Set yang datang sebelum sink dikenal
+    if (self->m_pendingPercent >= 0) {
+        const int pending = self->m_pendingPercent;
+        self->m_pendingPercent = -1;
+        self->applyVolumeInternal(pending);
+        return;
+    }
 
-    int percent =
-        (info->volume.values[0] * 100) / PA_VOLUME_NORM;
+    const int percent =
+        int((quint64(pa_cvolume_avg(&info->volume)) * 100 + PA_VOLUME_NORM / 2) / PA_VOLUME_NORM);
+    const bool muted = info->mute != 0;
+
+    // Callback subscribe datang untuk setiap perubahan sink (port, state, ...);
+    // hanya teruskan ke Qt kalau nilainya benar-benar berubah.
+    if (self->m_volumePercent.exchange(percent) != percent) {
+        QMetaObject::invokeMethod(
+            self,
+            [self, percent]() {
+                emit self->volumeChanged(percent);
+            },
+            Qt::QueuedConnection);
+    }
 
-    QMetaObject::invokeMethod(
-        self,
-        [self, percent]() {
-            emit self->volumeChanged(percent);
-        },
-        Qt::QueuedConnection);
+    if (self->m_muted.exchange(muted) != muted) {
+        QMetaObject::invokeMethod(
+            self,
+            [self, muted]() {
+                emit self->muteChanged(muted);
+            },
+            Qt::QueuedConnection);
+    }
 }
 
 ////////////////////////////////////////////////////////////
@@ -171,13 +198,13 @@ void VolumeMonitor::requestSinkInfoInternal()
 //------------------------------------------------------------------------
 void VolumeMonitor::refresh()
 {
-    if (!m_context ||
-        pa_context_get_state(m_context) != PA_CONTEXT_READY)
+    if (!m_mainloop)
         return;
 
     pa_threaded_mainloop_lock(m_mainloop);
 
-    requestSinkInfoInternal();
+    if (m_context && pa_context_get_state(m_context) == PA_CONTEXT_READY)
+        requestSinkInfoInternal();
 
     pa_threaded_mainloop_unlock(m_mainloop);
 }
@@ -186,60 +213,84 @@ void VolumeMonitor::refresh()
 ///////////////////// SET VOLUME ///////////////////////////
 ////////////////////////////////////////////////////////////
 //------------------------------------------------------------------------
-void VolumeMonitor::setVolumePercent(int percent)
+void VolumeMonitor::applyVolumeInternal(int percent)
 {
-    if (!m_context)
-        return;
+    pa_cvolume volume;
+
+    // WAJIB init dulu
+    pa_cvolume_init(&volume);
+
+    // convert percent → raw PulseAudio, set semua channel
+    pa_cvolume_set(&volume,
+                   m_sinkChannels,
+                   pa_volume_t((quint64(percent) * PA_VOLUME_NORM) / 100));
+
+    pa_operation *op =
+        pa_context_set_sink_volume_by_index(
+            m_context,
+            m_sinkIndex,
+            &volume,
+            nullptr,
+            nullptr);
+
+    if (op)
+        pa_operation_unref(op);
+}
+
+//------------------------------------------------------------------------
+bool VolumeMonitor::setVolumePercent(int percent)
+{
+    if (!m_mainloop)
+        return false;
 
     if (percent < 0) percent = 0;
     if (percent > 100) percent = 100;
 
-    SetVolumeData *data = new SetVolumeData;
-    data->self = this;
-    data->percent = percent;
-
     pa_threaded_mainloop_lock(m_mainloop);
 
-    pa_operation *op = pa_context_get_sink_info_by_name(
-        m_context,
-        "@DEFAULT_SINK@",
-        [](pa_context *, const pa_sink_info *info, int eol, void *userdata)
-        {
-            if (eol || !info)
-                return;
+    const bool ready = m_context && pa_context_get_state(m_context) == PA_CONTEXT_READY;
 
-            SetVolumeData *data = static_cast<SetVolumeData*>(userdata);
+    if (ready && m_sinkIndex != PA_INVALID_INDEX && m_sinkChannels > 0) {
+        // Satu operasi async; nilai baru kembali lewat callback subscribe
+        applyVolumeInternal(percent);
+    } else if (ready) {
+        m_pendingPercent = percent;
+        requestSinkInfoInternal();
+    }
 
-            pa_cvolume volume;
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    if (!ready) {
+        qWarning() << "VolumeMonitor: PulseAudio belum siap, set volume diabaikan" << percent;
+        return false;
+    }
 
-            // WAJIB init dulu
-            pa_cvolume_init(&volume);
+    return true;
+}
 
-            // convert percent → raw PulseAudio
-            pa_volume_t raw =
-                (data->percent * PA_VOLUME_NORM) / 100;
+//------------------------------------------------------------------------
+bool VolumeMonitor::setMuted(bool muted)
+{
+    if (!m_mainloop)
+        return false;
 
-            // set semua channel
-            pa_cvolume_set(&volume,
-                           info->volume.channels,
-                           raw);
+    bool ok = false;
 
-            pa_operation *setOp =
-                pa_context_set_sink_volume_by_index(
-                    data->self->m_context,
-                    info->index,
-                    &volume,
-                    nullptr,
-                    nullptr);
+    pa_threaded_mainloop_lock(m_mainloop);
 
-            if (setOp)
-                pa_operation_unref(setOp);
-        },
-        data);
+    if (m_context && pa_context_get_state(m_context) == PA_CONTEXT_READY) {
+        pa_operation *op =
+            m_sinkIndex != PA_INVALID_INDEX
+                ? pa_context_set_sink_mute_by_index(m_context, m_sinkIndex, muted, nullptr, nullptr)
+                : pa_context_set_sink_mute_by_name(m_context, "@DEFAULT_SINK@", muted, nullptr, nullptr);
 
-    if (op)
-        pa_operation_unref(op);
+        if (op) {
+            pa_operation_unref(op);
+            ok = true;
+        }
+    }
 
     pa_threaded_mainloop_unlock(m_mainloop);
-}
 
+    return ok;
+}
@@ -9,9 +9,20 @@
     #include <pulse/pulseaudio.h>
 #endif
 
+#include <atomic>
+
 #include <qdebug.h>
 
 
+/*
+ * Volume default sink lewat satu koneksi libpulse (pa_threaded_mainloop).
+ *
+ * Nilai volume/mute di-cache dari callback subscribe, jadi volumePercent()
+ * dan isMuted() tidak menyentuh PulseAudio sama sekali. Set volume/mute
+ * hanya mengantre satu operasi async ke sink yang sudah dikenal (index +
+ * jumlah channel dari sink info terakhir); tidak ada fork/exec pactl dan
+ * tidak menunggu balasan server.
+ */
 class VolumeMonitor : public QObject
 {
     Q_OBJECT
@@ -21,10 +32,17 @@ public:
     ~VolumeMonitor();
 
     void refresh();                 // manual refresh
-    void setVolumePercent(int percent);
+    bool setVolumePercent(int percent);
+    bool setMuted(bool muted);
+
+    // Cache dari callback, -1 kalau sink belum dikenal
+    int volumePercent() const { return m_volumePercent.load(std::memory_order_relaxed); }
+    bool isMuted() const { return m_muted.load(std::memory_order_relaxed); }
+    bool isReady() const { return m_ready.load(std::memory_order_acquire); }
 
 signals:
     void volumeChanged(int percent);
+    void muteChanged(bool muted);
     void connected();
     void disconnected();
 
@@ -34,6 +52,7 @@ private:
 
     // internal (NO LOCK) – hanya dipanggil dari worker thread
     void requestSinkInfoInternal();
+    void applyVolumeInternal(int percent);
 #ifdef PLATFORM_LINUX
     // libpulse callbacks
     static void contextStateCallback(pa_context *c, void *userdata);
@@ -48,7 +67,16 @@ private:
 
     pa_threaded_mainloop *m_mainloop = nullptr;
     pa_context *m_context = nullptr;
+
+    // Default sink terakhir (diakses dengan lock mainloop / dari thread pulse)
+    uint32_t m_sinkIndex = PA_INVALID_INDEX;
+    uint8_t m_sinkChannels = 0;
+    int m_pendingPercent = -1;      // set sebelum sink dikenal
 #endif
+
+    std::atomic<int> m_volumePercent{-1};
+    std::atomic<bool> m_muted{false};
+    std::atomic<bool> m_ready{false};
 };
 
 #endif // VOLUMEMONITOR_H
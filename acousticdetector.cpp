@@ -0,0 +1,273 @@
+#include "acousticdetector.h"
+
+#include "metrics.h"
+#include "pcmutils.h"
+#include "traceevent.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+std::atomic<qint64> AcousticEventDetector::s_lastEventNs[AcousticEventDetector::KindCount] = {};
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+constexpr int SHOUT_MIN_FRAMES = AcousticEventDetector::SHOUT_MIN_MS * AcousticEventDetector::SAMPLE_RATE
+                                 / 1000 / AcousticEventDetector::HOP_SIZE;
+constexpr int REFRACTORY_FRAMES = AcousticEventDetector::REFRACTORY_MS * AcousticEventDetector::SAMPLE_RATE
+                                  / 1000 / AcousticEventDetector::HOP_SIZE;
+constexpr float BG_DOWN_ALPHA = 0.1f;       // background cepat turun,
+constexpr float BG_UP_ALPHA = 0.005f;       // lambat naik (~3 s): event keras tidak menaikkan floor
+}
+
+//---------------------------------------------------------------------------------------
+AcousticEventDetector::AcousticEventDetector(QObject *parent)
+    : QObject(parent)
+{
+    double power = 0.0;
+
+    for (int i = 0; i < FRAME_SIZE; ++i) {
+        m_window[i] = float(0.5 - 0.5 * std::cos(2.0 * PI * i / FRAME_SIZE));
+        power += double(m_window[i]) * m_window[i];
+    }
+
+    m_windowPower = float(power);
+
+    for (int k = 0; k < FRAME_SIZE / 2; ++k) {
+        m_cos[k] = float(std::cos(2.0 * PI * k / FRAME_SIZE));
+        m_sin[k] = float(-std::sin(2.0 * PI * k / FRAME_SIZE));
+    }
+
+    int bits = 0;
+    while ((1 << bits) < FRAME_SIZE)
+        ++bits;
+
+    for (int i = 0; i < FRAME_SIZE; ++i) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b)
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        m_bitrev[i] = quint16(r);
+    }
+
+    m_bandEnd[BandLow] = LOW_MAX_HZ * FRAME_SIZE / SAMPLE_RATE + 1;
+    m_bandEnd[BandVoice] = VOICE_MAX_HZ * FRAME_SIZE / SAMPLE_RATE + 1;
+    m_bandEnd[BandHigh] = BINS;
+
+    for (qint64 &f : m_lastFrame)
+        f = -REFRACTORY_FRAMES;
+}
+
+//---------------------------------------------------------------------------------------
+QString AcousticEventDetector::kindName(Kind kind)
+{
+    switch (kind) {
+    case Impact: return QStringLiteral("impact");
+    case Shout:  return QStringLiteral("shout");
+    default:     break;
+    }
+
+    return QStringLiteral("unknown");
+}
+
+//---------------------------------------------------------------------------------------
+qint64 AcousticEventDetector::lastEventNs(Kind kind)
+{
+    return s_lastEventNs[kind].load(std::memory_order_acquire);
+}
+
+//---------------------------------------------------------------------------------------
+bool AcousticEventDetector::eventSince(qint64 sinceNs, int kind)
+{
+    for (int k = 0; k < KindCount; ++k) {
+        if (kind >= 0 && kind != k)
+            continue;
+
+        const qint64 ts = s_lastEventNs[k].load(std::memory_order_acquire);
+        if (ts > 0 && ts >= sinceNs)
+            return true;
+    }
+
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+void AcousticEventDetector::discontinuity()
+{
+    // Frame yang menyeberangi hole bukan sinyal asli: kumpulkan ulang dari nol
+    m_filled = 0;
+    m_sinceHop = 0;
+    m_havePrev = false;
+    m_shoutFrames = 0;
+}
+
+//---------------------------------------------------------------------------------------
+void AcousticEventDetector::feed(const float *x, int n)
+{
+    while (n > 0) {
+        const int take = std::min({n, HOP_SIZE - m_sinceHop, FRAME_SIZE - m_ringPos});
+
+        std::copy(x, x + take, m_ring + m_ringPos);
+
+        m_ringPos = (m_ringPos + take) % FRAME_SIZE;
+        m_filled = std::min(m_filled + take, FRAME_SIZE);
+        m_sinceHop += take;
+        x += take;
+        n -= take;
+
+        if (m_sinceHop == HOP_SIZE) {
+            m_sinceHop = 0;
+
+            if (m_filled == FRAME_SIZE)
+                processFrame();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AcousticEventDetector::fft(float *re, float *im) const
+{
+    for (int i = 0; i < FRAME_SIZE; ++i) {
+        const int j = m_bitrev[i];
+        if (j > i) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    for (int len = 2, step = FRAME_SIZE / 2; len <= FRAME_SIZE; len <<= 1, step >>= 1) {
+        const int half = len / 2;
+
+        for (int start = 0; start < FRAME_SIZE; start += len) {
+            float *ar = re + start;
+            float *ai = im + start;
+            float *br = ar + half;
+            float *bi = ai + half;
+
+            for (int k = 0; k < half; ++k) {
+                const float wr = m_cos[k * step];
+                const float wi = m_sin[k * step];
+                const float tr = br[k] * wr - bi[k] * wi;
+                const float ti = br[k] * wi + bi[k] * wr;
+
+                br[k] = ar[k] - tr;
+                bi[k] = ai[k] - ti;
+                ar[k] += tr;
+                ai[k] += ti;
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AcousticEventDetector::processFrame()
+{
+    // Ring -> frame linear (sampel tertua di m_ringPos)
+    const int head = FRAME_SIZE - m_ringPos;
+    std::copy(m_ring + m_ringPos, m_ring + FRAME_SIZE, m_re);
+    std::copy(m_ring, m_ring + m_ringPos, m_re + head);
+
+    // Offset DC mic dibuang sebelum window: Hann membocorkan DC ke bin 1 (band low)
+    pcm::removeDc(m_re, FRAME_SIZE, float(pcm::levels(m_re, FRAME_SIZE).sum / FRAME_SIZE));
+    pcm::multiply(m_re, m_window, m_re, FRAME_SIZE);
+
+    const float sumSq = float(pcm::levels(m_re, FRAME_SIZE).sumSq);
+    std::fill(m_im, m_im + FRAME_SIZE, 0.0f);
+
+    fft(m_re, m_im);
+
+    Features f;
+    f.energyDb = 10.0f * std::log10(std::max(sumSq / m_windowPower, 1e-12f));
+
+    float band[BandCount] = {};
+    float total = 0.0f;
+    float flux = 0.0f;
+
+    for (int k = 0; k < BINS; ++k)
+        m_mag[k] = std::sqrt(m_re[k] * m_re[k] + m_im[k] * m_im[k]);
+
+    // DC (bin 0) tidak dihitung: offset mic bukan energi akustik
+    int begin = 1;
+    for (int b = 0; b < BandCount; ++b) {
+        float e = 0.0f;
+        for (int k = begin; k < m_bandEnd[b]; ++k)
+            e += m_mag[k] * m_mag[k];
+        band[b] = e;
+        begin = m_bandEnd[b];
+    }
+
+    for (int k = 1; k < BINS; ++k) {
+        total += m_mag[k];
+        flux += std::max(m_mag[k] - m_prevMag[k], 0.0f);
+    }
+
+    const float bandTotal = band[BandLow] + band[BandVoice] + band[BandHigh];
+    for (int b = 0; b < BandCount; ++b)
+        f.share[b] = bandTotal > 0.0f ? band[b] / bandTotal : 0.0f;
+
+    f.flux = (m_havePrev && total > 0.0f) ? flux / total : 0.0f;
+
+    std::copy(m_mag, m_mag + BINS, m_prevMag);
+    m_havePrev = true;
+
+    detect(f);
+    m_frameIndex++;
+}
+
+//---------------------------------------------------------------------------------------
+void AcousticEventDetector::detect(const Features &f)
+{
+    if (!m_haveBackground) {
+        m_backgroundDb = f.energyDb;
+        m_haveBackground = true;
+        return;
+    }
+
+    const float rise = f.energyDb - m_backgroundDb;
+
+    // Impact: satu frame cukup, onset mendadak dengan komponen low
+    if (f.energyDb > IMPACT_MIN_DBFS &&
+        rise > IMPACT_RISE_DB &&
+        f.flux > IMPACT_FLUX &&
+        f.share[BandLow] >= IMPACT_LOW_SHARE &&
+        m_frameIndex - m_lastFrame[Impact] >= REFRACTORY_FRAMES) {
+        m_lastFrame[Impact] = m_frameIndex;
+        publish(Impact, f.energyDb);
+    }
+
+    // Shout: band voice dominan dan keras, toleran jeda pendek antar suku kata
+    const bool voiced = f.energyDb > SHOUT_MIN_DBFS &&
+                        rise > SHOUT_RISE_DB &&
+                        f.share[BandVoice] >= SHOUT_VOICE_SHARE;
+
+    m_shoutFrames = voiced ? m_shoutFrames + 1 : std::max(0, m_shoutFrames - 2);
+
+    if (m_shoutFrames >= SHOUT_MIN_FRAMES &&
+        m_frameIndex - m_lastFrame[Shout] >= REFRACTORY_FRAMES) {
+        m_lastFrame[Shout] = m_frameIndex;
+        m_shoutFrames = 0;
+        publish(Shout, f.energyDb);
+    }
+
+    const float alpha = f.energyDb < m_backgroundDb ? BG_DOWN_ALPHA : BG_UP_ALPHA;
+    m_backgroundDb += (f.energyDb - m_backgroundDb) * alpha;
+}
+
+//---------------------------------------------------------------------------------------
+void AcousticEventDetector::publish(Kind kind, float levelDb)
+{
+    // Timestamp = saat blok capture diproses (terlambat maksimal satu blok
+    // capture); window fusi di decisionFall jauh lebih lebar dari itu.
+    s_lastEventNs[kind].store(trace::nowNs(), std::memory_order_release);
+    trace::instant(kind == Impact ? "acoustic.impact" : "acoustic.shout", qRound(levelDb));
+
+    if (kind == Impact)
+        METRIC_COUNTER("acoustic.impacts").inc();
+    else
+        METRIC_COUNTER("acoustic.shouts").inc();
+
+    const double level = levelDb;
+    QMetaObject::invokeMethod(this, [this, kind, level]() {
+        emit eventDetected(kind, level);
+    }, Qt::QueuedConnection);
+}
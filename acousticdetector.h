@@ -0,0 +1,117 @@
+#ifndef ACOUSTICDETECTOR_H
+#define ACOUSTICDETECTOR_H
+
+#include <QObject>
+#include <QtGlobal>
+
+#include <atomic>
+
+/*
+ * Deteksi event akustik (benturan / teriakan) untuk fusi dengan fall radar.
+ *
+ * PCM float mono 16 kHz masuk ring FRAME_SIZE sampel (di-feed dari thread
+ * capture, lihat MicHealthMonitor::setAcousticDetector). Setiap HOP_SIZE
+ * sampel satu frame Hann dianalisis: energi frame, spektrum FFT radix-2,
+ * energi band (low / voice / high) dan spectral flux. Semua loop per
+ * sampel / per bin ditulis SoA tanpa cabang supaya di-vectorize compiler.
+ *
+ *  - Impact: onset broadband mendadak (energi jauh di atas background,
+ *    flux tinggi, porsi band low cukup besar), mis. badan / benda jatuh.
+ *  - Shout : energi band voice tinggi dan bertahan SHOUT_MIN_MS.
+ *
+ * Timestamp event terakhir (trace::nowNs) disimpan di atomic statis, jadi
+ * thread radar (PayloadProcessor::decisionFall) cukup memanggil eventSince()
+ * tanpa pointer, lock maupun signal antar thread.
+ */
+class AcousticEventDetector : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        Impact = 0,
+        Shout,
+        KindCount
+    };
+    Q_ENUM(Kind)
+
+    explicit AcousticEventDetector(QObject *parent = nullptr);
+
+    // Thread capture saja
+    void feed(const float *x, int n);
+    void discontinuity();               // sampel hilang: mulai frame baru
+
+    // Thread-safe. true kalau ada event (kind < 0 = jenis apa saja) dengan
+    // timestamp >= sinceNs.
+    static bool eventSince(qint64 sinceNs, int kind = -1);
+    static qint64 lastEventNs(Kind kind);
+    static QString kindName(Kind kind);
+
+    static constexpr int SAMPLE_RATE = 16000;
+    static constexpr int FRAME_SIZE = 512;          // 32 ms
+    static constexpr int HOP_SIZE = 256;            // 16 ms
+    static constexpr int BINS = FRAME_SIZE / 2 + 1;
+
+    static constexpr int LOW_MAX_HZ = 300;
+    static constexpr int VOICE_MAX_HZ = 3000;
+
+    static constexpr float IMPACT_MIN_DBFS = -35.0f;
+    static constexpr float IMPACT_RISE_DB = 20.0f;  // di atas background
+    static constexpr float IMPACT_FLUX = 0.45f;
+    static constexpr float IMPACT_LOW_SHARE = 0.25f;
+
+    static constexpr float SHOUT_MIN_DBFS = -30.0f;
+    static constexpr float SHOUT_RISE_DB = 15.0f;
+    static constexpr float SHOUT_VOICE_SHARE = 0.6f;
+    static constexpr int SHOUT_MIN_MS = 300;
+
+    static constexpr int REFRACTORY_MS = 1000;
+
+signals:
+    // Di-emit di thread milik object ini
+    void eventDetected(AcousticEventDetector::Kind kind, double levelDbfs);
+
+private:
+    enum Band { BandLow = 0, BandVoice, BandHigh, BandCount };
+
+    struct Features {
+        float energyDb = -120.0f;
+        float flux = 0.0f;                  // 0..1, dinormalisasi total magnitudo
+        float share[BandCount] = {};        // porsi energi per band
+    };
+
+    void processFrame();
+    void fft(float *re, float *im) const;
+    void detect(const Features &f);
+    void publish(Kind kind, float levelDb);
+
+    // Tabel (dibuat sekali di constructor)
+    float m_window[FRAME_SIZE];
+    float m_windowPower = 1.0f;
+    float m_cos[FRAME_SIZE / 2];
+    float m_sin[FRAME_SIZE / 2];
+    quint16 m_bitrev[FRAME_SIZE];
+    int m_bandEnd[BandCount];               // bin eksklusif
+
+    // Thread capture saja
+    float m_ring[FRAME_SIZE] = {};
+    int m_ringPos = 0;
+    int m_filled = 0;
+    int m_sinceHop = 0;
+
+    float m_re[FRAME_SIZE];
+    float m_im[FRAME_SIZE];
+    float m_mag[BINS] = {};
+    float m_prevMag[BINS] = {};
+    bool m_havePrev = false;
+
+    float m_backgroundDb = -120.0f;
+    bool m_haveBackground = false;
+    int m_shoutFrames = 0;
+    qint64 m_frameIndex = 0;
+    qint64 m_lastFrame[KindCount];
+
+    static std::atomic<qint64> s_lastEventNs[KindCount];
+};
+
+#endif // ACOUSTICDETECTOR_H
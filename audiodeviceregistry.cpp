@@ -0,0 +1,508 @@
+#include "audiodeviceregistry.h"
+
+#include <QDebug>
+#include <QTimer>
+#include <QVector>
+
+#include <algorithm>
+
+//---------------------------------------------------------------------------------------
+AudioDeviceRegistry::AudioDeviceRegistry(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<AudioDeviceRegistry::Device>("AudioDeviceRegistry::Device");
+}
+
+//---------------------------------------------------------------------------------------
+AudioDeviceRegistry::~AudioDeviceRegistry()
+{
+    stop();
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::stop()
+{
+    m_reconnect = false;
+    m_running = false;
+    teardown();
+    m_ready = false;
+}
+
+//---------------------------------------------------------------------------------------
+QString AudioDeviceRegistry::resolveSource(const QString &name) const
+{
+    if (name.isEmpty() || name == QLatin1String(DEFAULT_SOURCE))
+        return m_defaultSource;
+
+    return name;
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioDeviceRegistry::findSource(const QString &name, Device *out) const
+{
+    const QString target = resolveSource(name);
+    if (target.isEmpty())
+        return false;
+
+    for (const Device &d : m_sources) {
+        if (d.name == target) {
+            if (out)
+                *out = d;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+QString AudioDeviceRegistry::preferredSink() const
+{
+    // Target speaker wajib KT USB
+    for (const Device &d : m_sinks) {
+        if (d.description.contains("kt usb", Qt::CaseInsensitive)
+            || (d.description.contains("kt", Qt::CaseInsensitive) && d.description.contains("usb", Qt::CaseInsensitive))
+            || d.name.contains("kt_usb", Qt::CaseInsensitive))
+            return d.name;
+    }
+
+    return {};
+}
+
+//---------------------------------------------------------------------------------------
+QString AudioDeviceRegistry::preferredSource() const
+{
+    QString firstNonMonitor;
+    bool defaultUsable = false;
+
+    for (const Device &d : m_sources) {
+        if (d.monitor)
+            continue;
+
+        // Prioritas utama: ReSpeaker / SEEED
+        if (d.description.contains("respeaker", Qt::CaseInsensitive)
+            || d.description.contains("seeed", Qt::CaseInsensitive)
+            || d.description.contains("4 mic", Qt::CaseInsensitive)
+            || d.description.contains("mic array", Qt::CaseInsensitive))
+            return d.name;
+
+        if (d.name == m_defaultSource)
+            defaultUsable = true;
+
+        if (firstNonMonitor.isEmpty() || d.name < firstNonMonitor)
+            firstNonMonitor = d.name;
+    }
+
+    return defaultUsable ? m_defaultSource : firstNonMonitor;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::updateDevice(const Device &device)
+{
+    QHash<quint32, Device> &map = device.source ? m_sources : m_sinks;
+    const auto it = map.constFind(device.index);
+
+    const bool added = it == map.constEnd() || it->name != device.name;
+    const bool stateChanged = added || it->muted != device.muted || !qFuzzyCompare(it->volume + 1.0, device.volume + 1.0);
+
+    map.insert(device.index, device);
+
+    if (added)
+        emit devicesChanged();
+
+    if (device.source && stateChanged)
+        emit sourceChanged(device);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::removeDevice(bool source, quint32 index)
+{
+    QHash<quint32, Device> &map = source ? m_sources : m_sinks;
+
+    if (map.remove(index) > 0)
+        emit devicesChanged();
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::setDefaults(const QString &sink, const QString &source)
+{
+    const bool sourceChangedDefault = source != m_defaultSource;
+
+    if (sink == m_defaultSink && !sourceChangedDefault)
+        return;
+
+    m_defaultSink = sink;
+    m_defaultSource = source;
+    emit devicesChanged();
+
+    Device d;
+    if (sourceChangedDefault && findSource(source, &d))
+        emit sourceChanged(d);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::markReady()
+{
+    if (m_ready)
+        return;
+
+    m_ready = true;
+    qDebug() << "AudioDeviceRegistry ready:" << m_sinks.size() << "sink," << m_sources.size() << "source,"
+             << "default source" << m_defaultSource;
+    emit ready();
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::connectionLost()
+{
+    if (!m_running)
+        return;
+
+    qWarning() << "AudioDeviceRegistry: koneksi PulseAudio putus, buka ulang dalam" << RECONNECT_MS << "ms";
+
+    teardown();
+    m_running = false;
+    m_ready = false;
+    m_sinks.clear();
+    m_sources.clear();
+    m_defaultSink.clear();
+    m_defaultSource.clear();
+    emit devicesChanged();
+
+    m_reconnect = true;
+    QTimer::singleShot(RECONNECT_MS, this, [this]() {
+        if (m_reconnect && !m_running) {
+            m_reconnect = false;
+            start();
+        }
+    });
+}
+
+#ifdef PLATFORM_LINUX
+
+//---------------------------------------------------------------------------------------
+static AudioDeviceRegistry::Device deviceFromSink(const pa_sink_info *info)
+{
+    AudioDeviceRegistry::Device d;
+    d.index = info->index;
+    d.name = QString::fromUtf8(info->name);
+    d.description = QString::fromUtf8(info->description);
+    d.source = false;
+    d.muted = info->mute != 0;
+    d.volume = double(pa_cvolume_avg(&info->volume)) / double(PA_VOLUME_NORM);
+    d.channels = info->volume.channels;
+    return d;
+}
+
+//---------------------------------------------------------------------------------------
+static AudioDeviceRegistry::Device deviceFromSource(const pa_source_info *info)
+{
+    AudioDeviceRegistry::Device d;
+    d.index = info->index;
+    d.name = QString::fromUtf8(info->name);
+    d.description = QString::fromUtf8(info->description);
+    d.source = true;
+    d.monitor = info->monitor_of_sink != PA_INVALID_INDEX;
+    d.muted = info->mute != 0;
+    d.volume = double(pa_cvolume_avg(&info->volume)) / double(PA_VOLUME_NORM);
+    d.channels = info->volume.channels;
+    return d;
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioDeviceRegistry::start()
+{
+    if (m_running)
+        return true;
+
+    m_mainloop = pa_threaded_mainloop_new();
+    m_context = pa_context_new(pa_threaded_mainloop_get_api(m_mainloop), "radarScanDevices");
+    m_initialDone = false;
+    pa_context_set_state_callback(m_context, contextStateCallback, this);
+    pa_context_set_subscribe_callback(m_context, subscribeCallback, this);
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    if (pa_threaded_mainloop_start(m_mainloop) < 0
+        || pa_context_connect(m_context, nullptr, PA_CONTEXT_NOFAIL, nullptr) < 0) {
+        pa_threaded_mainloop_unlock(m_mainloop);
+        qWarning() << "AudioDeviceRegistry: gagal konek PulseAudio";
+        teardown();
+        return false;
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    m_running = true;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::teardown()
+{
+    if (!m_mainloop)
+        return;
+
+    QVector<quint64> pending;
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    if (m_context) {
+        pa_context_set_state_callback(m_context, nullptr, nullptr);
+        pa_context_set_subscribe_callback(m_context, nullptr, nullptr);
+        pa_context_disconnect(m_context);
+        pa_context_unref(m_context);
+        m_context = nullptr;
+    }
+
+    // Operasi yang belum dijawab tidak akan pernah dijawab lagi
+    for (const auto &op : m_operations)
+        pending.append(op->id);
+    m_operations.clear();
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    pa_threaded_mainloop_stop(m_mainloop);
+    pa_threaded_mainloop_free(m_mainloop);
+    m_mainloop = nullptr;
+
+    for (quint64 id : pending)
+        emit operationFinished(id, false, QStringLiteral("Koneksi PulseAudio ditutup"));
+}
+
+//---------------------------------------------------------------------------------------
+AudioDeviceRegistry::Operation *AudioDeviceRegistry::newOperationLocked()
+{
+    auto op = std::make_unique<Operation>();
+    op->self = this;
+    op->id = m_nextOperation++;
+
+    Operation *raw = op.get();
+    m_operations.push_back(std::move(op));
+    return raw;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::releaseOperationLocked(Operation *op)
+{
+    m_operations.erase(std::remove_if(m_operations.begin(), m_operations.end(),
+                                      [op](const std::unique_ptr<Operation> &o) { return o.get() == op; }),
+                       m_operations.end());
+}
+
+//---------------------------------------------------------------------------------------
+quint64 AudioDeviceRegistry::setSourceMute(const QString &name, bool muted)
+{
+    if (!m_ready || !m_mainloop)
+        return 0;
+
+    const QByteArray target = (name.isEmpty() ? QString::fromLatin1(DEFAULT_SOURCE) : name).toUtf8();
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    Operation *op = newOperationLocked();
+    const quint64 id = op->id;
+
+    pa_operation *o = pa_context_set_source_mute_by_name(m_context, target.constData(), muted ? 1 : 0,
+                                                         operationCallback, op);
+    if (o) {
+        pa_operation_unref(o);
+    } else {
+        releaseOperationLocked(op);
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    return o ? id : 0;
+}
+
+//---------------------------------------------------------------------------------------
+quint64 AudioDeviceRegistry::setSourceVolume(const QString &name, double volume)
+{
+    // Jumlah channel cvolume harus sama dengan device: ambil dari registry
+    Device d;
+    if (!m_ready || !m_mainloop || !findSource(name, &d) || d.channels <= 0)
+        return 0;
+
+    pa_cvolume cv;
+    pa_cvolume_set(&cv, unsigned(d.channels), pa_volume_t(qBound(0.0, volume, 1.5) * PA_VOLUME_NORM));
+
+    const QByteArray target = d.name.toUtf8();
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    Operation *op = newOperationLocked();
+    const quint64 id = op->id;
+
+    pa_operation *o = pa_context_set_source_volume_by_name(m_context, target.constData(), &cv,
+                                                           operationCallback, op);
+    if (o) {
+        pa_operation_unref(o);
+    } else {
+        releaseOperationLocked(op);
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    return o ? id : 0;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::operationCallback(pa_context *c, int success, void *userdata)
+{
+    auto *op = static_cast<Operation *>(userdata);
+    AudioDeviceRegistry *self = op->self;
+    const quint64 id = op->id;
+    const QString error = success ? QString() : QString::fromUtf8(pa_strerror(pa_context_errno(c)));
+
+    self->releaseOperationLocked(op);
+
+    QMetaObject::invokeMethod(self, [self, id, success, error]() {
+        emit self->operationFinished(id, success != 0, error);
+    }, Qt::QueuedConnection);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::contextStateCallback(pa_context *c, void *userdata)
+{
+    auto *self = static_cast<AudioDeviceRegistry *>(userdata);
+
+    switch (pa_context_get_state(c)) {
+    case PA_CONTEXT_READY: {
+        // Subscribe dulu supaya perubahan selama daftar awal dibaca tidak hilang
+        pa_operation *op = pa_context_subscribe(
+            c, pa_subscription_mask_t(PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SOURCE | PA_SUBSCRIPTION_MASK_SERVER),
+            nullptr, nullptr);
+        if (op)
+            pa_operation_unref(op);
+
+        // Dijawab berurutan: server -> sink -> source (eol source = registry siap)
+        if ((op = pa_context_get_server_info(c, serverInfoCallback, self)))
+            pa_operation_unref(op);
+        if ((op = pa_context_get_sink_info_list(c, sinkInfoCallback, self)))
+            pa_operation_unref(op);
+        if ((op = pa_context_get_source_info_list(c, sourceInfoCallback, self)))
+            pa_operation_unref(op);
+        break;
+    }
+
+    case PA_CONTEXT_FAILED:
+    case PA_CONTEXT_TERMINATED:
+        QMetaObject::invokeMethod(self, [self]() { self->connectionLost(); }, Qt::QueuedConnection);
+        break;
+
+    default:
+        break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::subscribeCallback(pa_context *c, pa_subscription_event_type_t t, quint32 index, void *userdata)
+{
+    auto *self = static_cast<AudioDeviceRegistry *>(userdata);
+    const int facility = t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+    const bool removed = (t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE;
+    pa_operation *op = nullptr;
+
+    switch (facility) {
+    case PA_SUBSCRIPTION_EVENT_SINK:
+    case PA_SUBSCRIPTION_EVENT_SOURCE: {
+        const bool source = facility == PA_SUBSCRIPTION_EVENT_SOURCE;
+
+        if (removed) {
+            QMetaObject::invokeMethod(self, [self, source, index]() {
+                self->removeDevice(source, index);
+            }, Qt::QueuedConnection);
+            return;
+        }
+
+        // Hanya device yang berubah yang di-query ulang
+        op = source ? pa_context_get_source_info_by_index(c, index, sourceInfoCallback, self)
+                    : pa_context_get_sink_info_by_index(c, index, sinkInfoCallback, self);
+        break;
+    }
+
+    case PA_SUBSCRIPTION_EVENT_SERVER:
+        op = pa_context_get_server_info(c, serverInfoCallback, self);
+        break;
+
+    default:
+        break;
+    }
+
+    if (op)
+        pa_operation_unref(op);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::serverInfoCallback(pa_context *, const pa_server_info *info, void *userdata)
+{
+    auto *self = static_cast<AudioDeviceRegistry *>(userdata);
+
+    if (!info)
+        return;
+
+    const QString sink = QString::fromUtf8(info->default_sink_name);
+    const QString source = QString::fromUtf8(info->default_source_name);
+
+    QMetaObject::invokeMethod(self, [self, sink, source]() {
+        self->setDefaults(sink, source);
+    }, Qt::QueuedConnection);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::sinkInfoCallback(pa_context *, const pa_sink_info *info, int eol, void *userdata)
+{
+    auto *self = static_cast<AudioDeviceRegistry *>(userdata);
+
+    if (eol != 0 || !info)
+        return;
+
+    const Device d = deviceFromSink(info);
+    QMetaObject::invokeMethod(self, [self, d]() { self->updateDevice(d); }, Qt::QueuedConnection);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioDeviceRegistry::sourceInfoCallback(pa_context *, const pa_source_info *info, int eol, void *userdata)
+{
+    auto *self = static_cast<AudioDeviceRegistry *>(userdata);
+
+    if (eol != 0) {
+        // eol daftar source awal: server info dan sink sudah terjawab lebih dulu
+        if (eol > 0 && !self->m_initialDone) {
+            self->m_initialDone = true;
+            QMetaObject::invokeMethod(self, [self]() { self->markReady(); }, Qt::QueuedConnection);
+        }
+        return;
+    }
+
+    if (!info)
+        return;
+
+    const Device d = deviceFromSource(info);
+    QMetaObject::invokeMethod(self, [self, d]() { self->updateDevice(d); }, Qt::QueuedConnection);
+}
+
+#else
+
+//---------------------------------------------------------------------------------------
+bool AudioDeviceRegistry::start()
+{
+    return false;
+}
+
+void AudioDeviceRegistry::teardown()
+{
+}
+
+quint64 AudioDeviceRegistry::setSourceMute(const QString &, bool)
+{
+    return 0;
+}
+
+quint64 AudioDeviceRegistry::setSourceVolume(const QString &, double)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef AUDIODEVICEREGISTRY_H
+#define AUDIODEVICEREGISTRY_H
+
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+#ifdef PLATFORM_LINUX
+    #include <pulse/pulseaudio.h>
+#endif
+
+/*
+ * Registry sink/source audio in-memory di atas libpulse (PipeWire-pulse).
+ *
+ * Satu context dibuka sekali dan subscribe ke event sink, source dan server;
+ * daftar awal dibaca sekali, selanjutnya hanya device yang berubah yang
+ * di-query ulang. Data registry hidup di thread milik object ini (thread
+ * GUI): callback pulse hanya menyalin info lalu mem-post ke thread itu, jadi
+ * pembaca tidak perlu lock.
+ *
+ * Mute / volume dikirim langsung lewat API (tanpa proses wpctl); hasilnya
+ * datang asinkron lewat operationFinished(id). Context putus (PipeWire
+ * restart) -> dibuka ulang setelah RECONNECT_MS.
+ */
+class AudioDeviceRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Device {
+        quint32 index = quint32(-1);
+        QString name;
+        QString description;
+        bool source = false;
+        bool monitor = false;           // monitor sink, bukan mic
+        bool muted = false;
+        double volume = 0.0;            // 1.0 = 100% (skala sama dengan wpctl)
+        int channels = 0;
+    };
+
+    explicit AudioDeviceRegistry(QObject *parent = nullptr);
+    ~AudioDeviceRegistry();
+
+    bool start();
+    void stop();
+    bool isReady() const { return m_ready; }
+
+    QList<Device> sinks() const { return m_sinks.values(); }
+    QList<Device> sources() const { return m_sources.values(); }
+    QString defaultSinkName() const { return m_defaultSink; }
+    QString defaultSourceName() const { return m_defaultSource; }
+
+    // name kosong / DEFAULT_SOURCE = source default
+    bool findSource(const QString &name, Device *out) const;
+
+    // Target perangkat: speaker KT USB, mic ReSpeaker (fallback default /
+    // source non-monitor pertama). Kosong kalau tidak ada.
+    QString preferredSink() const;
+    QString preferredSource() const;
+
+    // Asinkron. Mengembalikan id operasi (> 0), 0 kalau tidak bisa dikirim.
+    quint64 setSourceMute(const QString &name, bool muted);
+    quint64 setSourceVolume(const QString &name, double volume);
+
+    static constexpr auto DEFAULT_SOURCE = "@DEFAULT_SOURCE@";
+    static constexpr int RECONNECT_MS = 5000;
+
+signals:
+    void ready();
+    void devicesChanged();
+    void sourceChanged(const AudioDeviceRegistry::Device &device);
+    void operationFinished(quint64 id, bool ok, const QString &error);
+
+private:
+    // Thread GUI
+    void updateDevice(const Device &device);
+    void removeDevice(bool source, quint32 index);
+    void setDefaults(const QString &sink, const QString &source);
+    void markReady();
+    void connectionLost();
+    void teardown();
+    QString resolveSource(const QString &name) const;
+
+#ifdef PLATFORM_LINUX
+    struct Operation {
+        AudioDeviceRegistry *self = nullptr;
+        quint64 id = 0;
+    };
+
+    static void contextStateCallback(pa_context *c, void *userdata);
+    static void subscribeCallback(pa_context *c, pa_subscription_event_type_t t, quint32 index, void *userdata);
+    static void serverInfoCallback(pa_context *c, const pa_server_info *info, void *userdata);
+    static void sinkInfoCallback(pa_context *c, const pa_sink_info *info, int eol, void *userdata);
+    static void sourceInfoCallback(pa_context *c, const pa_source_info *info, int eol, void *userdata);
+    static void operationCallback(pa_context *c, int success, void *userdata);
+
+    // Dengan lock mainloop
+    Operation *newOperationLocked();
+    void releaseOperationLocked(Operation *op);
+
+    pa_threaded_mainloop *m_mainloop = nullptr;
+    pa_context *m_context = nullptr;
+    std::vector<std::unique_ptr<Operation>> m_operations;
+    bool m_initialDone = false;         // thread pulse
+#endif
+
+    QHash<quint32, Device> m_sinks;
+    QHash<quint32, Device> m_sources;
+    QString m_defaultSink;
+    QString m_defaultSource;
+    quint64 m_nextOperation = 1;
+    bool m_ready = false;
+    bool m_running = false;
+    bool m_reconnect = false;
+};
+
+Q_DECLARE_METATYPE(AudioDeviceRegistry::Device)
+
+#endif // AUDIODEVICEREGISTRY_H
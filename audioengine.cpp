@@ -0,0 +1,476 @@
+#include "audioengine.h"
+
+#include "metrics.h"
+#include "pcmutils.h"
+#include "promptcache.h"
+
+#include <QDebug>
+#include <QDeadlineTimer>
+#include <QMetaObject>
+#include <QTimer>
+
+#include <algorithm>
+
+//---------------------------------------------------------------------------------------
+AudioEngine::AudioEngine(QObject *parent)
+    : QObject(parent)
+{
+}
+
+//---------------------------------------------------------------------------------------
+AudioEngine::~AudioEngine()
+{
+    stop();
+}
+
+//---------------------------------------------------------------------------------------
+qint64 AudioEngine::Voice::totalFrames() const
+{
+    return pcm.size() / PromptCache::BYTES_PER_FRAME;
+}
+
+#ifdef PLATFORM_LINUX
+
+//---------------------------------------------------------------------------------------
+bool AudioEngine::start(int timeoutMs)
+{
+    if (m_mainloop)
+        return isReady();
+
+    m_mainloop = pa_threaded_mainloop_new();
+    pa_mainloop_api *api = pa_threaded_mainloop_get_api(m_mainloop);
+
+    m_context = pa_context_new(api, "radarScanAudio");
+    pa_context_set_state_callback(m_context, contextStateCallback, this);
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    if (pa_threaded_mainloop_start(m_mainloop) < 0
+        || pa_context_connect(m_context, nullptr, PA_CONTEXT_NOFLAGS, nullptr) < 0) {
+        pa_threaded_mainloop_unlock(m_mainloop);
+        qWarning() << "AudioEngine: gagal konek PulseAudio";
+        stop();
+        return false;
+    }
+
+    // Tunggu context + stream READY (callback memanggil signal mainloop)
+    QDeadlineTimer deadline(timeoutMs);
+    while (!m_ready.load(std::memory_order_acquire) && !deadline.hasExpired()) {
+        const pa_context_state_t cs = pa_context_get_state(m_context);
+        if (!PA_CONTEXT_IS_GOOD(cs))
+            break;
+        if (m_stream && !PA_STREAM_IS_GOOD(pa_stream_get_state(m_stream)))
+            break;
+
+        pa_threaded_mainloop_wait(m_mainloop);
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    if (!isReady()) {
+        qWarning() << "AudioEngine: stream playback tidak siap";
+        stop();
+        return false;
+    }
+
+    qDebug() << "AudioEngine ready:" << PromptCache::SAMPLE_RATE << "Hz mono, target latency"
+             << TARGET_LATENCY_MS << "ms";
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioEngine::stop()
+{
+    if (!m_mainloop)
+        return;
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    m_ready.store(false, std::memory_order_release);
+
+    if (m_stream) {
+        pa_stream_set_write_callback(m_stream, nullptr, nullptr);
+        pa_stream_set_state_callback(m_stream, nullptr, nullptr);
+        pa_stream_disconnect(m_stream);
+        pa_stream_unref(m_stream);
+        m_stream = nullptr;
+    }
+
+    if (m_context) {
+        pa_context_set_state_callback(m_context, nullptr, nullptr);
+        pa_context_disconnect(m_context);
+        pa_context_unref(m_context);
+        m_context = nullptr;
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    pa_threaded_mainloop_stop(m_mainloop);
+    pa_threaded_mainloop_free(m_mainloop);
+    m_mainloop = nullptr;
+
+    m_voices.clear();
+    m_tails.clear();
+    m_frameClock = 0;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioEngine::contextStateCallback(pa_context *c, void *userdata)
+{
+    auto *self = static_cast<AudioEngine *>(userdata);
+
+    switch (pa_context_get_state(c)) {
+    case PA_CONTEXT_READY: {
+        pa_sample_spec spec;
+        spec.format = PA_SAMPLE_S16NE;
+        spec.rate = PromptCache::SAMPLE_RATE;
+        spec.channels = PromptCache::CHANNELS;
+
+        self->m_stream = pa_stream_new(c, "prompts", &spec, nullptr);
+        if (!self->m_stream) {
+            pa_threaded_mainloop_signal(self->m_mainloop, 0);
+            break;
+        }
+
+        pa_stream_set_state_callback(self->m_stream, streamStateCallback, self);
+        pa_stream_set_write_callback(self->m_stream, writeCallback, self);
+
+        // Buffer kecil: prompt baru tidak antre di belakang silence lama
+        pa_buffer_attr attr;
+        attr.maxlength = uint32_t(-1);
+        attr.tlength = uint32_t(pa_usec_to_bytes(TARGET_LATENCY_MS * PA_USEC_PER_MSEC, &spec));
+        attr.prebuf = uint32_t(-1);
+        attr.minreq = uint32_t(-1);
+        attr.fragsize = uint32_t(-1);
+
+        const auto flags = pa_stream_flags_t(PA_STREAM_ADJUST_LATENCY
+                                             | PA_STREAM_AUTO_TIMING_UPDATE
+                                             | PA_STREAM_INTERPOLATE_TIMING);
+
+        if (pa_stream_connect_playback(self->m_stream, nullptr, &attr, flags, nullptr, nullptr) < 0)
+            pa_threaded_mainloop_signal(self->m_mainloop, 0);
+        break;
+    }
+
+    case PA_CONTEXT_FAILED:
+    case PA_CONTEXT_TERMINATED:
+        if (self->m_ready.exchange(false)) {
+            QMetaObject::invokeMethod(self, [self]() {
+                emit self->failed(QStringLiteral("Koneksi PulseAudio terputus"));
+            }, Qt::QueuedConnection);
+        }
+        pa_threaded_mainloop_signal(self->m_mainloop, 0);
+        break;
+
+    default:
+        break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioEngine::streamStateCallback(pa_stream *s, void *userdata)
+{
+    auto *self = static_cast<AudioEngine *>(userdata);
+
+    switch (pa_stream_get_state(s)) {
+    case PA_STREAM_READY:
+        self->m_ready.store(true, std::memory_order_release);
+        pa_threaded_mainloop_signal(self->m_mainloop, 0);
+        break;
+
+    case PA_STREAM_FAILED:
+    case PA_STREAM_TERMINATED:
+        if (self->m_ready.exchange(false)) {
+            QMetaObject::invokeMethod(self, [self]() {
+                emit self->failed(QStringLiteral("Stream playback gagal"));
+            }, Qt::QueuedConnection);
+        }
+        pa_threaded_mainloop_signal(self->m_mainloop, 0);
+        break;
+
+    default:
+        break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioEngine::writeCallback(pa_stream *, size_t nbytes, void *userdata)
+{
+    static_cast<AudioEngine *>(userdata)->fillLocked(nbytes);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioEngine::postFinished(quint64 id, qint64 delayMs)
+{
+    // Dari thread pulse -> thread engine; timer menunggu ekor buffer habis diputar.
+    // Kalau ekornya sudah dipotong flush (interrupted), id tidak ada lagi di m_tails.
+    QMetaObject::invokeMethod(
+        this,
+        [this, id, delayMs]() {
+            QTimer::singleShot(int(delayMs), Qt::PreciseTimer, this, [this, id]() {
+                if (!m_mainloop)
+                    return;
+
+                pa_threaded_mainloop_lock(m_mainloop);
+                const bool pending = m_tails.remove(id) > 0;
+                pa_threaded_mainloop_unlock(m_mainloop);
+
+                if (pending)
+                    emit finished(id);
+            });
+        },
+        Qt::QueuedConnection);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioEngine::updateDuckingLocked()
+{
+    // Prioritas tertinggi di antara voice yang sudah mulai berbunyi
+    int highest = -1;
+    for (const Voice &v : std::as_const(m_voices)) {
+        if (v.startFrame <= m_frameClock)
+            highest = qMax(highest, v.priority);
+    }
+
+    for (Voice &v : m_voices)
+        v.targetGain = (v.duckable && v.priority < highest) ? DUCK_GAIN : 1.0f;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioEngine::fillLocked(size_t nbytes)
+{
+    if (!m_stream || nbytes == 0)
+        return;
+
+    void *buf = nullptr;
+    size_t len = nbytes;
+    if (pa_stream_begin_write(m_stream, &buf, &len) < 0 || !buf)
+        return;
+
+    const qint64 frames = qint64(len / PromptCache::BYTES_PER_FRAME);
+    if (frames == 0) {
+        pa_stream_cancel_write(m_stream);
+        return;
+    }
+
+    if (m_mix.size() < frames)
+        m_mix.resize(frames);
+    std::fill_n(m_mix.data(), frames, 0);
+
+    updateDuckingLocked();
+
+    constexpr float rampStep = 1.0f / float(GAIN_RAMP_MS * PromptCache::SAMPLE_RATE / 1000);
+    qint64 latencyMs = -1;
+
+    for (int i = 0; i < m_voices.size();) {
+        Voice &v = m_voices[i];
+
+        // Voice terjadwal setelah potongan ini: belum ikut mix
+        const qint64 begin = v.startFrame - m_frameClock;
+        if (begin >= frames) {
+            ++i;
+            continue;
+        }
+
+        const qint64 at = qMax<qint64>(0, begin);
+        const qint64 n = qMin(frames - at, v.totalFrames() - v.offsetFrames);
+        const qint16 *src = reinterpret_cast<const qint16 *>(v.pcm.constData()) + v.offsetFrames;
+        qint32 *acc = m_mix.data() + at;
+
+        // Ramp gain per sampel (duck / unduck tanpa klik), sisanya gain konstan
+        qint64 k = 0;
+        for (; k < n && v.gain != v.targetGain; ++k) {
+            v.gain = v.gain < v.targetGain ? qMin(v.gain + rampStep, v.targetGain)
+                                           : qMax(v.gain - rampStep, v.targetGain);
+            acc[k] += qint32(float(src[k]) * v.gain);
+        }
+
+        if (v.gain == 1.0f) {
+            for (; k < n; ++k)
+                acc[k] += src[k];
+        } else {
+            const qint32 g = qint32(v.gain * 65536.0f);
+            for (; k < n; ++k)
+                acc[k] += (qint32(src[k]) * g) >> 16;
+        }
+
+        v.offsetFrames += n;
+
+        if (v.offsetFrames >= v.totalFrames()) {
+            // Sampel terakhir ada di posisi (at + n) potongan ini; finished setelah
+            // audio yang sudah antre + posisi itu selesai diputar
+            if (latencyMs < 0) {
+                pa_usec_t latency = 0;
+                int negative = 0;
+                if (pa_stream_get_latency(m_stream, &latency, &negative) < 0 || negative)
+                    latency = TARGET_LATENCY_MS * PA_USEC_PER_MSEC;
+                latencyMs = qint64(latency / PA_USEC_PER_MSEC);
+            }
+
+            const qint64 tailMs = latencyMs + (at + n) * 1000 / PromptCache::SAMPLE_RATE;
+
+            m_tails.insert(v.id, v.priority);
+            postFinished(v.id, tailMs);
+            m_voices.removeAt(i);
+            continue;
+        }
+
+        ++i;
+    }
+
+    // Clip int32 -> S16; frame tanpa voice tetap silence (sink tidak suspend)
+    const quint32 clipped = pcm::saturateS32ToS16(m_mix.constData(), static_cast<qint16 *>(buf), int(frames));
+
+    if (clipped)
+        METRIC_COUNTER("audio.clipped_samples").inc(clipped);
+
+    pa_stream_write(m_stream, buf, size_t(frames) * PromptCache::BYTES_PER_FRAME, nullptr, 0, PA_SEEK_RELATIVE);
+    m_frameClock += frames;
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioEngine::flushLocked(int priority, QVector<quint64> &cut)
+{
+    // Ekor voice dengan prioritas >= priority tidak boleh terpotong
+    for (auto it = m_tails.cbegin(); it != m_tails.cend(); ++it) {
+        if (it.value() >= priority)
+            return false;
+    }
+
+    pa_operation *op = pa_stream_flush(m_stream, nullptr, nullptr);
+    if (op)
+        pa_operation_unref(op);
+
+    for (auto it = m_tails.cbegin(); it != m_tails.cend(); ++it)
+        cut.append(it.key());
+    m_tails.clear();
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioEngine::play(quint64 id, const QByteArray &pcm, int priority, bool duckable)
+{
+    if (!isReady() || id == 0 || pcm.size() < PromptCache::BYTES_PER_FRAME)
+        return false;
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    for (const Voice &v : std::as_const(m_voices)) {
+        if (v.priority > priority) {
+            // Pemanggil menunggu sampai voice yang lebih penting selesai
+            pa_threaded_mainloop_unlock(m_mainloop);
+            return false;
+        }
+    }
+
+    const bool wasIdle = m_voices.isEmpty();
+    bool preempted = false;
+    bool ducked = false;
+    QVector<quint64> cut;
+
+    for (int i = m_voices.size() - 1; i >= 0; --i) {
+        Voice &v = m_voices[i];
+        if (v.priority >= priority)
+            continue;
+
+        if (v.duckable) {
+            v.targetGain = DUCK_GAIN;
+            ducked = true;
+        } else {
+            cut.prepend(v.id);
+            m_voices.removeAt(i);
+            preempted = true;
+        }
+    }
+
+    // Prioritas sama: sambung tepat di frame setelah voice terakhir berakhir
+    qint64 startFrame = m_frameClock;
+    for (const Voice &v : std::as_const(m_voices)) {
+        if (v.priority == priority)
+            startFrame = qMax(startFrame, v.startFrame + v.totalFrames());
+    }
+
+    // Mulai dari idle / memotong: buang audio yang sudah antre lalu tulis langsung.
+    // Voice yang hanya di-duck tetap berbunyi, audionya di buffer server tidak boleh hilang.
+    bool flushed = false;
+    if (startFrame == m_frameClock && (wasIdle || (preempted && !ducked)))
+        flushed = flushLocked(priority, cut);
+
+    Voice voice;
+    voice.id = id;
+    voice.pcm = pcm;
+    voice.startFrame = startFrame;
+    voice.priority = priority;
+    voice.duckable = duckable;
+    m_voices.append(voice);
+
+    if (flushed) {
+        const size_t writable = pa_stream_writable_size(m_stream);
+        if (writable != size_t(-1) && writable > 0)
+            fillLocked(writable);
+    }
+
+    METRIC_GAUGE("audio.voices").set(m_voices.size());
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    if (!cut.isEmpty())
+        METRIC_COUNTER("audio.preempted").inc(quint64(cut.size()));
+    if (ducked)
+        METRIC_COUNTER("audio.ducked").inc();
+
+    for (quint64 cutId : std::as_const(cut))
+        emit interrupted(cutId);
+
+    emit started(id);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioEngine::cancelBelow(int priority)
+{
+    if (!isReady())
+        return;
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    QVector<quint64> cut;
+    for (int i = m_voices.size() - 1; i >= 0; --i) {
+        if (m_voices[i].priority < priority) {
+            cut.prepend(m_voices[i].id);
+            m_voices.removeAt(i);
+        }
+    }
+
+    // Tanpa voice tersisa: buang juga audio yang sudah antre di server
+    if (!cut.isEmpty() && m_voices.isEmpty())
+        flushLocked(priority, cut);
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    for (quint64 cutId : std::as_const(cut))
+        emit interrupted(cutId);
+}
+
+#else
+
+//---------------------------------------------------------------------------------------
+bool AudioEngine::start(int)
+{
+    return false;
+}
+
+void AudioEngine::stop()
+{
+}
+
+void AudioEngine::cancelBelow(int)
+{
+}
+
+bool AudioEngine::play(quint64, const QByteArray &, int, bool)
+{
+    return false;
+}
+
+#endif
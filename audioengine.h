@@ -0,0 +1,105 @@
+#ifndef AUDIOENGINE_H
+#define AUDIOENGINE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+#include <atomic>
+
+#ifdef PLATFORM_LINUX
+    #include <pulse/pulseaudio.h>
+#endif
+
+/*
+ * Mixer playback in-process di atas libpulse (PipeWire-pulse di RPi).
+ *
+ * Satu pa_stream playback dibuat sekali di start() dan tidak pernah ditutup;
+ * callback write di thread mainloop pulse adalah thread mixer. Setiap
+ * voice (PCM format PromptCache) punya prioritas:
+ *
+ *  - voice baru ditolak kalau ada voice berprioritas lebih tinggi
+ *    (pemanggil menunggu),
+ *  - voice berprioritas lebih rendah dipotong (interrupted) atau di-duck
+ *    ke DUCK_GAIN kalau duckable, dan kembali ke gain penuh setelah voice
+ *    yang lebih tinggi selesai (ramp GAIN_RAMP_MS, tanpa klik),
+ *  - voice dengan prioritas sama dijadwalkan sample-accurate tepat di
+ *    frame setelah voice sebelumnya berakhir (tanpa gap).
+ *
+ * Saat idle stream diisi silence (sink tidak suspend). Voice yang memotong
+ * atau mulai dari idle mem-flush buffer server lalu langsung ditulis, jadi
+ * audio mulai dalam orde satu periode buffer (TARGET_LATENCY_MS).
+ *
+ * finished(id) di-emit setelah sampel terakhir ditulis DAN latensi stream
+ * terlewati. Signal di-emit di thread milik object ini (thread AudioWorker).
+ */
+class AudioEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AudioEngine(QObject *parent = nullptr);
+    ~AudioEngine();
+
+    // Blocking sampai stream siap atau timeout
+    bool start(int timeoutMs = 2000);
+    void stop();
+    bool isReady() const { return m_ready.load(std::memory_order_acquire); }
+
+    // false kalau engine belum siap atau ada voice dengan prioritas lebih tinggi
+    bool play(quint64 id, const QByteArray &pcm, int priority, bool duckable);
+
+    // Hentikan semua voice dengan prioritas < priority (interrupted)
+    void cancelBelow(int priority);
+
+    static constexpr int TARGET_LATENCY_MS = 40;
+    static constexpr float DUCK_GAIN = 0.2f;
+    static constexpr int GAIN_RAMP_MS = 10;
+
+signals:
+    void started(quint64 id);
+    void finished(quint64 id);
+    void interrupted(quint64 id);
+    void failed(const QString &error);
+
+private:
+    struct Voice {
+        quint64 id = 0;
+        QByteArray pcm;
+        qint64 offsetFrames = 0;
+        qint64 startFrame = 0;      // frame stream (m_frameClock) saat voice mulai
+        int priority = 0;
+        bool duckable = false;
+        float gain = 1.0f;
+        float targetGain = 1.0f;
+
+        qint64 totalFrames() const;
+    };
+
+#ifdef PLATFORM_LINUX
+    static void contextStateCallback(pa_context *c, void *userdata);
+    static void streamStateCallback(pa_stream *s, void *userdata);
+    static void writeCallback(pa_stream *s, size_t nbytes, void *userdata);
+
+    // Semua *Locked dipanggil dengan lock mainloop
+    void fillLocked(size_t nbytes);
+    bool flushLocked(int priority, QVector<quint64> &cut);
+    void updateDuckingLocked();
+    void postFinished(quint64 id, qint64 delayMs);
+
+    pa_threaded_mainloop *m_mainloop = nullptr;
+    pa_context *m_context = nullptr;
+    pa_stream *m_stream = nullptr;
+#endif
+
+    // State mixer (akses dengan lock mainloop)
+    QVector<Voice> m_voices;
+    QHash<quint64, int> m_tails;    // sudah ditulis semua, ekornya masih di buffer server -> prioritas
+    QVector<qint32> m_mix;
+    qint64 m_frameClock = 0;        // total frame yang sudah ditulis ke stream
+
+    std::atomic<bool> m_ready{false};
+};
+
+#endif // AUDIOENGINE_H
@@ -0,0 +1,415 @@
+#include "audioloopbacktest.h"
+
+#include "metrics.h"
+
+#include <QDebug>
+#include <QMetaObject>
+
+//---------------------------------------------------------------------------------------
+AudioLoopbackTest::AudioLoopbackTest(QObject *parent)
+    : QObject(parent)
+{
+    m_timeout.setSingleShot(true);
+
+    // Timeout: analisis apa yang sudah tertangkap (sync tidak ada -> report FAIL)
+    connect(&m_timeout, &QTimer::timeout, this, [this]() {
+        m_done.store(true);
+        qWarning() << "AudioLoopbackTest: timeout, analisis capture parsial";
+        complete(true, QString());
+    });
+}
+
+//---------------------------------------------------------------------------------------
+AudioLoopbackTest::~AudioLoopbackTest()
+{
+    m_done.store(true);
+    m_timeout.stop();
+    teardown();
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::cancel()
+{
+    m_done.store(true);
+    complete(false, QStringLiteral("Audio health test dibatalkan"));
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::postComplete(bool analyze, const QString &error)
+{
+    // Dari thread mainloop pulse; hanya hasil pertama yang dipakai
+    if (m_done.exchange(true))
+        return;
+
+    QMetaObject::invokeMethod(
+        this,
+        [this, analyze, error]() { complete(analyze, error); },
+        Qt::QueuedConnection);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::complete(bool analyze, const QString &error)
+{
+    if (!m_running)
+        return;
+
+    m_timeout.stop();
+
+    // Stream ditutup dulu: setelah ini analyzer hanya disentuh thread ini
+    teardown();
+    m_running = false;
+
+    const qint64 elapsedMs = m_clock.elapsed();
+    METRIC_HISTOGRAM("audio.health_test_ms").record(quint64(elapsedMs));
+
+    if (analyze && m_analyzer) {
+        AudioHealthChecker::Report report;
+        m_analyzer->finish(report);
+
+        qDebug() << "AudioLoopbackTest selesai dalam" << elapsedMs << "ms, verdict" << report.verdict;
+        m_analyzer.reset();
+        m_stimulus.clear();
+
+        emit finished(report);
+        return;
+    }
+
+    qWarning().noquote() << "AudioLoopbackTest gagal:" << error;
+    m_analyzer.reset();
+    m_stimulus.clear();
+
+    emit failed(error);
+}
+
+#ifdef PLATFORM_LINUX
+
+//---------------------------------------------------------------------------------------
+bool AudioLoopbackTest::start(const QString &sinkName, const QString &sourceName)
+{
+    if (m_running)
+        return false;
+
+    m_sinkName = sinkName;
+    m_sourceName = sourceName;
+    m_detected.clear();
+
+    m_stimulus = AudioHealthChecker::createTestSignal();
+    m_playPos = 0;
+    m_analyzer = std::make_unique<AudioHealthChecker::StreamAnalyzer>(AudioHealthChecker::testSampleRate());
+    m_done.store(false);
+
+    m_spec.format = PA_SAMPLE_FLOAT32NE;
+    m_spec.rate = uint32_t(AudioHealthChecker::testSampleRate());
+    m_spec.channels = 1;
+
+    m_mainloop = pa_threaded_mainloop_new();
+    m_context = pa_context_new(pa_threaded_mainloop_get_api(m_mainloop), "radarScanHealth");
+    pa_context_set_state_callback(m_context, contextStateCallback, this);
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    if (pa_threaded_mainloop_start(m_mainloop) < 0
+        || pa_context_connect(m_context, nullptr, PA_CONTEXT_NOFLAGS, nullptr) < 0) {
+        pa_threaded_mainloop_unlock(m_mainloop);
+        qWarning() << "AudioLoopbackTest: gagal konek PulseAudio";
+        teardown();
+        m_analyzer.reset();
+        return false;
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    m_running = true;
+    m_clock.start();
+
+    const int stimulusMs = int(qint64(m_stimulus.size()) * 1000 / AudioHealthChecker::testSampleRate());
+    m_timeout.start(stimulusMs + TIMEOUT_MARGIN_MS);
+
+    qDebug() << "AudioLoopbackTest started, stimulus" << stimulusMs << "ms";
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::teardown()
+{
+    if (!m_mainloop)
+        return;
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    for (pa_stream **stream : {&m_record, &m_play}) {
+        if (!*stream)
+            continue;
+
+        pa_stream_set_state_callback(*stream, nullptr, nullptr);
+        pa_stream_set_read_callback(*stream, nullptr, nullptr);
+        pa_stream_set_write_callback(*stream, nullptr, nullptr);
+        pa_stream_disconnect(*stream);
+        pa_stream_unref(*stream);
+        *stream = nullptr;
+    }
+
+    if (m_context) {
+        pa_context_set_state_callback(m_context, nullptr, nullptr);
+        pa_context_disconnect(m_context);
+        pa_context_unref(m_context);
+        m_context = nullptr;
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    pa_threaded_mainloop_stop(m_mainloop);
+    pa_threaded_mainloop_free(m_mainloop);
+    m_mainloop = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::contextStateCallback(pa_context *c, void *userdata)
+{
+    auto *self = static_cast<AudioLoopbackTest *>(userdata);
+
+    switch (pa_context_get_state(c)) {
+    case PA_CONTEXT_READY:
+        if (self->m_sinkName.isEmpty() || self->m_sourceName.isEmpty()) {
+            // Cari target dari daftar device: sink dulu, lalu source
+            pa_operation *op = pa_context_get_sink_info_list(c, sinkInfoCallback, self);
+            if (op)
+                pa_operation_unref(op);
+        } else {
+            self->openRecordStream();
+        }
+        break;
+
+    case PA_CONTEXT_FAILED:
+    case PA_CONTEXT_TERMINATED:
+        self->postComplete(false, QStringLiteral("Koneksi PulseAudio gagal"));
+        break;
+
+    default:
+        break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::sinkInfoCallback(pa_context *c, const pa_sink_info *info, int eol, void *userdata)
+{
+    auto *self = static_cast<AudioLoopbackTest *>(userdata);
+
+    if (eol < 0) {
+        self->postComplete(false, QStringLiteral("Gagal membaca daftar sink"));
+        return;
+    }
+
+    if (eol > 0) {
+        pa_operation *op = pa_context_get_source_info_list(c, sourceInfoCallback, self);
+        if (op)
+            pa_operation_unref(op);
+        return;
+    }
+
+    const QString name = QString::fromUtf8(info->name);
+    const QString desc = QString::fromUtf8(info->description);
+    self->m_detected << QStringLiteral("sink %1 (%2)").arg(name, desc);
+
+    // Target speaker wajib KT USB
+    if (self->m_sinkName.isEmpty()
+        && (desc.contains("kt usb", Qt::CaseInsensitive)
+            || (desc.contains("kt", Qt::CaseInsensitive) && desc.contains("usb", Qt::CaseInsensitive))
+            || name.contains("kt_usb", Qt::CaseInsensitive))) {
+        self->m_sinkName = name;
+        qDebug() << "Matched KT USB sink:" << name << desc;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::sourceInfoCallback(pa_context *, const pa_source_info *info, int eol, void *userdata)
+{
+    auto *self = static_cast<AudioLoopbackTest *>(userdata);
+
+    if (eol < 0) {
+        self->postComplete(false, QStringLiteral("Gagal membaca daftar source"));
+        return;
+    }
+
+    if (eol > 0) {
+        if (self->m_sinkName.isEmpty()) {
+            self->postComplete(false, QStringLiteral("KT USB speaker sink not found.\n\nDetected:\n")
+                                          + self->m_detected.join('\n'));
+            return;
+        }
+
+        if (self->m_sourceName.isEmpty())
+            qWarning() << "ReSpeaker source not found. Using default source";
+
+        self->openRecordStream();
+        return;
+    }
+
+    // Monitor sink bukan mic
+    if (info->monitor_of_sink != PA_INVALID_INDEX)
+        return;
+
+    const QString name = QString::fromUtf8(info->name);
+    const QString desc = QString::fromUtf8(info->description);
+    self->m_detected << QStringLiteral("source %1 (%2)").arg(name, desc);
+
+    if (self->m_sourceName.isEmpty()
+        && (desc.contains("respeaker", Qt::CaseInsensitive) || desc.contains("seeed", Qt::CaseInsensitive)
+            || desc.contains("4 mic", Qt::CaseInsensitive) || desc.contains("mic array", Qt::CaseInsensitive))) {
+        self->m_sourceName = name;
+        qDebug() << "Matched ReSpeaker source:" << name << desc;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::openRecordStream()
+{
+    m_record = pa_stream_new(m_context, "healthCapture", &m_spec, nullptr);
+    if (!m_record) {
+        postComplete(false, QStringLiteral("Gagal membuat stream record"));
+        return;
+    }
+
+    pa_stream_set_state_callback(m_record, recordStateCallback, this);
+    pa_stream_set_read_callback(m_record, readCallback, this);
+
+    // Fragment kecil: analyzer melihat capture hampir real-time
+    pa_buffer_attr attr;
+    attr.maxlength = uint32_t(-1);
+    attr.tlength = uint32_t(-1);
+    attr.prebuf = uint32_t(-1);
+    attr.minreq = uint32_t(-1);
+    attr.fragsize = uint32_t(pa_usec_to_bytes(CAPTURE_FRAGMENT_MS * PA_USEC_PER_MSEC, &m_spec));
+
+    const QByteArray device = m_sourceName.toUtf8();
+
+    if (pa_stream_connect_record(m_record, device.isEmpty() ? nullptr : device.constData(), &attr,
+                                 PA_STREAM_ADJUST_LATENCY) < 0) {
+        postComplete(false, QStringLiteral("Gagal konek stream record ke %1").arg(m_sourceName));
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::openPlayStream()
+{
+    m_play = pa_stream_new(m_context, "healthStimulus", &m_spec, nullptr);
+    if (!m_play) {
+        postComplete(false, QStringLiteral("Gagal membuat stream playback"));
+        return;
+    }
+
+    pa_stream_set_state_callback(m_play, playStateCallback, this);
+    pa_stream_set_write_callback(m_play, writeCallback, this);
+
+    const QByteArray device = m_sinkName.toUtf8();
+
+    if (pa_stream_connect_playback(m_play, device.isEmpty() ? nullptr : device.constData(), nullptr,
+                                   PA_STREAM_NOFLAGS, nullptr, nullptr) < 0) {
+        postComplete(false, QStringLiteral("Gagal konek stream playback ke %1").arg(m_sinkName));
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::recordStateCallback(pa_stream *s, void *userdata)
+{
+    auto *self = static_cast<AudioLoopbackTest *>(userdata);
+
+    switch (pa_stream_get_state(s)) {
+    case PA_STREAM_READY:
+        // Mic sudah merekam: stimulus boleh mulai (pengganti jeda 300 ms)
+        if (!self->m_play)
+            self->openPlayStream();
+        break;
+
+    case PA_STREAM_FAILED:
+    case PA_STREAM_TERMINATED:
+        self->postComplete(false, QStringLiteral("Stream record gagal"));
+        break;
+
+    default:
+        break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::playStateCallback(pa_stream *s, void *userdata)
+{
+    auto *self = static_cast<AudioLoopbackTest *>(userdata);
+
+    const pa_stream_state_t state = pa_stream_get_state(s);
+    if (state == PA_STREAM_FAILED || state == PA_STREAM_TERMINATED)
+        self->postComplete(false, QStringLiteral("Stream playback gagal"));
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::writeCallback(pa_stream *s, size_t nbytes, void *userdata)
+{
+    auto *self = static_cast<AudioLoopbackTest *>(userdata);
+
+    const qsizetype remaining = self->m_stimulus.size() - self->m_playPos;
+    if (remaining <= 0)
+        return;
+
+    // Setelah stimulus habis stream dibiarkan underrun (silence)
+    const size_t frames = qMin(nbytes / sizeof(float), size_t(remaining));
+    if (frames == 0)
+        return;
+
+    pa_stream_write(s, self->m_stimulus.constData() + self->m_playPos, frames * sizeof(float), nullptr, 0,
+                    PA_SEEK_RELATIVE);
+    self->m_playPos += int(frames);
+}
+
+//---------------------------------------------------------------------------------------
+void AudioLoopbackTest::readCallback(pa_stream *s, size_t, void *userdata)
+{
+    auto *self = static_cast<AudioLoopbackTest *>(userdata);
+    static const float zeros[256] = {};
+
+    while (pa_stream_readable_size(s) > 0) {
+        const void *data = nullptr;
+        size_t len = 0;
+
+        if (pa_stream_peek(s, &data, &len) < 0) {
+            self->postComplete(false, QStringLiteral("Gagal membaca capture"));
+            return;
+        }
+
+        if (len == 0)
+            break;
+
+        if (!self->m_done.load()) {
+            int frames = int(len / sizeof(float));
+
+            if (data) {
+                self->m_analyzer->feed(static_cast<const float *>(data), frames);
+            } else {
+                // Hole di buffer server: isi nol supaya timeline tetap benar (terbaca sebagai dropout)
+                while (frames > 0) {
+                    const int n = qMin(frames, 256);
+                    self->m_analyzer->feed(zeros, n);
+                    frames -= n;
+                }
+            }
+        }
+
+        pa_stream_drop(s);
+    }
+
+    if (!self->m_done.load() && self->m_analyzer->isComplete())
+        self->postComplete(true, QString());
+}
+
+#else
+
+//---------------------------------------------------------------------------------------
+bool AudioLoopbackTest::start(const QString &, const QString &)
+{
+    return false;
+}
+
+void AudioLoopbackTest::teardown()
+{
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef AUDIOLOOPBACKTEST_H
+#define AUDIOLOOPBACKTEST_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+#include "AudioHealthChecker.h"
+
+#ifdef PLATFORM_LINUX
+    #include <pulse/pulseaudio.h>
+#endif
+
+/*
+ * Audio health test loopback in-process (speaker -> mic).
+ *
+ * Stimulus dibuat di memory (AudioHealthChecker::createTestSignal), diputar
+ * lewat stream playback libpulse ke speaker dan direkam lewat stream record
+ * dari mic pada context yang sama. Blok capture langsung di-feed ke
+ * StreamAnalyzer di thread mainloop pulse, jadi test selesai begitu segmen
+ * tone terakhir tertangkap: tanpa file WAV, tanpa pw-record/pw-play/wpctl.
+ *
+ * Target kosong = dicari dari daftar sink/source (KT USB / ReSpeaker),
+ * aturan yang sama dengan AudioDeviceRegistry::preferredSink/Source.
+ */
+class AudioLoopbackTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AudioLoopbackTest(QObject *parent = nullptr);
+    ~AudioLoopbackTest();
+
+    bool isRunning() const { return m_running; }
+
+    // Nama sink/source PulseAudio; kosong = cari otomatis
+    bool start(const QString &sinkName = QString(), const QString &sourceName = QString());
+    void cancel();
+
+    static constexpr int CAPTURE_FRAGMENT_MS = 20;
+    static constexpr int TIMEOUT_MARGIN_MS = 3000;   // di atas durasi stimulus
+
+signals:
+    void finished(const AudioHealthChecker::Report &report);
+    void failed(const QString &error);
+
+private:
+    void complete(bool analyze, const QString &error);
+    void teardown();
+    void postComplete(bool analyze, const QString &error);
+
+#ifdef PLATFORM_LINUX
+    static void contextStateCallback(pa_context *c, void *userdata);
+    static void sinkInfoCallback(pa_context *c, const pa_sink_info *info, int eol, void *userdata);
+    static void sourceInfoCallback(pa_context *c, const pa_source_info *info, int eol, void *userdata);
+    static void recordStateCallback(pa_stream *s, void *userdata);
+    static void playStateCallback(pa_stream *s, void *userdata);
+    static void readCallback(pa_stream *s, size_t nbytes, void *userdata);
+    static void writeCallback(pa_stream *s, size_t nbytes, void *userdata);
+
+    // Dipanggil di thread mainloop
+    void openRecordStream();
+    void openPlayStream();
+
+    pa_threaded_mainloop *m_mainloop = nullptr;
+    pa_context *m_context = nullptr;
+    pa_stream *m_record = nullptr;
+    pa_stream *m_play = nullptr;
+    pa_sample_spec m_spec = {};
+#endif
+
+    QString m_sinkName;
+    QString m_sourceName;
+    QStringList m_detected;
+
+    QVector<float> m_stimulus;
+    int m_playPos = 0;
+
+    std::unique_ptr<AudioHealthChecker::StreamAnalyzer> m_analyzer;
+
+    QTimer m_timeout;
+    QElapsedTimer m_clock;
+    bool m_running = false;
+    std::atomic<bool> m_done{false};
+};
+
+#endif // AUDIOLOOPBACKTEST_H
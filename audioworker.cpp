@@ -3,6 +3,9 @@
 #include <QDebug>
 #include <QFileInfo>
 
+#include "audioengine.h"
+#include "metrics.h"
+
 //---------------------------------------------------------------------------------------
 AudioWorker::AudioWorker(QObject *parent)
     : QObject(parent)
@@ -12,6 +15,8 @@ AudioWorker::AudioWorker(QObject *parent)
 //---------------------------------------------------------------------------------------
 AudioWorker::~AudioWorker()
 {
+    delete m_engine;
+
     if (m_playerProcess &&
         m_playerProcess->state() != QProcess::NotRunning) {
 
@@ -32,25 +37,102 @@ void AudioWorker::init()
     connect(m_playerProcess,&QProcess::finished, this,&AudioWorker::onPlaybackFinished);
     connect(m_playerProcess,&QProcess::errorOccurred, this,&AudioWorker::onPlaybackError);
 
+#ifdef Q_OS_LINUX
+    // Decode semua prompt sekali; playback berikutnya tanpa I/O file
+    m_cache.load(QStringLiteral("/home/pi/wav"), {QStringLiteral("sv"), QStringLiteral("id"), QStringLiteral("en")});
+
+    m_engine = new AudioEngine();
+    connect(m_engine, &AudioEngine::finished, this, &AudioWorker::onEngineFinished);
+    connect(m_engine, &AudioEngine::interrupted, this, &AudioWorker::onEngineInterrupted);
+    connect(m_engine, &AudioEngine::failed, this, [this](const QString &error) {
+        qWarning() << "AudioEngine:" << error << "- fallback ke paplay";
+
+        // Voice yang ada di mixer tidak akan pernah finished
+        const QList<SoundQueueItem> lost = m_enginePlays.values();
+        m_enginePlays.clear();
+
+        for (const SoundQueueItem &failedSound : lost)
+            emit playbackFailed(failedSound.sentenceIndex, failedSound.langIndex, error);
+
+        playNext();
+    });
+
+    if (!m_engine->start())
+        qWarning() << "AudioEngine tidak aktif, semua prompt lewat paplay";
+#endif
+
     qDebug() << "AudioWorker initialized";
 }
 
+//---------------------------------------------------------------------------------------
+int AudioWorker::defaultPriority(int sentenceIndex)
+{
+    switch (sentenceIndex) {
+    case SOUND_FALL_OCCUR:
+        return SOUND_PRIORITY_ALARM;
+    case SOUND_RECORD:
+    case SOUND_WAITING:
+    case SOUND_LOGIN:
+        return SOUND_PRIORITY_CHATTER;
+    default:
+        return SOUND_PRIORITY_NORMAL;
+    }
+}
+
 //---------------------------------------------------------------------------------------
 void AudioWorker::enqueueSound(int sentenceIndex,QString langIndex)
+{
+    enqueueSoundPriority(sentenceIndex, langIndex, defaultPriority(sentenceIndex));
+}
+
+//---------------------------------------------------------------------------------------
+void AudioWorker::enqueueSoundPriority(int sentenceIndex, QString langIndex, int priority)
 {
     qDebug() << "enqueueSound received:"
              << "sentenceIndex:" << sentenceIndex
-             << "langIndex:" << langIndex;
+             << "langIndex:" << langIndex
+             << "priority:" << priority;
 
     SoundQueueItem item;
     item.sentenceIndex = sentenceIndex;
     item.langIndex = langIndex;
+    item.priority = qBound(SOUND_PRIORITY_CHATTER, priority, SOUND_PRIORITY_ALARM);
 
-    m_queue.enqueue(item);
+    m_queues[item.priority].enqueue(item);
 
-    if (!m_isPlaying) {
-        playNext();
+    // paplay tidak bisa di-duck: prioritas lebih rendah di-kill,
+    // onPlaybackFinished melaporkan gagal lalu lanjut ke queue
+    if (m_isPlaying && m_currentSound.priority < item.priority
+        && m_playerProcess && m_playerProcess->state() != QProcess::NotRunning) {
+        m_playerProcess->kill();
+    }
+
+    playNext();
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioWorker::levelBusy(int priority) const
+{
+    if (m_isPlaying && m_currentSound.priority == priority)
+        return true;
+
+    for (const SoundQueueItem &item : m_enginePlays) {
+        if (item.priority == priority)
+            return true;
+    }
+
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioWorker::higherBusy(int priority) const
+{
+    for (int p = priority + 1; p < SOUND_PRIORITY_COUNT; ++p) {
+        if (levelBusy(p))
+            return true;
     }
+
+    return false;
 }
 
 //---------------------------------------------------------------------------------------
@@ -70,38 +152,13 @@ QString AudioWorker::requestToFile(int sentenceIndex,const QString &langIndex) c
     }
 
 #ifdef Q_OS_LINUX
-    const QString basePath =
-        QStringLiteral("/home/pi/wav/%1").arg(langFolder);
-
-    switch (sentenceIndex) {
-    case SOUND_FALL_OCCUR:
-        return basePath + QStringLiteral("/fall.wav");
-
-    case SOUND_HELP:
-        return basePath + QStringLiteral("/help.wav");
-
-    case SOUND_IAM_OK:
-        return basePath + QStringLiteral("/iam_ok.wav");
-
-    case SOUND_RECORD:
-        return basePath + QStringLiteral("/record.wav");
-
-    case SOUND_WAITING:
-        return basePath + QStringLiteral("/wait.wav");
-
-    case SOUND_HELPYOU:
-        return basePath + QStringLiteral("/helpyou.wav");
-
-    case SOUND_LOGIN:
-        return basePath + QStringLiteral("/login.mp3");
-
-    case SOUND_UPLOAD_FAILED:
-        return basePath + QStringLiteral("/fail.wav");
-
-    default:
+    const QString fileName = PromptCache::fileNameFor(sentenceIndex);
+    if (fileName.isEmpty()) {
         qWarning() << "Unknown sentence index:" << sentenceIndex;
         return QString();
     }
+
+    return QStringLiteral("/home/pi/wav/") + langFolder + QLatin1Char('/') + fileName;
 #else
     Q_UNUSED(sentenceIndex);
     return QString();
@@ -165,7 +222,8 @@ void AudioWorker::playSoundFile(const QString &soundPath)
         return;
     }
 
-    qDebug() << "Starting paplay:" << soundPath;
+    METRIC_COUNTER("audio.play_started").inc();
+    qCDebug(lcHotPath) << "Starting paplay:" << soundPath;
 
     // Jangan memakai startDetached karena event finished
     // tidak bisa dipantau oleh QProcess ini.
@@ -180,18 +238,72 @@ void AudioWorker::playSoundFile(const QString &soundPath)
 //---------------------------------------------------------------------------------------
 void AudioWorker::playNext()
 {
-    if (m_isPlaying) {
+    // interrupted dari engine di-emit sinkron di dalam play(); jangan re-entry
+    if (m_pumping) {
         return;
     }
 
-    if (m_queue.isEmpty()) {
+    m_pumping = true;
+
+    for (int p = SOUND_PRIORITY_ALARM; p >= SOUND_PRIORITY_CHATTER; --p) {
+        while (!m_queues[p].isEmpty() && !higherBusy(p)) {
+            if (!startHead(p))
+                break;
+        }
+    }
+
+    m_pumping = false;
+
+    if (!m_isPlaying) {
         resetCurrentSound();
-        return;
     }
+}
+
+//---------------------------------------------------------------------------------------
+bool AudioWorker::startHead(int priority)
+{
+    QQueue<SoundQueueItem> &queue = m_queues[priority];
 
-    m_currentSound = m_queue.dequeue();
+    // paplay di level yang sama masih jalan: urutan dijaga
+    if (m_isPlaying && m_currentSound.priority == priority) {
+        return false;
+    }
+
+    // Jalur cepat: PCM dari cache ke mixer; prioritas sama disambung tanpa gap
+    if (m_engine && m_engine->isReady()) {
+        const SoundQueueItem &head = queue.head();
+        const QByteArray pcm = m_cache.pcm(head.sentenceIndex, head.langIndex);
+
+        if (!pcm.isEmpty()) {
+            const quint64 playId = m_nextPlayId++;
+            m_enginePlays.insert(playId, head);
+
+            if (m_engine->play(playId, pcm, priority, priority == SOUND_PRIORITY_NORMAL)) {
+                METRIC_COUNTER("audio.play_started").inc();
+                qCDebug(lcHotPath) << "Engine playing sentenceIndex:" << head.sentenceIndex
+                                   << "langIndex:" << head.langIndex << "priority:" << priority;
+                queue.dequeue();
+                return true;
+            }
+
+            // Masih ada voice lebih tinggi di mixer; coba lagi saat selesai
+            m_enginePlays.remove(playId);
+            return false;
+        }
+    }
+
+    // Fallback paplay: satu proses, tidak bisa di-mix dengan voice di level sama
+    if (m_isPlaying || levelBusy(priority)) {
+        return false;
+    }
+
+    m_currentSound = queue.dequeue();
     m_isPlaying = true;
 
+    // Voice mixer yang lebih rendah tidak boleh tetap berbunyi di bawah paplay
+    if (m_engine)
+        m_engine->cancelBelow(priority);
+
     const QString filePath = requestToFile(
         m_currentSound.sentenceIndex,
         m_currentSound.langIndex
@@ -212,8 +324,7 @@ void AudioWorker::playNext()
 
         m_isPlaying = false;
         resetCurrentSound();
-        playNext();
-        return;
+        return true;
     }
 
     qDebug() << "Playing:"
@@ -224,6 +335,7 @@ void AudioWorker::playNext()
              << m_currentSound.langIndex;
 
     playSoundFile(filePath);
+    return true;
 }
 
 //---------------------------------------------------------------------------------------
@@ -303,9 +415,53 @@ void AudioWorker::onPlaybackError(QProcess::ProcessError error)
     playNext();
 }
 
+//---------------------------------------------------------------------------------------
+void AudioWorker::onEngineFinished(quint64 playId)
+{
+    if (!m_enginePlays.contains(playId)) {
+        return;
+    }
+
+    const SoundQueueItem finishedSound = m_enginePlays.take(playId);
+
+    qDebug() << "Sound playback finished:"
+             << "sentenceIndex:"
+             << finishedSound.sentenceIndex
+             << "langIndex:"
+             << finishedSound.langIndex;
+
+    emit finishedPlaying(
+        finishedSound.sentenceIndex,
+        finishedSound.langIndex
+        );
+
+    // Level ini bisa kosong -> prompt prioritas lebih rendah boleh mulai
+    playNext();
+}
+
+//---------------------------------------------------------------------------------------
+void AudioWorker::onEngineInterrupted(quint64 playId)
+{
+    // Biasanya sinkron dari AudioEngine::play() / cancelBelow()
+    if (!m_enginePlays.contains(playId)) {
+        return;
+    }
+
+    const SoundQueueItem interruptedSound = m_enginePlays.take(playId);
+
+    emit playbackFailed(
+        interruptedSound.sentenceIndex,
+        interruptedSound.langIndex,
+        QStringLiteral("Dipotong oleh prompt prioritas lebih tinggi")
+        );
+
+    playNext();
+}
+
 //---------------------------------------------------------------------------------------
 void AudioWorker::resetCurrentSound()
 {
     m_currentSound.sentenceIndex = -1;
     m_currentSound.langIndex.clear();
+    m_currentSound.priority = SOUND_PRIORITY_NORMAL;
 }
\ No newline at end of file
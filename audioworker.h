@@ -2,9 +2,14 @@
 #define AUDIOWORKER_H
 
 #include <QObject>
+#include <QHash>
 #include <QQueue>
 #include <QProcess>
 
+#include "promptcache.h"
+
+class AudioEngine;
+
 #define SOUND_FALL_OCCUR 1
 #define SOUND_HELP       2
 #define SOUND_IAM_OK     3
@@ -14,12 +19,33 @@
 #define SOUND_LOGIN      7
 #define SOUND_UPLOAD_FAILED 8
 
+// Prioritas mixer: tinggi memotong / men-duck yang rendah
+#define SOUND_PRIORITY_CHATTER 0    // wait, record, login: dipotong prompt lain
+#define SOUND_PRIORITY_NORMAL  1    // prompt dialog: di-duck saat alarm
+#define SOUND_PRIORITY_ALARM   2    // fall
+#define SOUND_PRIORITY_COUNT   3
+
 struct SoundQueueItem
 {
     int sentenceIndex = -1;
     QString langIndex = "sv";
+    int priority = SOUND_PRIORITY_NORMAL;
 };
 
+/*
+ * Pemutar prompt suara, hidup di audio thread.
+ *
+ * Prompt diputar dari PromptCache (pack mmap atau WAV ter-decode) lewat
+ * mixer AudioEngine (libpulse, satu stream permanen). File yang tidak bisa
+ * di-cache (login.mp3 tanpa pack) atau kalau engine tidak tersedia tetap
+ * lewat paplay (satu proses, tanpa mix).
+ *
+ * Satu queue per prioritas. Prompt dengan prioritas sama diputar berurutan
+ * (disambung tanpa gap oleh mixer); prompt dengan prioritas lebih tinggi
+ * langsung berbunyi, memotong CHATTER dan men-duck NORMAL, dan prompt yang
+ * lebih rendah menunggu sampai yang lebih tinggi selesai. Prompt yang
+ * dipotong dilaporkan lewat playbackFailed.
+ */
 class AudioWorker : public QObject
 {
     Q_OBJECT
@@ -30,7 +56,8 @@ public:
 
 public slots:
     void init();
-    void enqueueSound(int sentenceIndex, QString langIndex);
+    void enqueueSound(int sentenceIndex, QString langIndex);   // prioritas default per prompt
+    void enqueueSoundPriority(int sentenceIndex, QString langIndex, int priority);
 
 signals:
     // Hanya di-emit jika paplay selesai dengan normal.
@@ -53,7 +80,15 @@ private slots:
 
     void onPlaybackError(QProcess::ProcessError error);
 
+    void onEngineFinished(quint64 playId);
+    void onEngineInterrupted(quint64 playId);
+
 private:
+    static int defaultPriority(int sentenceIndex);
+    bool levelBusy(int priority) const;
+    bool higherBusy(int priority) const;
+    bool startHead(int priority);
+
     QString requestToFile(
         int sentenceIndex,
         const QString &langIndex
@@ -64,10 +99,18 @@ private:
 
     QProcess *m_playerProcess = nullptr;
 
-    QQueue<SoundQueueItem> m_queue;
-    SoundQueueItem m_currentSound;
+    PromptCache m_cache;
+    AudioEngine *m_engine = nullptr;
+    quint64 m_nextPlayId = 1;
+    QHash<quint64, SoundQueueItem> m_enginePlays; // voice di mixer: id engine -> item
+
+    QQueue<SoundQueueItem> m_queues[SOUND_PRIORITY_COUNT];
 
+    // Prompt yang sedang diputar paplay
+    SoundQueueItem m_currentSound;
     bool m_isPlaying = false;
+
+    bool m_pumping = false;
 };
 
 #endif // AUDIOWORKER_H
\ No newline at end of file
@@ -1,52 +1,104 @@
 #include "brightness.h"
 #include <QtCore/qdebug.h>
+#include <QMetaObject>
+#include <QThread>
+#include <QTimer>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 
 brightness::brightness(QObject *parent)
     : QObject{parent}
-{}
+{
+    if (!openDevice())
+        qWarning() << "Backlight sysfs tidak tersedia, brightness control nonaktif";
+}
 
 brightness::~brightness(){
+    if (m_fadeThread) {
+        m_fadeThread->quit();
+        m_fadeThread->wait();
+        delete m_fadeTimer;
+        delete m_fadeThread;
+    }
 
+    if (m_fd >= 0)
+        ::close(m_fd);
 }
+
 //------------------------------------------------------------------------
-int brightness::getBrightness()
+bool brightness::openDevice()
 {
-    QProcess proc;
-    proc.start("brightnessctl", {"get"});
-    proc.waitForFinished();
-   // connect(proc, &QProcess::finished, proc, &QObject::deleteLater);
+    QString base = getBacklightBasePath();
+    if (base.isEmpty())
+        return false;
+
+    QFile maxFile(base + "/max_brightness");
+    if (!maxFile.open(QIODevice::ReadOnly)) {
+        qDebug() << "Failed open max_brightness:" << maxFile.errorString();
+        return false;
+    }
 
-    QString output = proc.readAllStandardOutput().trimmed();
     bool ok = false;
-    int value = output.toInt(&ok);
+    m_max = QString(maxFile.readAll()).trimmed().toInt(&ok);
+    if (!ok || m_max <= 0)
+        return false;
+
+    const QByteArray path = QFile::encodeName(base + "/brightness");
+    m_fd = ::open(path.constData(), O_RDWR | O_CLOEXEC);
+    if (m_fd < 0) {
+        qDebug() << "Failed open brightness:" << strerror(errno);
+        return false;
+    }
 
-    if (!ok) {
-        qDebug() << "Failed to parse brightness:" << output;
-        return -1;
+    char buf[16] = {};
+    const ssize_t n = ::pread(m_fd, buf, sizeof(buf) - 1, 0);
+    if (n > 0) {
+        const int raw = QByteArray(buf, int(n)).trimmed().toInt();
+        m_raw.store(raw);
+        m_percent.store((raw * 100) / m_max);
     }
-    return value;
+
+    qDebug() << "Backlight:" << base << "max" << m_max << "current" << m_raw.load();
+    return true;
 }
 
 //------------------------------------------------------------------------
-int brightness::getBrightnessPercent()
+bool brightness::writeRawLocked(int raw)
 {
-    QString base = getBacklightBasePath();
-     if (base.isEmpty()) return -1;
+    if (m_fd < 0)
+        return false;
 
-     QFile maxFile(base + "/max_brightness");
-     QFile valFile(base + "/brightness");
+    raw = qBound(0, raw, m_max);
+    if (raw == m_raw.load(std::memory_order_relaxed))
+        return true;
 
-     if (!maxFile.open(QIODevice::ReadOnly) ||
-         !valFile.open(QIODevice::ReadOnly))
-         return -1;
+    char buf[16];
+    const int len = std::snprintf(buf, sizeof(buf), "%d", raw);
 
-     int maxVal = QString(maxFile.readAll()).trimmed().toInt();
-     int curVal = QString(valFile.readAll()).trimmed().toInt();
+    // sysfs: satu write dari offset 0 = satu nilai
+    if (::pwrite(m_fd, buf, size_t(len), 0) != len) {
+        qDebug() << "Failed write brightness:" << strerror(errno);
+        return false;
+    }
 
-     if (maxVal <= 0) return -1;
+    m_raw.store(raw, std::memory_order_relaxed);
+    return true;
+}
 
-     return (curVal * 100) / maxVal;
+//------------------------------------------------------------------------
+int brightness::getBrightness()
+{
+    return m_raw.load(std::memory_order_relaxed);
+}
 
+//------------------------------------------------------------------------
+int brightness::getBrightnessPercent()
+{
+    return m_percent.load(std::memory_order_relaxed);
 }
 
 //------------------------------------------------------------------------
@@ -54,52 +106,121 @@ bool brightness::setBrightnessPercent(int percent)
 {
     if ((percent < 0) || (percent > 100)){
         return false;
-}
-    QString base = getBacklightBasePath();
-    if (base.isEmpty())
-        return false;
+    }
 
-    QFile maxFile(base + "/max_brightness");
-    if (!maxFile.open(QIODevice::ReadOnly)) {
-        qDebug() << "Failed open max_brightness:" << maxFile.errorString();
-        return false;
+    {
+        QMutexLocker locker(&m_lock);
+        m_fadeClock.invalidate();   // batalkan fade
+
+        if (!writeRawLocked((percent * m_max) / 100))
+            return false;
+
+        m_percent.store(percent, std::memory_order_relaxed);
     }
 
-    bool ok = false;
-    int maxVal = QString(maxFile.readAll()).trimmed().toInt(&ok);
-    maxFile.close();
+    emit brightnessChanged(percent);
+    return true;
+}
 
-    if (!ok || maxVal <= 0)
-        return false;
+//------------------------------------------------------------------------
+bool brightness::setBrightness(int value)
+{
+    if ((value < 0) || (value > m_max)) return false;
 
-    int newVal = (percent * maxVal) / 100;
+    int percent;
+    {
+        QMutexLocker locker(&m_lock);
+        m_fadeClock.invalidate();
 
-    QFile valFile(base + "/brightness");
-    if (!valFile.open(QIODevice::WriteOnly)) {
-        qDebug() << "Failed open brightness:" << valFile.errorString();
-        return false;
-    }
+        if (!writeRawLocked(value))
+            return false;
 
-    valFile.write(QString::number(newVal).toUtf8());
-    valFile.close();
+        percent = (value * 100) / m_max;
+        m_percent.store(percent, std::memory_order_relaxed);
+    }
 
+    emit brightnessChanged(percent);
     return true;
 }
 
+//------------------------------------------------------------------------
+void brightness::ensureFadeThread()
+{
+    if (m_fadeThread)
+        return;
+
+    m_fadeThread = new QThread();
+    m_fadeThread->setObjectName("backlightFade");
 
+    m_fadeTimer = new QTimer();
+    m_fadeTimer->setTimerType(Qt::PreciseTimer);
+    m_fadeTimer->setInterval(FADE_TICK_MS);
+    m_fadeTimer->moveToThread(m_fadeThread);
+
+    // Context = timer, jadi tick berjalan di thread fade
+    connect(m_fadeTimer, &QTimer::timeout, m_fadeTimer, [this]() { fadeTick(); });
+
+    m_fadeThread->start();
+}
 
 //------------------------------------------------------------------------
-bool brightness::setBrightness(int value)
+void brightness::fadeToPercent(int percent, int durationMs)
 {
-    if((value < 0 ) || (value > 255)) return false;
+    if (m_fd < 0)
+        return;
+
+    percent = qBound(0, percent, 100);
+
+    if (durationMs <= FADE_TICK_MS) {
+        setBrightnessPercent(percent);
+        return;
+    }
+
+    ensureFadeThread();
 
-    QProcess proc;
-    proc.start("brightnessctl", {"set", QString::number(value)});
-    proc.waitForFinished();
-   // connect(proc, &QProcess::finished, proc, &QObject::deleteLater);
+    {
+        QMutexLocker locker(&m_lock);
+        m_fadeFromRaw = m_raw.load(std::memory_order_relaxed);
+        m_fadeToRaw = (percent * m_max) / 100;
+        m_fadeToPercent = percent;
+        m_fadeDurationMs = durationMs;
+        m_fadeClock.start();
+    }
+
+    QMetaObject::invokeMethod(m_fadeTimer, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+}
+
+//------------------------------------------------------------------------
+void brightness::fadeTick()
+{
+    int finishedPercent = -1;
+
+    {
+        QMutexLocker locker(&m_lock);
+
+        if (!m_fadeClock.isValid()) {
+            m_fadeTimer->stop();
+            return;
+        }
+
+        const qint64 elapsed = m_fadeClock.elapsed();
+
+        if (elapsed >= m_fadeDurationMs) {
+            writeRawLocked(m_fadeToRaw);
+            m_percent.store(m_fadeToPercent, std::memory_order_relaxed);
+            m_fadeClock.invalidate();
+            m_fadeTimer->stop();
+            finishedPercent = m_fadeToPercent;
+        } else {
+            const int raw = m_fadeFromRaw
+                            + int((qint64(m_fadeToRaw - m_fadeFromRaw) * elapsed) / m_fadeDurationMs);
+            writeRawLocked(raw);
+            m_percent.store((raw * 100) / m_max, std::memory_order_relaxed);
+        }
+    }
 
-    return proc.exitStatus() == QProcess::NormalExit &&
-            proc.exitCode() == 0;
+    if (finishedPercent >= 0)
+        emit brightnessChanged(finishedPercent);
 }
 
 //------------------------------------------------------------------------
@@ -2,11 +2,27 @@
 #define BRIGHTNESS_H
 
 #include <QObject>
-#include <QProcess>
+#include <QElapsedTimer>
+#include <QMutex>
 #include <qdebug.h>
 #include <QFile>
 #include <QDir>
 
+#include <atomic>
+
+class QThread;
+class QTimer;
+
+/*
+ * Driver backlight langsung ke sysfs (/sys/class/backlight/<dev>).
+ *
+ * File "brightness" dibuka sekali dan tetap terbuka; max_brightness dibaca
+ * sekali di constructor. Set = satu pwrite(), get = nilai cache, jadi jalur
+ * alarm jatuh tidak pernah menunggu proses brightnessctl.
+ *
+ * fadeToPercent() berjalan di thread fade sendiri (timer ~60 Hz). Set
+ * langsung (setBrightnessPercent) selalu membatalkan fade yang berjalan.
+ */
 class brightness : public QObject
 {
     Q_OBJECT
@@ -14,15 +30,44 @@ public:
     explicit brightness(QObject *parent = nullptr);
     ~brightness();
 
+    bool isAvailable() const { return m_fd >= 0; }
+
 signals:
+    // Dari thread pemanggil / thread fade (connect ke GUI otomatis queued)
+    void brightnessChanged(int percent);
+
 public slots:
-    int getBrightness();
-    int getBrightnessPercent();
+    int getBrightness();                 // raw (0..max_brightness), -1 kalau tidak ada device
+    int getBrightnessPercent();          // cache 0–100, -1 kalau tidak ada device
     bool setBrightnessPercent(int percent);
     bool setBrightness(int value);
+    void fadeToPercent(int percent, int durationMs);
 
     QString getBacklightBasePath();
 
+private:
+    bool openDevice();
+    bool writeRawLocked(int raw);
+    void fadeTick();
+    void ensureFadeThread();
+
+    int m_fd = -1;
+    int m_max = 0;
+    std::atomic<int> m_raw{-1};
+    std::atomic<int> m_percent{-1};
+
+    // Melindungi write + state fade (GUI thread vs thread fade)
+    QMutex m_lock;
+
+    QThread *m_fadeThread = nullptr;
+    QTimer *m_fadeTimer = nullptr;
+    int m_fadeFromRaw = 0;
+    int m_fadeToRaw = 0;
+    int m_fadeToPercent = 0;
+    int m_fadeDurationMs = 0;
+    QElapsedTimer m_fadeClock;      // invalid = tidak ada fade (set langsung membatalkan)
+
+    static constexpr int FADE_TICK_MS = 16;
 };
 
 #endif // BRIGHTNESS_H
@@ -0,0 +1,185 @@
+#include "commandcoalescer.h"
+
+#include "metrics.h"
+
+#include <QDebug>
+
+//---------------------------------------------------------------------------------------
+CommandCoalescer::CommandCoalescer(QObject *parent)
+    : QObject(parent)
+{
+    for (int i = 0; i < CONTROL_COUNT; ++i) {
+        const Control control = Control(i);
+        Slot &s = m_slots[i];
+
+        s.timer.setSingleShot(true);
+        connect(&s.timer, &QTimer::timeout, this, [this, control]() { flush(control); });
+    }
+}
+
+//---------------------------------------------------------------------------------------
+const char *CommandCoalescer::controlName(Control control)
+{
+    switch (control) {
+    case Control::Volume:     return "volume";
+    case Control::Brightness: return "brightness";
+    case Control::WifiScan:   return "wifi_scan";
+    }
+    return "unknown";
+}
+
+//---------------------------------------------------------------------------------------
+void CommandCoalescer::setActuator(Control control, Apply apply, Current current,
+                                   int minValue, int maxValue, int stepSize, int minIntervalMs)
+{
+    Slot &s = m_slots[int(control)];
+    s.apply = std::move(apply);
+    s.current = std::move(current);
+    s.minValue = minValue;
+    s.maxValue = maxValue;
+    s.stepSize = stepSize;
+    s.minIntervalMs = minIntervalMs;
+}
+
+//---------------------------------------------------------------------------------------
+void CommandCoalescer::setTrigger(Control control, std::function<void()> run,
+                                  int minIntervalMs, int inFlightTimeoutMs)
+{
+    Slot &s = m_slots[int(control)];
+    s.run = std::move(run);
+    s.minIntervalMs = minIntervalMs;
+    s.inFlightTimeoutMs = inFlightTimeoutMs;
+}
+
+//---------------------------------------------------------------------------------------
+void CommandCoalescer::setTarget(Control control, int value)
+{
+    Slot &s = m_slots[int(control)];
+    if (!s.apply)
+        return;
+
+    METRIC_COUNTER("coalescer.received").inc();
+    s.target = qBound(s.minValue, value, s.maxValue);
+    s.pending = true;
+
+    schedule(control);
+}
+
+//---------------------------------------------------------------------------------------
+void CommandCoalescer::step(Control control, int steps)
+{
+    Slot &s = m_slots[int(control)];
+    if (!s.apply || steps == 0)
+        return;
+
+    int base;
+    if (s.pending)
+        base = s.target;
+    else if (s.hasApplied && s.sinceApply.elapsed() < STEP_BASE_HOLD_MS)
+        base = s.lastApplied;
+    else
+        base = s.current ? s.current() : s.lastApplied;
+
+    if (base < 0) {
+        qWarning() << "Coalescer:" << controlName(control) << "current value unavailable, step dropped";
+        return;
+    }
+
+    // Batas hanya berlaku searah step: nilai yang sudah di luar range (slider
+    // lokal / perubahan eksternal) tidak ditarik ke batas oleh step berlawanan.
+    const int delta = steps * s.stepSize;
+    const int target = steps < 0 ? qMax(qMin(base, s.minValue), base + delta)
+                                  : qMin(qMax(base, s.maxValue), base + delta);
+
+    if (target == base) {
+        qDebug() << "Coalescer:" << controlName(control) << "already at limit" << base << ", step dropped";
+        return;
+    }
+
+    METRIC_COUNTER("coalescer.received").inc();
+    s.target = target;
+    s.pending = true;
+
+    schedule(control);
+}
+
+//---------------------------------------------------------------------------------------
+void CommandCoalescer::trigger(Control control)
+{
+    Slot &s = m_slots[int(control)];
+    if (!s.run)
+        return;
+
+    METRIC_COUNTER("coalescer.received").inc();
+
+    // Hasil scan yang sedang berjalan juga menjawab permintaan ini.
+    if (s.inFlight && s.sinceRun.elapsed() < s.inFlightTimeoutMs) {
+        METRIC_COUNTER("coalescer.dropped").inc();
+        return;
+    }
+
+    s.inFlight = false;
+    s.pending = true;
+
+    schedule(control);
+}
+
+//---------------------------------------------------------------------------------------
+void CommandCoalescer::markDone(Control control)
+{
+    m_slots[int(control)].inFlight = false;
+}
+
+//---------------------------------------------------------------------------------------
+void CommandCoalescer::schedule(Control control)
+{
+    Slot &s = m_slots[int(control)];
+
+    if (s.timer.isActive()) {
+        METRIC_COUNTER("coalescer.dropped").inc();
+        return;
+    }
+
+    const qint64 elapsed = s.sinceApply.isValid() ? s.sinceApply.elapsed() : s.minIntervalMs;
+    if (elapsed >= s.minIntervalMs) {
+        flush(control);
+        return;
+    }
+
+    s.timer.start(int(s.minIntervalMs - elapsed));
+}
+
+//---------------------------------------------------------------------------------------
+void CommandCoalescer::flush(Control control)
+{
+    Slot &s = m_slots[int(control)];
+    if (!s.pending)
+        return;
+
+    s.pending = false;
+    s.sinceApply.start();
+
+    METRIC_COUNTER("coalescer.applied").inc();
+
+    if (s.run) {
+        s.inFlight = true;
+        s.sinceRun.start();
+        qDebug() << "Coalescer:" << controlName(control) << "run";
+        s.run();
+        emit applied(control, 0);
+        return;
+    }
+
+    if (s.hasApplied && s.lastApplied == s.target && s.current && s.current() == s.target)
+        return;
+
+    qDebug() << "Coalescer:" << controlName(control) << "apply" << s.target;
+
+    if (s.apply(s.target)) {
+        s.hasApplied = true;
+        s.lastApplied = s.target;
+        emit applied(control, s.target);
+    } else {
+        qWarning() << "Coalescer:" << controlName(control) << "apply failed" << s.target;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef COMMANDCOALESCER_H
+#define COMMANDCOALESCER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+#include <functional>
+
+/*
+ * Penggabung perintah kontrol dari backend (volume, brightness, scan Wi-Fi)
+ * sebelum sampai ke actuator yang mahal (pactl / sysfs / nmcli).
+ *
+ * - setTarget(): simpan target absolut terbaru, yang lama dibuang.
+ * - step(): langkah relatif digabung ke target absolut (basis = target
+ *   pending, nilai terakhir yang diterapkan, atau nilai actuator).
+ * - trigger(): perintah tanpa nilai; selama masih in-flight (belum
+ *   markDone()) trigger baru ikut hasil yang sedang berjalan.
+ *
+ * Actuator dipanggil paling sering sekali per minIntervalMs per kontrol;
+ * target yang datang di antaranya diterapkan di akhir interval.
+ * Hidup di thread GUI (actuator milik MainWindow).
+ */
+class CommandCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Control {
+        Volume = 0,
+        Brightness,
+        WifiScan
+    };
+
+    using Apply = std::function<bool(int value)>;
+    using Current = std::function<int()>;
+
+    explicit CommandCoalescer(QObject *parent = nullptr);
+
+    // Kontrol bernilai (Volume, Brightness)
+    void setActuator(Control control, Apply apply, Current current,
+                     int minValue, int maxValue, int stepSize, int minIntervalMs);
+    // Kontrol trigger (WifiScan); inFlightTimeoutMs: batas kalau markDone() tidak datang
+    void setTrigger(Control control, std::function<void()> run,
+                    int minIntervalMs, int inFlightTimeoutMs);
+
+public slots:
+    void setTarget(Control control, int value);
+    void step(Control control, int steps);
+    void trigger(Control control);
+    void markDone(Control control);
+
+signals:
+    void applied(Control control, int value);
+
+private:
+    struct Slot {
+        Apply apply;
+        Current current;
+        std::function<void()> run;
+
+        int minValue = 0;
+        int maxValue = 100;
+        int stepSize = 1;
+        int minIntervalMs = 0;
+        int inFlightTimeoutMs = 0;
+
+        bool pending = false;
+        int target = 0;
+
+        bool hasApplied = false;
+        int lastApplied = 0;
+        QElapsedTimer sinceApply;
+
+        bool inFlight = false;
+        QElapsedTimer sinceRun;
+
+        QTimer timer;
+    };
+
+    void schedule(Control control);
+    void flush(Control control);
+    static const char *controlName(Control control);
+
+    static constexpr int CONTROL_COUNT = 3;
+    Slot m_slots[CONTROL_COUNT];
+
+    // Dalam jendela ini nilai terakhir yang diterapkan dipakai sebagai basis
+    // step (nilai actuator bisa tertinggal, mis. callback libpulse).
+    static constexpr int STEP_BASE_HOLD_MS = 1000;
+};
+
+#endif // COMMANDCOALESCER_H
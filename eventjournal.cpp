@@ -0,0 +1,558 @@
+#include "eventjournal.h"
+
+#include "metrics.h"
+#include "traceevent.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QThread>
+#include <QtEndian>
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/*
+ * Layout file:
+ *
+ *   header  [0..16)   magic "RSJ1", versi, reserved
+ *   record  24 byte header + payload (padding ke kelipatan 8)
+ *
+ *   record header: magic(4) type(1) reserved(1) crc16(2) len(4) reserved(4) seq(8)
+ *   payload Event: <nama event utf8> '\0' <JSON compact>
+ *   payload Ack  : kosong (seq = seq event yang di-ACK)
+ */
+constexpr quint32 FILE_MAGIC = 0x314A5352; // "RSJ1"
+constexpr quint32 FILE_VERSION = 1;
+constexpr qint64 HEADER_SIZE = 16;
+
+constexpr quint32 REC_MAGIC = 0x31434552;  // "REC1"
+constexpr qint64 REC_HEADER_SIZE = 24;
+
+constexpr quint8 REC_EVENT = 1;
+constexpr quint8 REC_ACK = 2;
+
+qint64 align8(qint64 v)
+{
+    return (v + 7) & ~qint64(7);
+}
+
+quint16 recordCrc(const uchar *header, const char *payload, quint32 len)
+{
+    // CRC dihitung dengan field crc = 0.
+    uchar tmp[REC_HEADER_SIZE];
+    std::memcpy(tmp, header, REC_HEADER_SIZE);
+    tmp[6] = 0;
+    tmp[7] = 0;
+
+    QByteArray buf(reinterpret_cast<const char *>(tmp), REC_HEADER_SIZE);
+    buf.append(payload, len);
+    return qChecksum(QByteArrayView(buf));
+}
+
+// Satu record (header + payload + padding) di dst, mengembalikan ukurannya
+qint64 encodeRecord(uchar *dst, quint8 type, quint64 seq, const QByteArray &payload)
+{
+    const qint64 size = REC_HEADER_SIZE + align8(payload.size());
+
+    std::memset(dst, 0, size_t(size));
+    qToLittleEndian<quint32>(REC_MAGIC, dst);
+    dst[4] = type;
+    qToLittleEndian<quint32>(quint32(payload.size()), dst + 8);
+    qToLittleEndian<quint64>(seq, dst + 16);
+    std::memcpy(dst + REC_HEADER_SIZE, payload.constData(), size_t(payload.size()));
+    qToLittleEndian<quint16>(recordCrc(dst, payload.constData(), quint32(payload.size())), dst + 6);
+
+    return size;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------------------
+EventJournal::EventJournal(const QString &path, QObject *parent)
+    : QObject(parent)
+    , m_path(path)
+{
+    m_syncTimer.setSingleShot(true);
+    m_syncTimer.setInterval(SYNC_INTERVAL_MS);
+    connect(&m_syncTimer, &QTimer::timeout, this, &EventJournal::sync);
+}
+
+//---------------------------------------------------------------------------------------
+EventJournal::~EventJournal()
+{
+    if (m_compactThread)
+        finishCompaction();
+
+    sync();
+    unmapSegment();
+}
+
+//---------------------------------------------------------------------------------------
+bool EventJournal::open()
+{
+    // Crash di tengah compaction: .tmp belum menggantikan journal, jadi journal
+    // lama masih utuh dan .tmp dibuang. Tanpa journal (fallback non-POSIX yang
+    // crash di antara remove dan rename) .tmp yang dipakai.
+    const QString tmpPath = m_path + ".tmp";
+    if (QFile::exists(tmpPath)) {
+        if (QFile::exists(m_path))
+            QFile::remove(tmpPath);
+        else
+            QFile::rename(tmpPath, m_path);
+    }
+
+    m_file.setFileName(m_path);
+
+    if (!mapSegment())
+        return false;
+
+    replay();
+
+    qDebug() << "Event journal opened:" << m_path
+             << "| pending:" << m_live.size()
+             << "| offset:" << m_writeOffset;
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+bool EventJournal::mapSegment()
+{
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Event journal: gagal membuka" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    if (m_file.size() != SEGMENT_SIZE && !m_file.resize(SEGMENT_SIZE)) {
+        qWarning() << "Event journal: gagal resize" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    m_map = m_file.map(0, SEGMENT_SIZE);
+
+    if (!m_map) {
+        qWarning() << "Event journal: mmap gagal" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    if (qFromLittleEndian<quint32>(m_map) != FILE_MAGIC
+        || qFromLittleEndian<quint32>(m_map + 4) != FILE_VERSION) {
+        // File baru / format lain: mulai segment kosong. File baru hasil
+        // resize() sudah nol (sparse); file format lain cukup dinolkan header
+        // dan slot record pertama, replay berhenti di record tanpa magic.
+        // Menolkan seluruh segment berarti menulis 1 MiB ke SD card.
+        std::memset(m_map, 0, size_t(HEADER_SIZE + REC_HEADER_SIZE));
+        qToLittleEndian<quint32>(FILE_MAGIC, m_map);
+        qToLittleEndian<quint32>(FILE_VERSION, m_map + 4);
+        syncRange(0, HEADER_SIZE);
+    }
+
+    m_writeOffset = HEADER_SIZE;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void EventJournal::unmapSegment()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    if (m_file.isOpen())
+        m_file.close();
+
+    m_dirtyFrom = m_dirtyTo = -1;
+}
+
+//---------------------------------------------------------------------------------------
+void EventJournal::replay()
+{
+    qint64 off = HEADER_SIZE;
+    bool torn = false;
+
+    while (off + REC_HEADER_SIZE <= SEGMENT_SIZE) {
+        const uchar *hdr = m_map + off;
+
+        if (qFromLittleEndian<quint32>(hdr) != REC_MAGIC)
+            break;
+
+        const quint8 type = hdr[4];
+        const quint16 crc = qFromLittleEndian<quint16>(hdr + 6);
+        const quint32 len = qFromLittleEndian<quint32>(hdr + 8);
+        const quint64 seq = qFromLittleEndian<quint64>(hdr + 16);
+
+        if (off + REC_HEADER_SIZE + qint64(len) > SEGMENT_SIZE) {
+            torn = true;
+            break;
+        }
+
+        const char *payload = reinterpret_cast<const char *>(hdr + REC_HEADER_SIZE);
+
+        // Record terakhir terpotong (crash / power loss saat menulis).
+        if (recordCrc(hdr, payload, len) != crc) {
+            torn = true;
+            break;
+        }
+
+        if (type == REC_EVENT) {
+            const QByteArray raw(payload, int(len));
+            const int sep = raw.indexOf('\0');
+
+            if (sep > 0)
+                m_live.insert(seq, LiveRecord{raw.left(sep), raw.mid(sep + 1)});
+        } else if (type == REC_ACK) {
+            m_live.remove(seq);
+        }
+
+        m_nextSeq = qMax(m_nextSeq, seq + 1);
+        off += REC_HEADER_SIZE + align8(len);
+    }
+
+    if (torn) {
+        qWarning() << "Event journal: record rusak di offset" << off << ", sisa segment dikosongkan";
+        std::memset(m_map + off, 0, size_t(SEGMENT_SIZE - off));
+        syncRange(off, SEGMENT_SIZE);
+    }
+
+    m_writeOffset = off;
+}
+
+//---------------------------------------------------------------------------------------
+bool EventJournal::writeRecord(quint8 type, quint64 seq, const QByteArray &payload)
+{
+    const qint64 size = REC_HEADER_SIZE + align8(payload.size());
+
+    if (!m_map || m_writeOffset + size > SEGMENT_SIZE)
+        return false;
+
+    encodeRecord(m_map + m_writeOffset, type, seq, payload);
+
+    if (m_dirtyFrom < 0)
+        m_dirtyFrom = m_writeOffset;
+
+    m_writeOffset += size;
+    m_dirtyTo = m_writeOffset;
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+quint64 EventJournal::append(const QString &eventName, const QJsonObject &data, bool durable)
+{
+    if (!m_map)
+        return 0;
+
+    TRACE_SCOPE("journal.append");
+
+    LiveRecord rec{eventName.toUtf8(), QJsonDocument(data).toJson(QJsonDocument::Compact)};
+    const QByteArray payload = rec.name + '\0' + rec.json;
+
+    if (m_writeOffset + REC_HEADER_SIZE + align8(payload.size()) > SEGMENT_SIZE) {
+        compact();
+
+        if (m_writeOffset + REC_HEADER_SIZE + align8(payload.size()) > SEGMENT_SIZE) {
+            qWarning() << "Event journal penuh, event tidak dijournal:" << eventName;
+            METRIC_COUNTER("journal.full").inc();
+            return 0;
+        }
+    }
+
+    const quint64 seq = m_nextSeq++;
+
+    if (!writeRecord(REC_EVENT, seq, payload))
+        return 0;
+
+    m_live.insert(seq, rec);
+    METRIC_COUNTER("journal.appended").inc();
+
+    maybeCompact();
+
+    // Durable: sekalian sync record non-durable yang belum di-msync.
+    if (durable) {
+        sync();
+    } else if (!m_syncTimer.isActive()) {
+        m_syncTimer.start();
+    }
+
+    return seq;
+}
+
+//---------------------------------------------------------------------------------------
+void EventJournal::acknowledge(quint64 seq)
+{
+    if (!m_map || m_live.remove(seq) == 0)
+        return;
+
+    // Segment penuh: event ini sudah tidak ikut di snapshot compaction.
+    if (!writeRecord(REC_ACK, seq, QByteArray())) {
+        startCompaction();
+        return;
+    }
+
+    maybeCompact();
+
+    // ACK yang hilang saat power loss hanya berarti event dikirim ulang.
+    if (!m_syncTimer.isActive())
+        m_syncTimer.start();
+}
+
+//---------------------------------------------------------------------------------------
+QVector<EventJournal::Entry> EventJournal::pendingEntries() const
+{
+    QVector<Entry> entries;
+    entries.reserve(m_live.size());
+
+    for (auto it = m_live.cbegin(); it != m_live.cend(); ++it) {
+        Entry e;
+        e.seq = it.key();
+        e.eventName = QString::fromUtf8(it->name);
+        e.data = QJsonDocument::fromJson(it->json).object();
+        entries.append(e);
+    }
+
+    return entries;
+}
+
+//---------------------------------------------------------------------------------------
+void EventJournal::maybeCompact()
+{
+    // Segment hampir penuh dan compaction membebaskan cukup ruang (event yang
+    // masih hidup setelah compaction terakhir mulai dari m_compactedOffset),
+    // atau semua sudah di-ACK dan segment terpakai separuh.
+    const bool nearlyFull = m_writeOffset > COMPACT_THRESHOLD
+                            && m_writeOffset - m_compactedOffset > (SEGMENT_SIZE - m_compactedOffset) / 2;
+    const bool allAcked = m_live.isEmpty() && m_writeOffset > SEGMENT_SIZE / 2;
+
+    if (nearlyFull || allAcked)
+        startCompaction();
+}
+
+//---------------------------------------------------------------------------------------
+void EventJournal::startCompaction()
+{
+    if (m_compactThread || !m_map)
+        return;
+
+    const QString tmpPath = m_path + ".tmp";
+    const QMap<quint64, LiveRecord> snapshot = m_live;
+
+    m_compactSnapshot = snapshot;
+    m_compactLastSeq = m_nextSeq - 1;
+    m_compactOffset = -1;
+
+    // Thread hanya memakai salinan (implicit sharing QMap / QByteArray aman
+    // lintas thread); m_compactOffset dibaca setelah wait().
+    QThread *thread = QThread::create([this, tmpPath, snapshot]() {
+        m_compactOffset = writeSegment(tmpPath, snapshot);
+    });
+
+    connect(thread, &QThread::finished, this, [this, thread]() {
+        // Sudah diselesaikan sinkron oleh compact()
+        if (thread == m_compactThread)
+            finishCompaction();
+    });
+
+    m_compactThread = thread;
+    thread->start(QThread::LowPriority);
+}
+
+//---------------------------------------------------------------------------------------
+bool EventJournal::finishCompaction()
+{
+    if (!m_compactThread)
+        return false;
+
+    TRACE_SCOPE("journal.compact");
+
+    m_compactThread->wait();
+    m_compactThread->deleteLater();
+    m_compactThread = nullptr;
+
+    const QString tmpPath = m_path + ".tmp";
+    QMap<quint64, LiveRecord> snapshot;
+    snapshot.swap(m_compactSnapshot);
+
+    // Kembali ke journal lama (masih utuh di disk sampai rename)
+    auto restore = [this, &tmpPath]() {
+        QFile::remove(tmpPath);
+        m_file.setFileName(m_path);
+        if (mapSegment())
+            replay();
+    };
+
+    if (m_compactOffset < 0) {
+        qWarning() << "Event journal: compaction gagal menulis" << tmpPath;
+        QFile::remove(tmpPath);
+        return false;
+    }
+
+    sync();
+    unmapSegment();
+
+    m_file.setFileName(tmpPath);
+
+    if (!mapSegment()) {
+        restore();
+        return false;
+    }
+
+    m_writeOffset = m_compactOffset;
+
+    // Susulkan perubahan selama thread bekerja: ACK untuk event snapshot yang
+    // sudah terkirim, record untuk event yang di-append setelah snapshot.
+    bool caughtUp = true;
+
+    for (auto it = snapshot.cbegin(); caughtUp && it != snapshot.cend(); ++it) {
+        if (!m_live.contains(it.key()))
+            caughtUp = writeRecord(REC_ACK, it.key(), QByteArray());
+    }
+
+    for (auto it = std::as_const(m_live).upperBound(m_compactLastSeq); caughtUp && it != m_live.cend(); ++it)
+        caughtUp = writeRecord(REC_EVENT, it.key(), it->name + '\0' + it->json);
+
+    if (!caughtUp) {
+        qWarning() << "Event journal: segment hasil compaction penuh";
+        unmapSegment();
+        restore();
+        return false;
+    }
+
+    const qint64 offset = m_writeOffset;
+
+    sync();
+    unmapSegment();
+
+    if (!replaceFile(tmpPath, m_path)) {
+        qWarning() << "Event journal: gagal rename" << tmpPath;
+        restore();
+        return false;
+    }
+
+    m_file.setFileName(m_path);
+
+    if (!mapSegment())
+        return false;
+
+    m_writeOffset = offset;
+    m_compactedOffset = offset;
+
+    METRIC_COUNTER("journal.compactions").inc();
+    qDebug() << "Event journal compacted | pending:" << m_live.size() << "| offset:" << offset;
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+bool EventJournal::compact()
+{
+    // Segment penuh: tunggu compaction yang sedang jalan, atau jalankan sekarang
+    startCompaction();
+    return finishCompaction();
+}
+
+//---------------------------------------------------------------------------------------
+qint64 EventJournal::writeSegment(const QString &path, const QMap<quint64, LiveRecord> &records)
+{
+    // Jalan di thread compaction: hanya argumen, tanpa member / mapping.
+    QByteArray buf(HEADER_SIZE, '\0');
+    qToLittleEndian<quint32>(FILE_MAGIC, buf.data());
+    qToLittleEndian<quint32>(FILE_VERSION, buf.data() + 4);
+
+    for (auto it = records.cbegin(); it != records.cend(); ++it) {
+        const QByteArray payload = it->name + '\0' + it->json;
+        const qint64 at = buf.size();
+        const qint64 size = REC_HEADER_SIZE + align8(payload.size());
+
+        if (at + size > SEGMENT_SIZE)
+            return -1;
+
+        buf.resize(at + size);
+        encodeRecord(reinterpret_cast<uchar *>(buf.data()) + at, REC_EVENT, it.key(), payload);
+    }
+
+    QFile::remove(path);
+
+    // Sisa segment dibuat lewat resize(): sparse, tidak ditulis ke SD card
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(buf) != buf.size() || !file.resize(SEGMENT_SIZE)
+        || !file.flush()) {
+        return -1;
+    }
+
+#ifdef Q_OS_UNIX
+    if (::fsync(file.handle()) != 0)
+        return -1;
+#endif
+
+    return buf.size();
+}
+
+//---------------------------------------------------------------------------------------
+bool EventJournal::replaceFile(const QString &from, const QString &to)
+{
+#ifdef Q_OS_UNIX
+    // rename() atomik menimpa journal lama: setelah crash yang ada selalu
+    // journal lama atau segment baru, tidak pernah keduanya hilang. Direktori
+    // di-fsync supaya entry hasil rename sendiri tahan power loss.
+    if (::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) != 0)
+        return false;
+
+    const int dirFd = ::open(QFile::encodeName(QFileInfo(to).absolutePath()).constData(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        if (::fsync(dirFd) != 0)
+            qWarning() << "Event journal: fsync direktori gagal";
+        ::close(dirFd);
+    }
+
+    return true;
+#else
+    QFile::remove(to);
+    return QFile::rename(from, to);
+#endif
+}
+
+//---------------------------------------------------------------------------------------
+void EventJournal::sync()
+{
+    if (m_dirtyFrom < 0)
+        return;
+
+    syncRange(m_dirtyFrom, m_dirtyTo);
+}
+
+//---------------------------------------------------------------------------------------
+void EventJournal::syncRange(qint64 from, qint64 to)
+{
+    if (!m_map || to <= from)
+        return;
+
+    TRACE_SCOPE("journal.msync");
+
+#ifdef Q_OS_UNIX
+    // msync butuh alamat yang align ke page.
+    const qint64 page = qint64(::sysconf(_SC_PAGESIZE));
+    const qint64 start = from & ~(page - 1);
+
+    if (::msync(m_map + start, size_t(to - start), MS_SYNC) != 0)
+        qWarning() << "Event journal: msync gagal";
+#endif
+
+    METRIC_COUNTER("journal.syncs").inc();
+
+    // Range dirty yang sudah tercakup tidak perlu di-sync lagi oleh timer.
+    if (m_dirtyFrom >= 0 && from <= m_dirtyFrom && to >= m_dirtyTo)
+        m_dirtyFrom = m_dirtyTo = -1;
+}
@@ -0,0 +1,107 @@
+#ifndef EVENTJOURNAL_H
+#define EVENTJOURNAL_H
+
+#include <QFile>
+#include <QJsonObject>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class QThread;
+
+/*
+ * Journal append-only untuk event outbound SocketIOClient.
+ *
+ * Satu file segment berukuran tetap yang di-mmap. Setiap event ditulis
+ * sebagai record (seq, nama event, JSON) sebelum enqueueEvent() kembali,
+ * dan dihapus secara logis dengan record ACK setelah event terkirim /
+ * di-ACK server. Saat startup record tanpa ACK dibaca ulang (replay).
+ *
+ * Durability:
+ * - Tulisan ke mmap langsung ada di page cache -> aman kalau proses crash.
+ * - append(..., durable=true) langsung msync (event insiden, tahan power loss).
+ * - Record lain di-msync batch oleh timer (SYNC_INTERVAL_MS) supaya SD card
+ *   tidak ditulis per event telemetry.
+ *
+ * Segment baru tidak pernah dinolkan: file hasil resize() sudah sparse dan
+ * berisi nol, jadi yang ditulis ke SD card hanya header dan record.
+ *
+ * Compaction (record yang masih hidup disalin ke segment baru lalu file lama
+ * diganti) jalan di thread terpisah begitu segment terisi COMPACT_THRESHOLD.
+ * Di thread GUI hanya tersisa menyusulkan record yang berubah selama thread
+ * bekerja, rename dan fsync direktori. Compaction sinkron hanya kalau segment
+ * sudah penuh sebelum compaction di belakang selesai.
+ */
+class EventJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        quint64 seq = 0;
+        QString eventName;
+        QJsonObject data;
+    };
+
+    explicit EventJournal(const QString &path, QObject *parent = nullptr);
+    ~EventJournal();
+
+    bool open();
+    bool isOpen() const { return m_map != nullptr; }
+
+    // Mengembalikan seq (> 0), atau 0 kalau journal tidak aktif / gagal.
+    quint64 append(const QString &eventName, const QJsonObject &data, bool durable);
+    void acknowledge(quint64 seq);
+
+    // Event yang belum di-ACK, urut seq (hasil replay + append setelahnya).
+    QVector<Entry> pendingEntries() const;
+    int pendingCount() const { return m_live.size(); }
+
+    void sync();
+
+    static constexpr qint64 SEGMENT_SIZE = 1024 * 1024;
+    static constexpr qint64 COMPACT_THRESHOLD = SEGMENT_SIZE * 3 / 4;
+    static constexpr int SYNC_INTERVAL_MS = 1000;
+
+private:
+    struct LiveRecord {
+        QByteArray name;
+        QByteArray json;
+    };
+
+    bool mapSegment();
+    void unmapSegment();
+    void replay();
+    bool writeRecord(quint8 type, quint64 seq, const QByteArray &payload);
+    void maybeCompact();
+    void startCompaction();
+    bool finishCompaction();
+    bool compact();
+    static qint64 writeSegment(const QString &path, const QMap<quint64, LiveRecord> &records);
+    static bool replaceFile(const QString &from, const QString &to);
+    void syncRange(qint64 from, qint64 to);
+
+    QString m_path;
+    QFile m_file;
+    uchar *m_map = nullptr;
+
+    qint64 m_writeOffset = 0;
+    qint64 m_dirtyFrom = -1;   // range yang belum di-msync
+    qint64 m_dirtyTo = -1;
+
+    quint64 m_nextSeq = 1;
+    QMap<quint64, LiveRecord> m_live;
+
+    // Compaction di belakang: snapshot m_live saat thread mulai
+    QThread *m_compactThread = nullptr;
+    QMap<quint64, LiveRecord> m_compactSnapshot;
+    quint64 m_compactLastSeq = 0;
+    qint64 m_compactOffset = -1;    // hasil thread, dibaca setelah wait()
+    qint64 m_compactedOffset = 0;   // offset setelah compaction terakhir
+
+    QTimer m_syncTimer;
+};
+
+#endif // EVENTJOURNAL_H
@@ -0,0 +1,155 @@
+#include "falllatency.h"
+
+#include "metrics.h"
+#include "traceevent.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+//---------------------------------------------------------------------------------------
+FallLatencyTracker &FallLatencyTracker::instance()
+{
+    static FallLatencyTracker tracker;
+    return tracker;
+}
+
+//---------------------------------------------------------------------------------------
+const char *FallLatencyTracker::stageName(Stage stage)
+{
+    switch (stage) {
+    case UartRx:   return "uart_rx";
+    case Decision: return "decision";
+    case Emit:     return "emit";
+    case Gui:      return "gui";
+    case Enqueue:  return "enqueue";
+    case Send:     return "send";
+    case Ack:      return "ack";
+    default:       return "unknown";
+    }
+}
+
+//---------------------------------------------------------------------------------------
+quint64 FallLatencyTracker::begin(qint64 uartRxNs, qint64 decisionNs)
+{
+    const qint64 now = trace::nowNs();
+
+    quint64 id;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        id = m_nextId++;
+        m_currentId = id;
+        m_ts.fill(0);
+    }
+
+    mark(id, UartRx, uartRxNs > 0 ? uartRxNs : now);
+    mark(id, Decision, decisionNs > 0 ? decisionNs : now);
+    mark(id, Emit, now);
+
+    TRACE_INSTANT("fall.begin", qint64(id));
+    return id;
+}
+
+//---------------------------------------------------------------------------------------
+void FallLatencyTracker::mark(quint64 id, Stage stage)
+{
+    mark(id, stage, trace::nowNs());
+}
+
+//---------------------------------------------------------------------------------------
+void FallLatencyTracker::mark(quint64 id, Stage stage, qint64 ns)
+{
+    if (stage < 0 || stage >= StageCount)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    // Alarm lama (sudah diganti alarm baru) atau stage sudah tercatat.
+    if (id == 0 || id != m_currentId || m_ts[stage] != 0)
+        return;
+
+    m_ts[stage] = ns;
+
+    // Selisih terhadap stage sebelumnya yang sudah tercatat.
+    for (int prev = int(stage) - 1; prev >= 0; --prev) {
+        if (m_ts[prev] == 0)
+            continue;
+
+        const qint64 deltaUs = std::max<qint64>(0, (ns - m_ts[prev]) / 1000);
+        const QString name = QStringLiteral("fall.%1_us").arg(stageName(stage));
+        metrics::Registry::instance().histogram(name).record(quint64(deltaUs));
+        break;
+    }
+
+    if (stage == Send && m_ts[UartRx] != 0)
+        METRIC_HISTOGRAM("fall.uart_to_send_us").record(quint64(std::max<qint64>(0, (ns - m_ts[UartRx]) / 1000)));
+
+    if (stage == Ack)
+        complete();
+}
+
+//---------------------------------------------------------------------------------------
+void FallLatencyTracker::complete()
+{
+    // m_mutex sudah dipegang oleh mark().
+    if (m_ts[UartRx] != 0 && m_ts[Ack] != 0)
+        METRIC_HISTOGRAM("fall.total_us").record(quint64(std::max<qint64>(0, (m_ts[Ack] - m_ts[UartRx]) / 1000)));
+
+    m_last = breakdown(m_ts);
+
+    qDebug() << "Fall alarm latency breakdown:" << m_last;
+}
+
+//---------------------------------------------------------------------------------------
+quint64 FallLatencyTracker::currentId() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_currentId;
+}
+
+//---------------------------------------------------------------------------------------
+QJsonObject FallLatencyTracker::breakdown(const std::array<qint64, StageCount> &ts) const
+{
+    QJsonObject obj;
+    const qint64 base = ts[UartRx];
+
+    for (int s = 0; s < StageCount; ++s) {
+        // Offset ms relatif ke UART rx, -1 kalau stage belum tercapai.
+        obj[stageName(Stage(s))] = (ts[s] != 0 && base != 0)
+                                       ? double(ts[s] - base) / 1e6
+                                       : -1.0;
+    }
+
+    return obj;
+}
+
+//---------------------------------------------------------------------------------------
+QJsonObject FallLatencyTracker::lastBreakdown() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_last;
+}
+
+//---------------------------------------------------------------------------------------
+QJsonObject FallLatencyTracker::report() const
+{
+    QJsonObject obj;
+    {
+        QMutexLocker locker(&m_mutex);
+        obj["last_ms"] = m_last;           // alarm terakhir yang sudah di-ACK
+        obj["current_ms"] = breakdown(m_ts); // alarm terbaru, mungkin belum lengkap
+    }
+
+    QJsonObject hist;
+    for (int s = Decision; s < StageCount; ++s) {
+        const QString name = QStringLiteral("fall.%1_us").arg(stageName(Stage(s)));
+        hist[name] = metrics::Registry::instance().histogram(name).toJson();
+    }
+    hist["fall.uart_to_send_us"] = METRIC_HISTOGRAM("fall.uart_to_send_us").toJson();
+    hist["fall.total_us"] = METRIC_HISTOGRAM("fall.total_us").toJson();
+
+    obj["histograms"] = hist;
+    return obj;
+}
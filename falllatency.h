@@ -0,0 +1,67 @@
+#ifndef FALLLATENCY_H
+#define FALLLATENCY_H
+
+#include <QJsonObject>
+#include <QMutex>
+#include <QtGlobal>
+
+#include <array>
+
+/*
+ * Timestamp per hop untuk satu alarm jatuh, dari byte UART sampai ACK server:
+ *
+ *   UartRx   PayloadProcessor::readData (chunk yang memicu keputusan)
+ *   Decision decisionFall / laporan fall dari firmware radar
+ *   Emit     tepat sebelum emit fallDetected
+ *   Gui      lambda fallDetected di MainWindow (setelah hop antar thread)
+ *   Enqueue  SocketIOClient::enqueueEvent
+ *   Send     sendTextMessage pertama di processEventQueue
+ *   Ack      ACK Socket.IO event reliable / onIncidentAckFallEventDetected
+ *
+ * Semua timestamp memakai clock monotonic yang sama (trace::nowNs()), jadi
+ * selisih antar thread valid. Saat Ack masuk, selisih tiap stage direkam ke
+ * histogram "fall.<stage>_us" di registry metrics.
+ */
+class FallLatencyTracker
+{
+public:
+    enum Stage {
+        UartRx = 0,
+        Decision,
+        Emit,
+        Gui,
+        Enqueue,
+        Send,
+        Ack,
+        StageCount
+    };
+
+    static FallLatencyTracker &instance();
+
+    // Dipanggil dari thread radar. Mengembalikan id alarm (selalu > 0).
+    quint64 begin(qint64 uartRxNs, qint64 decisionNs);
+
+    // Stage hanya dicatat sekali (retry tidak menimpa timestamp pertama).
+    void mark(quint64 id, Stage stage);
+    void mark(quint64 id, Stage stage, qint64 ns);
+
+    quint64 currentId() const;
+    QJsonObject lastBreakdown() const;
+    QJsonObject report() const;
+
+    static const char *stageName(Stage stage);
+
+private:
+    FallLatencyTracker() = default;
+
+    void complete();
+    QJsonObject breakdown(const std::array<qint64, StageCount> &ts) const;
+
+    mutable QMutex m_mutex;
+    quint64 m_nextId = 1;
+    quint64 m_currentId = 0;
+    std::array<qint64, StageCount> m_ts{};
+    QJsonObject m_last;
+};
+
+#endif // FALLLATENCY_H
@@ -0,0 +1,89 @@
+#include "imaadpcm.h"
+
+#include <algorithm>
+
+namespace adpcm {
+
+namespace {
+
+constexpr qint8 INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+constexpr qint16 STEP_TABLE[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+inline quint8 encodeSample(int sample, int &predictor, int &index)
+{
+    int step = STEP_TABLE[index];
+    int diff = sample - predictor;
+    quint8 nibble = 0;
+
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+
+    // Rekonstruksi persis seperti decoder supaya predictor tidak drift
+    int delta = step >> 3;
+
+    if (diff >= step) {
+        nibble |= 4;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+
+    if (diff >= step) {
+        nibble |= 2;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+
+    if (diff >= step) {
+        nibble |= 1;
+        delta += step;
+    }
+
+    predictor += (nibble & 8) ? -delta : delta;
+    predictor = std::clamp(predictor, -32768, 32767);
+
+    index = std::clamp(index + INDEX_TABLE[nibble], 0, 88);
+
+    return nibble;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------------------
+void encode(const qint16 *in, int n, State &state, uchar *out)
+{
+    int predictor = state.predictor;
+    int index = state.stepIndex;
+
+    int i = 0;
+    for (; i + 1 < n; i += 2) {
+        const quint8 lo = encodeSample(in[i], predictor, index);
+        const quint8 hi = encodeSample(in[i + 1], predictor, index);
+        *out++ = uchar(lo | (hi << 4));
+    }
+
+    if (i < n)
+        *out = encodeSample(in[i], predictor, index);
+
+    state.predictor = qint16(predictor);
+    state.stepIndex = quint8(index);
+}
+
+} // namespace adpcm
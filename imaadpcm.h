@@ -0,0 +1,28 @@
+#ifndef IMAADPCM_H
+#define IMAADPCM_H
+
+#include <QtGlobal>
+
+/*
+ * Encoder IMA ADPCM 4 bit (DVI / WAV format 0x11), 4:1 terhadap PCM 16 bit.
+ *
+ * Encoder inkremental: State dibawa antar pemanggilan, jadi stream bisa
+ * di-encode per chunk. Dengan menyimpan State di awal chunk (predictor +
+ * stepIndex) tiap chunk bisa di-decode sendiri tanpa chunk sebelumnya.
+ * Packing: dua sampel per byte, sampel pertama di nibble bawah.
+ */
+namespace adpcm {
+
+struct State {
+    qint16 predictor = 0;
+    quint8 stepIndex = 0;
+};
+
+inline int encodedSize(int samples) { return (samples + 1) / 2; }
+
+// out minimal encodedSize(n) byte; nibble atas byte terakhir 0 kalau n ganjil
+void encode(const qint16 *in, int n, State &state, uchar *out);
+
+} // namespace adpcm
+
+#endif // IMAADPCM_H
@@ -3,7 +3,12 @@
 
 #include "bme280worker.h"
 #include "configmanager.h"
+#include "falllatency.h"
 #include "cputemperatureworker.h"
+#include "metrics.h"
+#include "pcmutils.h"
+#include "telemetrycodec.h"
+#include "traceevent.h"
 
 #include <QDebug>
 #include <QElapsedTimer>
@@ -29,18 +34,47 @@ MainWindow::MainWindow(QWidget *parent)
     qDebug() << "Begin Setup";
     lang = "en";
     fallEmergency = false;
+    fallEventAckReceived = false;
 
-    initSound();
-    initMicControl();
-    initGraphics();
-    initSocketIO();
-    initRadar();
-    initBME280();
-    initCpuTemp();
-    initPzem();
-    initUtility();
+    /*
+     * Urutan init berbasis dependency.
+     *
+     * Critical : jalur radar + alarm (LED/backlight, mic mute, suara, Socket.IO, radar).
+     *            Dijalankan langsung di constructor.
+     * Deferred : plot, Wi-Fi/systemd, sensor, PZEM, health info, monitor mic.
+     *            Dijalankan lewat event loop setelah window tampil.
+     */
+    using Phase = StartupProfiler::Phase;
+    m_startup = new StartupProfiler(this);
+
+    m_startup->addStage("utility", Phase::Critical, {}, [this]() { initUtility(); });
+    m_startup->addStage("micControl", Phase::Critical, {}, [this]() { initMicControl(); });
+    m_startup->addStage("sound", Phase::Critical, {"micControl"}, [this]() { initSound(); });
+    m_startup->addStage("socketIO", Phase::Critical, {"utility"}, [this]() { initSocketIO(); });
+    m_startup->addStage("radar", Phase::Critical, {"utility", "sound", "socketIO"}, [this]() {
+        initRadar();
+    });
+
+    m_startup->addStage("graphics", Phase::Deferred, {}, [this]() { initGraphics(); });
+    m_startup->addStage("networkUtility", Phase::Deferred, {"socketIO"}, [this]() {
+        initNetworkUtility();
+    });
+    m_startup->addStage("bme280", Phase::Deferred, {}, [this]() { initBME280(); });
+    m_startup->addStage("cpuTemp", Phase::Deferred, {}, [this]() { initCpuTemp(); });
+    m_startup->addStage("pzem", Phase::Deferred, {}, [this]() { initPzem(); });
+    m_startup->addStage("healthInfo", Phase::Deferred, {"bme280", "cpuTemp", "pzem"}, [this]() {
+        initHealthInfo();
+    });
+    m_startup->addStage("micHealth", Phase::Deferred, {"micControl", "socketIO"}, [this]() { initMicHealth(); });
+
+    // Milestone kontrak dicatat setelah stage deferred terakhir selesai di
+    // event loop, bukan saat constructor kembali (event loop belum jalan).
+    connect(m_startup, &StartupProfiler::allStagesFinished, this, [this]() {
+        m_startup->markMilestone("fall monitoring active");
+    });
+
+    m_startup->run();
 
-    fallEventAckReceived = false;
 #ifdef Q_OS_LINUX
     m_gpio->setColor(COLOR_WHITE);
     //requestPWM(15);
@@ -73,7 +107,10 @@ MainWindow::~MainWindow()
     }
 
     if (m_worker) {
-        m_worker->deleteLater();
+        // Worker dihapus lewat QThread::finished (deleteLater di thread-nya)
+        m_worker->stop();
+        m_workerThread->quit();
+        m_workerThread->wait();
         m_worker = nullptr;
     }
 
@@ -176,6 +213,11 @@ void MainWindow::initSound()
 void MainWindow::initSocketIO()
 {
     client = new SocketIOClient();
+    client->setVolumeLevel(m_volCurrent);
+#ifdef Q_OS_LINUX
+    client->setBrightnessLevel(m_brightness->getBrightnessPercent());
+    connect(m_brightness, &brightness::brightnessChanged, client, &SocketIOClient::setBrightnessLevel);
+#endif
 
     connect(client, &SocketIOClient::eventReceived, this, &MainWindow::onSocketEventReceived);
     connect(client, &SocketIOClient::deviceready, this, &MainWindow::getLangCommand);
@@ -188,7 +230,7 @@ void MainWindow::initSocketIO()
     m_worker = new SocketEventWorker();
     m_worker->moveToThread(m_workerThread);
 
-    connect(m_workerThread, &QThread::started, m_worker, &SocketEventWorker::process);
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
 
     // Hubungkan signal worker ke aksi UI / device
     connect(m_worker, &SocketEventWorker::modeListen, this, &MainWindow::onListenStateChanged);
@@ -196,6 +238,13 @@ void MainWindow::initSocketIO()
     connect(m_worker, &SocketEventWorker::modeWaiting, this, &MainWindow::onWaiting);
     connect(m_worker, &SocketEventWorker::modeRecording, this, &MainWindow::onRecording);
     connect(m_worker, &SocketEventWorker::modeUploadFailed, this, &MainWindow::onUploadFailed);
+
+    // Rekaman RECORDING di-stream per chunk; mode apa pun berikutnya menutup sesi
+    m_voiceRecorder = new VoiceRecorder(client, this);
+    for (auto mode : {&SocketEventWorker::modeListen, &SocketEventWorker::modeTalking, &SocketEventWorker::modeWaiting,
+                      &SocketEventWorker::modeUploadFailed, &SocketEventWorker::modeSleep}) {
+        connect(m_worker, mode, m_voiceRecorder, &VoiceRecorder::stop);
+    }
     connect(m_worker, &SocketEventWorker::volumeGetRequested, this, &MainWindow::onVolumeGetRequested);
     connect(m_worker, &SocketEventWorker::volumeSetRequested, this, &MainWindow::onVolumeSetRequested);
     connect(m_worker, &SocketEventWorker::pingDeviceUp, this, &MainWindow::onPingDeviceUpRequested);
@@ -206,10 +255,8 @@ void MainWindow::initSocketIO()
         m_worker, &SocketEventWorker::brightnessSetRequested, this, &MainWindow::onBrightnessSetRequested);
 
     // Add on
-    connect(m_worker, &SocketEventWorker::volumeIncreaseReq, this, &MainWindow::onVolumeIncreaseReq);
-    connect(m_worker, &SocketEventWorker::volumeDecreaseReq, this, &MainWindow::onVolumeDecreaseReq);
-    connect(m_worker, &SocketEventWorker::brightnessIncreaseReq, this, &MainWindow::onBrihtnessIncreaseReq);
-    connect(m_worker, &SocketEventWorker::brightnessDecreaseReq, this, &MainWindow::onBrightnessDecreaseReq);
+    connect(m_worker, &SocketEventWorker::volumeStepReq, this, &MainWindow::onVolumeStepReq);
+    connect(m_worker, &SocketEventWorker::brightnessStepReq, this, &MainWindow::onBrightnessStepReq);
     connect(
         m_worker, &SocketEventWorker::brightnessGetRequested, this, &MainWindow::onBrightnessGetRequested);
 
@@ -243,39 +290,11 @@ void MainWindow::initSocketIO()
     // Get Language current
     connect(m_worker, &SocketEventWorker::langCurrent, this, &MainWindow::onlangCurrent);
 
-    // Wifi
-#ifdef Q_OS_LINUX
-    connect(m_worker, &SocketEventWorker::wifiOn, this, &MainWindow::onWifiOnRequest);   // Async
-    connect(m_worker, &SocketEventWorker::wifiOff, this, &MainWindow::onWifiOffRequest); // Async
-    connect(m_worker,
-            &SocketEventWorker::wifiScanSsidReqReceived,
-            this,
-            &MainWindow::onwifiScanSsidReqReceived); // Async
-
-    // connect(m_worker, &SocketEventWorker::wifiGetSsid,
-    //         this, &MainWindow::onWifiGetSsidRequest);  //Async
-    connect(m_worker, &SocketEventWorker::wifiGetSsid, this, &MainWindow::onWifiGetSsidRequest); // Async
-    connect(m_worker,
-            &SocketEventWorker::wifiSsidListComplete,
-            this,
-            &MainWindow::onWifiSsidListRequestComplete); // Async
-    connect(m_worker, &SocketEventWorker::wifiForget, this, &MainWindow::onWifiForgetRequest);
-    connect(m_worker, &SocketEventWorker::wifiConnect, this, &MainWindow::onWifiConnectRequest); // Async
-    connect(m_worker,
-            &SocketEventWorker::wifiDisconnectCurrentSsid,
-            this,
-            &MainWindow::onWifiDisconnectRequest); // Async
-
-    // Utility
-    connect(m_worker, &SocketEventWorker::rpiRestart, this, &MainWindow::onRpiRestart);
-    connect(m_worker, &SocketEventWorker::rpiShutdown, this, &MainWindow::onRpiShutdown);
-    connect(m_worker, &SocketEventWorker::tzSetReq, this, &MainWindow::onTzSetReq);
-    connect(m_worker, &SocketEventWorker::tzGetReq, this, &MainWindow::onTzGetReq);
+    // Metrics / trace dump on demand
+    connect(m_worker, &SocketEventWorker::metricsInfoRequest, this, &MainWindow::onMetricsInfoReq);
 
-    connect(m_worker, &SocketEventWorker::powerInfoRequest, this, &MainWindow::onPowerInfoReq);
-    connect(m_worker, &SocketEventWorker::audioRadarInfoRequest, this, &MainWindow::onAudioInfoReq);
-
-#endif
+    // Wifi, utility dan health info di-connect oleh stage deferred
+    // (initNetworkUtility / initHealthInfo) setelah objeknya siap.
 
     m_workerThread->start();
 
@@ -293,9 +312,6 @@ void MainWindow::initSocketIO()
     //QJsonObject obj;
     //client->enqueueEvent("LANGUAGE_GET", obj);
     getLangCommand();
-#ifdef Q_OS_LINUX
-    connect(client, &SocketIOClient::connected, this, &MainWindow::onCurrentSSidRequest);
-#endif
 }
 
 // =============================================================================
@@ -310,6 +326,8 @@ void MainWindow::initGraphics()
     setupRealtimeDataMotion2(ui->plottsgram2);
     setupRealtimeDataVelocity2(ui->plottsVelocity2);
     setupPlotRadar2(ui->plotRadar2);
+
+    m_graphicsReady = true;
 }
 
 // -----------------------------------------------------------------------------
@@ -329,9 +347,11 @@ void MainWindow::initRadar()
     m_procB = new PayloadProcessor(UART_PORT1);
     m_procB->moveToThread(m_threadB);
 
-    // Retry send fall event
-    timerSendFallevent = new QTimer(this);
-    connect(timerSendFallevent, &QTimer::timeout, this, &MainWindow::slotTimerSendFallEvent);
+    // Streaming target ke backend, mati sampai diminta lewat RADAR_STREAM_SET
+    m_radarStreamer = new RadarStreamer(client, this);
+    m_radarStreamer->addSource(m_procA, UART_PORT0, 0);
+    m_radarStreamer->addSource(m_procB, UART_PORT1, 1);
+    connect(m_worker, &SocketEventWorker::radarStreamSet, m_radarStreamer, &RadarStreamer::setEnabled);
 
     // Timer counter heartbeat
     timerHeartBeatCounter = new QTimer(this);
@@ -421,8 +441,9 @@ void MainWindow::initRadar()
         // =========================
         // Fall detected event
         // =========================
-        connect(p, &PayloadProcessor::fallDetected, this, [=](const QString &src) {
+        connect(p, &PayloadProcessor::fallDetected, this, [=](const QString &src, quint64 latencyId) {
             Q_UNUSED(src);
+            FallLatencyTracker::instance().mark(latencyId, FallLatencyTracker::Gui);
             // sound.stop();
             // sound.play();
 #ifdef Q_OS_LINUX
@@ -438,10 +459,11 @@ void MainWindow::initRadar()
                 QJsonObject obj;
                 obj["datetime"] = timestamp;
                 fallEventAckReceived = false;
-                client->enqueueEvent("INCIDENT_FALL_EVENT_DETECTED", obj);
+                // Retry + dedup ditangani SocketIOClient sampai ACK server.
+                client->enqueueReliableEvent("INCIDENT_FALL_EVENT_DETECTED", obj, latencyId);
 
                 QJsonObject obj2;
-                client->enqueueEvent("WAKE_UP_BY_FALL_DETECTION",obj2);
+                client->enqueueReliableEvent("WAKE_UP_BY_FALL_DETECTION",obj2);
 
                 // increase brightness
                 if (m_brightness->setBrightnessPercent(90)) {
@@ -453,7 +475,6 @@ void MainWindow::initRadar()
             //} else {
             //    qDebug() << "Socket DC";
             //}
-            timerSendFallevent->start(1000); // Aktifkan send fall event repeat
             soundPlay(SOUND_FALL_OCCUR, lang);
         });
 
@@ -1191,6 +1212,9 @@ void MainWindow::on_btnSetAngle2_clicked()
 // =============================================================================
 void MainWindow::updateRadarPoint(double x, double y)
 {
+    if (!m_graphicsReady)
+        return; // plot belum di-setup (stage deferred)
+
     radarPoint->data()->clear();
     radarPoint->addData(x, y);
 
@@ -1204,6 +1228,9 @@ void MainWindow::init_radar() {}
 // -----------------------------------------------------------------------------
 void MainWindow::updateRadarPoint2(double x, double y)
 {
+    if (!m_graphicsReady)
+        return;
+
     radarPoint2->data()->clear();
     radarPoint2->addData(x, y);
 
@@ -1422,24 +1449,36 @@ void MainWindow::realtimeDataVelocity2(QString value)
 // -----------------------------------------------------------------------------
 void MainWindow::drawRealTimeetsgram(QString motion)
 {
+    if (!m_graphicsReady)
+        return;
+
     realtimeDataSlot(motion);
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::drawRealTimeVelocity(QString velocity)
 {
+    if (!m_graphicsReady)
+        return;
+
     realtimeDataVelocity(velocity);
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::drawRealTimeetsgram2(QString motion)
 {
+    if (!m_graphicsReady)
+        return;
+
     realtimeDataSlot2(motion);
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::drawRealTimeVelocity2(QString velocity)
 {
+    if (!m_graphicsReady)
+        return;
+
     realtimeDataVelocity2(velocity);
 }
 
@@ -1511,6 +1550,9 @@ void MainWindow::soundPlay(int request, const QString &lang)
         client->enqueueEvent("PLAYING_SOUND", obj);
     //}
 
+    // Mic di-unmute setelah semua prompt yang aktif selesai (soundSettled)
+    m_activeSounds++;
+
     /*
      * Delay 500 ms secara non-blocking.
      *
@@ -1524,6 +1566,7 @@ void MainWindow::soundPlay(int request, const QString &lang)
          */
         if (!m_audioThread || !m_audioThread->isRunning() || !m_audioWorker) {
             qWarning() << "Audio worker is no longer running:" << requestName;
+            soundSettled();
             return;
         }
 
@@ -1554,53 +1597,15 @@ QString MainWindow::runCommand(const QString &cmd)
 // -----------------------------------------------------------------------------
 void MainWindow::startRecording()
 {
-    /*
-    qDebug() << "Recording WAV started";
-    recordedDataSize = 0;
-
-    QAudioDevice inputDevice = QMediaDevices::defaultAudioInput();
-
-    QAudioFormat format;
-    format.setSampleRate(44100);
-    format.setChannelCount(1);
-    format.setSampleFormat(QAudioFormat::Int16);
-
-    if (!inputDevice.isFormatSupported(format)) {
-        qDebug() << "⚠️ Using preferred format";
-        format = inputDevice.preferredFormat();
-    }
-
-    audi = new QAudioSource(inputDevice, format, this);
-    audi->setBufferSize(8192);
-
-    file.setFileName("record.wav");
-
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        qDebug() << "❌ File open failed";
+    if (!m_voiceRecorder || m_voiceRecorder->isRecording())
         return;
-    }
-
-    // ✅ Header WAV valid
-    WavHeader header;
-
-    header.numChannels = format.channelCount();
-    header.sampleRate = format.sampleRate();
-    header.bitsPerSample = 16;
-
-    header.byteRate = header.sampleRate * header.numChannels * header.bitsPerSample / 8;
-    header.blockAlign = header.numChannels * header.bitsPerSample / 8;
 
-    header.dataSize = 0;
-    header.fileSize = 36 + header.dataSize;
+    // Mic yang sama dengan audio health test (ReSpeaker), kalau registry sudah siap
+    const QString source = (m_audioDevices && m_audioDevices->isReady()) ? m_audioDevices->preferredSource()
+                                                                       : QString();
 
-    // ✅ Tulis header awal
-    file.write(reinterpret_cast<const char*>(&header), sizeof(WavHeader));
-
-    ioDevice = audi->start();
-
-    connect(ioDevice, &QIODevice::readyRead,
-            this, &MainWindow::handleAudioData);
-*/
+    if (!m_voiceRecorder->start(source))
+        qWarning() << "Voice recording tidak bisa dimulai";
 }
 
 // -----------------------------------------------------------------------------
@@ -1633,30 +1638,8 @@ void MainWindow::handleStateChanged(QAudio::State state)
 // -----------------------------------------------------------------------------
 void MainWindow::stopRecording()
 {
-    /*
-    audi->stop();
-
-    // Update header
-    file.seek(0);
-
-    WavHeader header;
-
-    header.numChannels = 1;
-    header.sampleRate = 44100;
-    header.bitsPerSample = 16;
-
-    header.byteRate = header.sampleRate * header.numChannels * header.bitsPerSample / 8;
-    header.blockAlign = header.numChannels * header.bitsPerSample / 8;
-
-    header.dataSize = recordedDataSize;
-    header.fileSize = 36 + header.dataSize;
-
-    file.write(reinterpret_cast<const char*>(&header), sizeof(WavHeader));
-
-    file.close();
-
-    qDebug() << "Recording stopped, file size:" << recordedDataSize;
-*/
+    if (m_voiceRecorder)
+        m_voiceRecorder->stop();
 }
 
 // -----------------------------------------------------------------------------
@@ -2116,17 +2099,16 @@ void MainWindow::on_btnFallSimulation_clicked()
         QString timestamp = QDateTime::currentDateTime().toString("dd/MM/yyyy HH:mm:ss");
         QJsonObject obj;
         obj["datetime"] = timestamp;
-        client->enqueueEvent("INCIDENT_FALL_EVENT_DETECTED", obj);
+        client->enqueueReliableEvent("INCIDENT_FALL_EVENT_DETECTED", obj);
         fallEventAckReceived = false;
 #ifdef Q_OS_LINUX
         //m_gpio->setColor(COLOR_RED);
         m_gpio->setColor(COLOR_RED); //requestPWM(45);
 #endif
         QJsonObject obj2;
-        client->enqueueEvent("WAKE_UP_BY_FALL_DETECTION",obj2);
+        client->enqueueReliableEvent("WAKE_UP_BY_FALL_DETECTION",obj2);
 
         fallEmergency = true;
-        if(!timerSendFallevent->isActive()) timerSendFallevent->start(1000); // Aktifkan send fall event repeat
         soundPlay(SOUND_FALL_OCCUR, lang);
     //} else {
     //    qDebug() << " Socket DC";
@@ -2199,6 +2181,7 @@ void MainWindow::onRecording()
     //m_gpio->setColor(COLOR_WHITE_BRIGHT);
     if(!fallEmergency) m_gpio->setColor(COLOR_WHITE_BRIGHT); //requestPWM(25);
 #endif
+    startRecording();
 }
 
 // -----------------------------------------------------------------------------
@@ -2216,17 +2199,10 @@ void MainWindow::onVolumeSetRequested(int vt)
 {
     qDebug() << "UI vol Set:" << vt;
     // if (vt > 0 && m_volume->setVolumePercent(vt)) {
-#ifdef Q_OS_LINUX
     vt = (vt*20)/3;
     if(vt < 10) vt = 10;
     if(vt > 95) vt = 95;
-    if (vt > 0) {
-        m_volumeMonitor->setVolumePercent(vt);
-        qDebug() << "UI vol successfully set to" << vt;
-    } else {
-        qDebug() << "fail setVol" << vt;
-    }
-#endif
+    m_commands->setTarget(CommandCoalescer::Control::Volume, vt);
 }
 
 // -----------------------------------------------------------------------------
@@ -2253,12 +2229,8 @@ void MainWindow::onSleepRequested()
     obj["level"] = QString::number(getBright);
     client->enqueueEvent("SLEEP_FRONTEND", obj);
 
-    // Reduce brightness
-    if(m_brightness->setBrightnessPercent(10)){
-        qDebug() << "Success Set brightness " << 1;
-    }else{
-        qDebug() << "Fail Set brightness " << 1;
-    }
+    // Reduce brightness (fade di thread backlight, tidak menahan GUI)
+    m_brightness->fadeToPercent(10, 800);
 
     //REduce led
     //if(!fallEmergency) requestPWM(0);
@@ -2282,11 +2254,7 @@ void MainWindow::onWakeUpRequested()
     client->enqueueEvent("WAKE_UP", obj);
 
     // increase brightness
-    if (m_brightness->setBrightnessPercent(90)) {
-        qDebug() << "Success Set brightness " << 70;
-    } else {
-        qDebug() << "Fail Set brightness " << 70;
-    }
+    m_brightness->fadeToPercent(90, 300);
 
     soundPlay(SOUND_HELPYOU, lang);
 
@@ -2321,18 +2289,11 @@ void MainWindow::onSpeechModuleReady()
 void MainWindow::onBrightnessSetRequested(int bst)
 {
     qDebug() << "Brightness Set:" << bst;
-#ifdef Q_OS_LINUX
     //konversi ke skala 0 - 100
     bst = (bst*20)/3;
     if(bst < 15) bst = 15;
     if(bst > 90) bst = 90;
-    if (bst > 0 && m_brightness->setBrightnessPercent(bst)) {
-        qDebug() << "Brightness successfully set to" << bst;
-        bst = m_brightness->getBrightnessPercent();
-        qDebug() << "prepare emit brightness set ack " << bst;
-        // client->emitEventStringMsg("BRIGHTNESS_GET_ACK",QString::number(bst));
-    }
-#endif
+    m_commands->setTarget(CommandCoalescer::Control::Brightness, bst);
 }
 
 // -----------------------------------------------------------------------------
@@ -2353,39 +2314,19 @@ void MainWindow::onBrightnessGetRequested()
 }
 
 // -----------------------------------------------------------------------------
-void MainWindow::onVolumeIncreaseReq()
+void MainWindow::onVolumeStepReq(int steps)
 {
-    qDebug() << "UI onVolumeIncreaseReq";
-    int currentVol = m_volCurrent; // m_volume->getVolumePercent();
-    currentVol = currentVol + 5;
-    if ((currentVol > 20) && (currentVol <= 99)) {
-        // if(m_volumeMonitor->setVolumePercent(currentVol)){
-#ifdef Q_OS_LINUX
-        m_volumeMonitor->setVolumePercent(currentVol);
-        qDebug() << "UI succes Inc Vol " << currentVol;
-#endif
-    }
-}
-
-// -----------------------------------------------------------------------------
-void MainWindow::onVolumeDecreaseReq()
-{
-    qDebug() << "UI onVolumeDecreaseReq";
-    int currentVol = m_volCurrent; // m_volume->getVolumePercent();
-    currentVol = currentVol - 5;
-    if ((currentVol > 20) && (currentVol <= 99)) {
-        // if(m_volumeMonitor->setVolumePercent(currentVol)){
-#ifdef Q_OS_LINUX
-        m_volumeMonitor->setVolumePercent(currentVol);
-#endif
-        qDebug() << "UI succes Inc Vol " << currentVol;
-    }
+    qDebug() << "UI onVolumeStepReq" << steps;
+    // Step 5%, digabung ke target absolut oleh coalescer
+    m_commands->step(CommandCoalescer::Control::Volume, steps);
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::onVolumeChanged(int percent)
 {
     m_volCurrent = percent;
+    if (client)
+        client->setVolumeLevel(percent);
     ui->hsVol->setValue(percent);
     ui->leVol->setText(QString::number(percent));
 }
@@ -2399,41 +2340,10 @@ void MainWindow::onVolumeChanged(int percent)
 */
 
 // -----------------------------------------------------------------------------
-void MainWindow::onBrihtnessIncreaseReq()
+void MainWindow::onBrightnessStepReq(int steps)
 {
-    qDebug() << "UI onBrihtnessIncreaseReq";
-#ifdef Q_OS_LINUX
-    int currentBrightness = m_brightness->getBrightnessPercent();
-    currentBrightness = currentBrightness + 5;
-    if ((currentBrightness > 20) && (currentBrightness <= 100)) {
-        if (m_brightness->setBrightnessPercent(currentBrightness)) {
-            qDebug() << "UI succes Inc Brightness " << currentBrightness;
-        } else {
-            qDebug() << "UI fail Inc  " << currentBrightness;
-        }
-    } else {
-        qDebug() << "UI fail Inc out of range  " << currentBrightness;
-    }
-#endif
-}
-
-// -----------------------------------------------------------------------------
-void MainWindow::onBrightnessDecreaseReq()
-{
-    qDebug() << "UI onBrightnessDecreaseReq";
-#ifdef Q_OS_LINUX
-    int currentBrightness = m_brightness->getBrightnessPercent();
-    currentBrightness = currentBrightness - 5;
-    if ((currentBrightness > 20) && (currentBrightness <= 100)) {
-        if (m_brightness->setBrightnessPercent(currentBrightness)) {
-            qDebug() << "UI succes Inc Brightness " << currentBrightness;
-        } else {
-            qDebug() << "UI fail Inc v " << currentBrightness;
-        }
-    } else {
-        qDebug() << "UI fail Inc out of range  " << currentBrightness;
-    }
-#endif
+    qDebug() << "UI onBrightnessStepReq" << steps;
+    m_commands->step(CommandCoalescer::Control::Brightness, steps);
 }
 
 // =============================================================================
@@ -2513,6 +2423,9 @@ void MainWindow::onIncidentAckFallEventDetected()
 {
     fallEventAckReceived = true;
     qDebug() << "ACK_FALL_EVENT_DETECTED";
+
+    FallLatencyTracker &latency = FallLatencyTracker::instance();
+    latency.mark(latency.currentId(), FallLatencyTracker::Ack);
 }
 
 // -----------------------------------------------------------------------------
@@ -2550,27 +2463,6 @@ void MainWindow::onIncidentFallCompleted()
 // =============================================================================
 // Timers and language state
 // =============================================================================
-void MainWindow::slotTimerSendFallEvent()
-{
-    if (!fallEventAckReceived) { // Ack belum diterima, ulangi kirim event fall
-        //if (client->isConnected()) {
-            // soundPlay(SOUND_FALL_OCCUR);
-            QString timestamp = QDateTime::currentDateTime().toString("dd/MM/yyyy HH:mm:ss");
-            QJsonObject obj;
-            obj["datetime"] = timestamp;
-            client->enqueueEvent("INCIDENT_FALL_EVENT_DETECTED", obj);
-
-            QJsonObject obj2;
-            client->enqueueEvent("WAKE_UP_BY_FALL_DETECTION",obj2);
-        //} else {
-        //    qDebug() << "Socket DC";
-        //}
-    } else {
-        timerSendFallevent->stop(); // Ack sudah diterima, stop
-    }
-}
-
-// -----------------------------------------------------------------------------
 void MainWindow::slotTimerHeartBeat()
 {
     radar1UartHeartBeatCounter++;
@@ -2612,9 +2504,7 @@ void MainWindow::onwifiScanSsidReqReceived()
 
     client->enqueueEvent("WIFI_SCAN_STARTED", obj);
 
-    qDebug() << "masuk cuk";
-
-    m_utility->nmcliGetWifiListComplete();
+    m_commands->trigger(CommandCoalescer::Control::WifiScan);
 }
 
 // -----------------------------------------------------------------------------
@@ -3083,6 +2973,11 @@ void MainWindow::on_btnPlayIamOK_clicked()
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnScanWifiList_clicked()
 {
+    // m_utility dibuat di stage deferred networkUtility
+    if (!m_utility) {
+        return;
+    }
+
     qDebug() << "SSID List ";
     m_utility->nmcliGetWifiListSSid();
 }
@@ -3090,6 +2985,10 @@ void MainWindow::on_btnScanWifiList_clicked()
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnGetSSID_clicked()
 {
+    if (!m_utility) {
+        return;
+    }
+
     qDebug() << "SSID get ";
     m_utility->nmcliGetSSID();
 }
@@ -3097,6 +2996,10 @@ void MainWindow::on_btnGetSSID_clicked()
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnWifiCon_clicked()
 {
+    if (!m_utility) {
+        return;
+    }
+
     m_utility->nmcliConnectToWiFi("Parametrik 5G-01", "tabassam");
     //    qDebug() << "Sukses";
     //}else{
@@ -3107,36 +3010,60 @@ void MainWindow::on_btnWifiCon_clicked()
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnWifiOff_clicked()
 {
+    if (!m_utility) {
+        return;
+    }
+
     m_utility->nmcliWifiOff();
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnWifiOn_clicked()
 {
+    if (!m_utility) {
+        return;
+    }
+
     m_utility->nmcliWifiOn();
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnForget_clicked()
 {
+    if (!m_utility) {
+        return;
+    }
+
     m_utility->nmcliForgetConnection("Parametrik 5G-01");
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnRestart_clicked()
 {
+    if (!m_utility) {
+        return;
+    }
+
     m_utility->rpiRestart();
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnShutdown_clicked()
 {
+    if (!m_utility) {
+        return;
+    }
+
     m_utility->rpiShutdown();
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnSetTZ_clicked()
 {
+    if (!m_utility) {
+        return;
+    }
+
     if (m_utility->setTimezone("Asia/Jakarta")) {
         // if(m_utility->setTimezone("Europe/Stockholm")){
         qDebug() << "Set TZ to SW OK";
@@ -3353,25 +3280,19 @@ void MainWindow::processBuffer()
 // -----------------------------------------------------------------------------
 double MainWindow::calculateDb(const QByteArray &data)
 {
-    const int16_t *samples = reinterpret_cast<const int16_t *>(data.constData());
-    int sampleCount = data.size() / 2;
+    const int sampleCount = int(data.size() / 2);
 
     if (sampleCount == 0)
         return -60.0;
 
-    double sum = 0.0;
-
-    for (int i = 0; i < sampleCount; i++) {
-        double sample = samples[i] / 32768.0;
-        sum += sample * sample;
-    }
+    const pcm::Levels l = pcm::levels(reinterpret_cast<const qint16 *>(data.constData()), sampleCount);
 
-    double rms = sqrt(sum / sampleCount);
+    const double rms = std::sqrt(l.sumSq / sampleCount);
 
     if (rms < 1e-6)
         return -60.0;
 
-    return 20.0 * log10(rms);
+    return pcm::toDbfs(rms);
 }
 
 // -----------------------------------------------------------------------------
@@ -3554,15 +3475,51 @@ void MainWindow::initUtility()
     //gpioElapsedTimer.start();
     //gpioTimer->start(2);
 
-    m_volume = new volume();
     m_brightness = new brightness();
 
+    // Volume lewat koneksi libpulse yang sama (async, nilai di-cache dari subscribe)
+    m_volumeMonitor = new VolumeMonitor(this);
+    connect(m_volumeMonitor, &VolumeMonitor::volumeChanged, this, &MainWindow::onVolumeChanged);
+#endif
+
+    // Perintah volume/brightness/scan dari backend digabung dulu sebelum ke actuator
+    m_commands = new CommandCoalescer(this);
+#ifdef Q_OS_LINUX
+    m_commands->setActuator(
+        CommandCoalescer::Control::Volume,
+        [this](int v) {
+            return m_volumeMonitor->setVolumePercent(v);
+        },
+        [this]() { return m_volumeMonitor->volumePercent(); },
+        10, 99, 5, 100);
+    m_commands->setActuator(
+        CommandCoalescer::Control::Brightness,
+        [this](int v) { return m_brightness->setBrightnessPercent(v); },
+        [this]() { return m_brightness->getBrightnessPercent(); },
+        15, 100, 5, 50);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+void MainWindow::initNetworkUtility()
+{
+#ifdef Q_OS_LINUX
     m_utility = new utilities();
 
     connect(m_utility, &utilities::wifiConnectResult, this, &MainWindow::onWifiConnected);
     connect(m_utility, &utilities::wifiRadioChanged, this, &MainWindow::onWifiEnabled);
     connect(m_utility, &utilities::wifiForgetResult, this, &MainWindow::onWifiDeleted);
     connect(m_utility, &utilities::wifiListReadyComplete, this, &MainWindow::onWifiSSidListReadyComplete);
+
+    // nmcli --rescan beberapa detik; permintaan scan selama itu ikut hasil yang sama
+    m_commands->setTrigger(
+        CommandCoalescer::Control::WifiScan, [this]() { m_utility->nmcliGetWifiListComplete(); }, 2000, 30000);
+    connect(m_utility, &utilities::wifiListReadyComplete, this, [this]() {
+        m_commands->markDone(CommandCoalescer::Control::WifiScan);
+    });
+    connect(m_utility, &utilities::wifiListReady, this, [this]() {
+        m_commands->markDone(CommandCoalescer::Control::WifiScan);
+    });
     connect(m_utility, &utilities::wifiCurrentInfoReady, this, &MainWindow::onCurrentWifiInfoReady);
     connect(m_utility, &utilities::wifiDisconnectResult, this, &MainWindow::onwifiDisconnectResult);
 
@@ -3584,13 +3541,62 @@ void MainWindow::initUtility()
     });
 
     qDebug() << "End Monitoring setup ";
+
+    // Request Wi-Fi/utility dari backend baru di-route setelah m_utility siap.
+    connect(m_worker, &SocketEventWorker::wifiOn, this, &MainWindow::onWifiOnRequest);   // Async
+    connect(m_worker, &SocketEventWorker::wifiOff, this, &MainWindow::onWifiOffRequest); // Async
+    connect(m_worker,
+            &SocketEventWorker::wifiScanSsidReqReceived,
+            this,
+            &MainWindow::onwifiScanSsidReqReceived); // Async
+
+    // connect(m_worker, &SocketEventWorker::wifiGetSsid,
+    //         this, &MainWindow::onWifiGetSsidRequest);  //Async
+    connect(m_worker, &SocketEventWorker::wifiGetSsid, this, &MainWindow::onWifiGetSsidRequest); // Async
+    connect(m_worker,
+            &SocketEventWorker::wifiSsidListComplete,
+            this,
+            &MainWindow::onWifiSsidListRequestComplete); // Async
+    connect(m_worker, &SocketEventWorker::wifiForget, this, &MainWindow::onWifiForgetRequest);
+    connect(m_worker, &SocketEventWorker::wifiConnect, this, &MainWindow::onWifiConnectRequest); // Async
+    connect(m_worker,
+            &SocketEventWorker::wifiDisconnectCurrentSsid,
+            this,
+            &MainWindow::onWifiDisconnectRequest); // Async
+
+    // Utility
+    connect(m_worker, &SocketEventWorker::rpiRestart, this, &MainWindow::onRpiRestart);
+    connect(m_worker, &SocketEventWorker::rpiShutdown, this, &MainWindow::onRpiShutdown);
+    connect(m_worker, &SocketEventWorker::tzSetReq, this, &MainWindow::onTzSetReq);
+    connect(m_worker, &SocketEventWorker::tzGetReq, this, &MainWindow::onTzGetReq);
+
+    connect(client, &SocketIOClient::connected, this, &MainWindow::onCurrentSSidRequest);
+
+    // Socket.IO bisa saja sudah connect sebelum stage ini jalan.
+    if (client->isConnected())
+        onCurrentSSidRequest();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+void MainWindow::initHealthInfo()
+{
+#ifdef Q_OS_LINUX
+    // Butuh BME280, CPU temp dan PZEM sudah siap.
+    connect(m_worker, &SocketEventWorker::powerInfoRequest, this, &MainWindow::onPowerInfoReq);
+    connect(m_worker, &SocketEventWorker::audioRadarInfoRequest, this, &MainWindow::onAudioInfoReq);
 #endif
 }
 
 // -----------------------------------------------------------------------------
 void MainWindow::initMicControl()
 {
-    m_microphoneControl = new MicrophoneControl(this);
+    // Registry device sekali subscribe; mute/unmute per mode tanpa spawn wpctl
+    m_audioDevices = new AudioDeviceRegistry(this);
+    if (!m_audioDevices->start())
+        qWarning() << "AudioDeviceRegistry tidak aktif";
+
+    m_microphoneControl = new MicrophoneControl(m_audioDevices, this);
 
     connect(m_microphoneControl,
             &MicrophoneControl::statusReceived,
@@ -3617,6 +3623,53 @@ void MainWindow::initMicControl()
 
 }
 
+// -----------------------------------------------------------------------------
+void MainWindow::initMicHealth()
+{
+#ifdef Q_OS_LINUX
+    // Monitor pasif: mic mati / jenuh ketahuan dalam menit, bukan saat test manual berikutnya
+    m_micHealth = new MicHealthMonitor(this);
+
+    connect(m_microphoneControl, &MicrophoneControl::muteChanged, m_micHealth, &MicHealthMonitor::setMicMuted);
+    connect(m_microphoneControl, &MicrophoneControl::statusReceived, m_micHealth, [this](double, bool muted) {
+        m_micHealth->setMicMuted(muted);
+    });
+    connect(m_micHealth, &MicHealthMonitor::stateChanged, this, &MainWindow::onMicHealthChanged);
+
+    // Stream capture yang sama dipakai deteksi benturan / teriakan untuk fusi fall radar
+    m_acoustic = new AcousticEventDetector(this);
+    m_micHealth->setAcousticDetector(m_acoustic);
+    connect(m_acoustic, &AcousticEventDetector::eventDetected, this,
+            [](AcousticEventDetector::Kind kind, double levelDbfs) {
+                qDebug() << "Acoustic event:" << AcousticEventDetector::kindName(kind) << levelDbfs << "dBFS";
+            });
+
+    if (!m_micHealth->start())
+        qWarning() << "MicHealthMonitor tidak aktif";
+#endif
+}
+
+// -----------------------------------------------------------------------------
+void MainWindow::onMicHealthChanged(MicHealthMonitor::State state, const AudioHealthChecker::Report &report)
+{
+    if (!report.ok && state != MicHealthMonitor::State::Unknown)
+        qWarning().noquote() << "Mic health:" << MicHealthMonitor::stateName(state) << report.diagnose.join(' ');
+
+    if (!client || !client->isConnected())
+        return;
+
+    QJsonObject obj;
+    obj["mic_monitor"] = MicHealthMonitor::stateName(state);
+    obj["mic_rms_dbfs"] = report.rmsDbfs;
+    obj["mic_noise_floor_dbfs"] = report.noiseFloorDbfs;
+    obj["mic_peak_dbfs"] = report.peakDbfs;
+    obj["mic_clipping_percent"] = report.clippingPercent;
+    obj["mic_dropout_percent"] = report.dropoutPercent;
+    // Event sendiri (lane control): DEVICE_STATUS_INFO di lane telemetry di-coalesce per
+    // nama event, jadi fault mic bisa tertimpa report audio / radar berikutnya
+    client->enqueueEvent("DEVICE_MIC_HEALTH", obj);
+}
+
 // -----------------------------------------------------------------------------
 void MainWindow::on_btnRec_clicked() {}
 
@@ -3628,7 +3681,8 @@ void MainWindow::on_btnPing_clicked()
 
     // qDebug() << timestampMs;
     // qDebug() << "isooooocukkk " << timestampMs;
-    m_pzem->requestReadAll();
+    if (m_pzem)
+        m_pzem->requestReadAll();
     runAudioHealthRecordTest();
 }
 
@@ -3659,7 +3713,25 @@ void MainWindow::onPzemDataReadyComplete(Pzem004Tv30Data data)
         obj["pf"] = data.powerFactor;
         obj["energy"] = data.energy;
 
-        client->enqueueEvent("DEVICE_POWER_INFO", obj);
+        // Breakdown latency alarm jatuh per hop (ms) + histogram (us)
+        obj["fall_latency"] = FallLatencyTracker::instance().report();
+
+        // Bentuk biner hanya berisi nilai sensor; latency tetap ada di DEVICE_METRICS_INFO.
+        telemetry::PowerSample sample;
+        sample.timestampMs = QDateTime::currentMSecsSinceEpoch();
+        sample.temperatureC = float(mbme280data.temperatureC);
+        sample.pressureHpa = float(mbme280data.pressureHpa);
+        sample.humidityPercent = float(mbme280data.humidityPercent);
+        sample.cpuTemperatureC = float(cpuTempC);
+        sample.voltage = float(data.voltage);
+        sample.current = float(data.current);
+        sample.power = float(data.power);
+        sample.frequency = float(data.frequency);
+        sample.powerFactor = float(data.powerFactor);
+        sample.energy = float(data.energy);
+        sample.alarm = data.alarm;
+
+        client->enqueueTelemetry("DEVICE_POWER_INFO", obj, telemetry::encodePower(sample));
 
         // clear
         mbme280data.temperatureC = 0;
@@ -3686,483 +3758,85 @@ void MainWindow::onAudioInfoReq()
     runAudioHealthRecordTest();
 }
 
-// =============================================================================
-// Audio health test
-// =============================================================================
-void MainWindow::runAudioHealthRecordTest()
+// -----------------------------------------------------------------------------
+void MainWindow::onMetricsInfoReq()
 {
-    getAudioTargetsFromWpctlStatusAsync(
-        [this](const QString &micTarget, const QString &speakerTarget, const QString &targetErr) {
-            if (micTarget.isEmpty() || speakerTarget.isEmpty()) {
-                qWarning().noquote() << "Failed to get audio targets from wpctl status:\n" << targetErr;
-                return;
-            }
-
-            qDebug() << "Using mic target:" << micTarget;
-            qDebug() << "Using speaker target KT USB:" << speakerTarget;
-
-            QProcess *recorder = new QProcess(this);
-            QProcess *player = new QProcess(this);
-
-            QString wavDir = QDir::homePath() + "/wav";
-
-            QString testFileName = wavDir + "/audio_health_test.wav";
-            QString recordFile = wavDir + "/respeaker_testRec.wav";
-
-            QDir().mkpath(wavDir);
-
-            QString err;
-
-            if (!m_audioCheck.createTestWav(testFileName, &err)) {
-                qWarning() << "Create test WAV failed:" << err;
-
-                recorder->deleteLater();
-                player->deleteLater();
-                return;
-            } else {
-                qDebug() << "generate wav test success" << testFileName;
-            }
-
-            QStringList recArgs;
-            recArgs << "10s"
-                    << "pw-record"
-                    << "--target" << micTarget << "--rate" << "16000"
-                    << "--channels" << "1"
-                    << "--format" << "s16" << recordFile;
-
-            recorder->setProgram("timeout");
-            recorder->setArguments(recArgs);
-            recorder->setProcessChannelMode(QProcess::MergedChannels);
-
-            connect(recorder, &QProcess::readyReadStandardOutput, this, [recorder]() {
-                qDebug().noquote() << "[REC]" << recorder->readAllStandardOutput();
-            });
-
-            connect(recorder, &QProcess::started, this, []() {
-                qDebug() << "Recorder started non-blocking";
-            });
-
-            connect(recorder, &QProcess::errorOccurred, this, [](QProcess::ProcessError error) {
-                qWarning() << "Recorder process error:" << error;
-            });
-
-            connect(recorder,
-                    QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-                    this,
-                    [=](int exitCode, QProcess::ExitStatus exitStatus) {
-                        qDebug() << "Recorder finished. Exit code:" << exitCode
-                                 << "Exit status:" << exitStatus;
+    metrics::Registry::instance().print();
 
-                        qDebug() << "Recorded file:" << recordFile;
-
-                        if (QFileInfo::exists(recordFile)) {
-                            qDebug() << "Recording file exists, ready to analyze.";
-
-                            m_audioCheck.audioReport = m_audioCheck.analyzeRecording(recordFile);
-
-                            QString reportResult = m_audioCheck.formatReportCompact(m_audioCheck.audioReport);
-
-                            qDebug().noquote() << reportResult;
-                            if (client->isConnected()) {
-                                QString radar1ReportInfo = "radar1Normal";
-                                QString radar2ReportInfo = "radar2Normal";
-
-                                if (radar1UartHeartBeatCounter > 5)
-                                    radar1ReportInfo = "radar1Error";
-                                if (radar2UartHeartBeatCounter > 5)
-                                    radar2ReportInfo = "radar2Error";
-
-                                QJsonObject obj;
-                                obj["audio_report"] = reportResult;
-                                obj["radar_report"] = radar1ReportInfo + "_" + radar2ReportInfo;
-                                client->enqueueEvent("DEVICE_STATUS_INFO", obj);
-                            }
-                        } else {
-                            qWarning() << "Recording file not found:" << recordFile;
-                        }
-
-                        recorder->deleteLater();
-                    });
-
-            recorder->start();
-
-            // =========================
-            // PLAY COMMAND:
-            //
-            // pw-play --target <KT_USB_SINK_ID> audio_health_test.wav
-            // =========================
-
-            player->setProgram("pw-play");
-
-            player->setArguments(QStringList() << "--target" << speakerTarget << "audio_health_test.wav");
-
-            player->setWorkingDirectory(wavDir);
-            player->setProcessChannelMode(QProcess::MergedChannels);
-
-            connect(player, &QProcess::readyReadStandardOutput, this, [player]() {
-                qDebug().noquote() << "[PLAY]" << player->readAllStandardOutput();
-            });
-
-            connect(player, &QProcess::started, this, [speakerTarget]() {
-                qDebug() << "Player started: pw-play --target" << speakerTarget << "audio_health_test.wav";
-            });
-
-            connect(player, &QProcess::errorOccurred, this, [](QProcess::ProcessError error) {
-                qWarning() << "Player process error:" << error;
-            });
-
-            connect(player,
-                    QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-                    this,
-                    [player](int exitCode, QProcess::ExitStatus exitStatus) {
-                        qDebug() << "Player finished. Exit code:" << exitCode << "Exit status:" << exitStatus;
+    QJsonObject obj;
+    obj["metrics"] = metrics::Registry::instance().snapshot();
+    obj["startup"] = m_startup->report();
+    obj["fall_latency"] = FallLatencyTracker::instance().report();
+    if (m_radarStreamer)
+        obj["radar_stream"] = m_radarStreamer->status();
+    client->enqueueEvent("DEVICE_METRICS_INFO", obj);
 
-                        player->deleteLater();
-                    });
+    // Ring buffer trace hanya terisi kalau dibuild dengan RADARSCAN_TRACE.
+    if (trace::compiledIn()) {
+        const QString path = QDir::homePath() + "/radarScan-trace.json";
+        QString err;
 
-            QTimer::singleShot(300, this, [player]() {
-                player->start();
-            });
-        });
+        if (trace::dump(path, &err))
+            qDebug() << "Trace dumped to" << path;
+        else
+            qWarning() << "Trace dump failed:" << err;
+    }
 }
 
 // =============================================================================
-// PipeWire target discovery
+// Audio health test
 // =============================================================================
-void MainWindow::getMicTargetFromWpctlStatusAsync(
-    std::function<void(const QString &micTarget, const QString &err)> callback)
+void MainWindow::runAudioHealthRecordTest()
 {
-    QProcess *wpctl = new QProcess(this);
-    QByteArray *outputBuffer = new QByteArray();
-
-    wpctl->setProgram("wpctl");
-    wpctl->setArguments(QStringList() << "status");
-    wpctl->setProcessChannelMode(QProcess::MergedChannels);
+    // Loopback in-process: stimulus di memory, capture dianalisis per blok
+    if (!m_audioLoopback) {
+        m_audioLoopback = new AudioLoopbackTest(this);
 
-    connect(wpctl, &QProcess::readyRead, this, [wpctl, outputBuffer]() {
-        outputBuffer->append(wpctl->readAll());
-    });
-
-    connect(
-        wpctl, &QProcess::errorOccurred, this, [wpctl, outputBuffer, callback](QProcess::ProcessError error) {
-            QString err = QString("wpctl process error: %1").arg(error);
-
-            qWarning() << err;
-
-            callback(QString(), err);
-
-            delete outputBuffer;
-            wpctl->deleteLater();
+        connect(m_audioLoopback, &AudioLoopbackTest::finished, this, &MainWindow::onAudioHealthReport);
+        connect(m_audioLoopback, &AudioLoopbackTest::failed, this, [](const QString &error) {
+            qWarning().noquote() << "Audio health test failed:" << error;
         });
-
-    connect(wpctl,
-            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this,
-            [this, wpctl, outputBuffer, callback](int exitCode, QProcess::ExitStatus exitStatus) {
-                outputBuffer->append(wpctl->readAll());
-
-                QString output = QString::fromUtf8(*outputBuffer);
-
-                if (exitStatus != QProcess::NormalExit || exitCode != 0) {
-                    QString err = "wpctl status failed:\n" + output;
-
-                    qWarning().noquote() << err;
-
-                    callback(QString(), err);
-
-                    delete outputBuffer;
-                    wpctl->deleteLater();
-                    return;
-                }
-
-                QString parseErr;
-                QString micTarget = parseMicTargetFromWpctlStatus(output, &parseErr);
-
-                callback(micTarget, parseErr);
-
-                delete outputBuffer;
-                wpctl->deleteLater();
-            });
-
-    wpctl->start();
-}
-
-// -----------------------------------------------------------------------------
-QString MainWindow::parseMicTargetFromWpctlStatus(const QString &output, QString *err) const
-{
-    bool inSources = false;
-
-    QString defaultSourceId;
-    QString firstNonMonitorSourceId;
-    QStringList detectedSources;
-
-    // Bisa handle format:
-    // *   55. ReSpeaker ...
-    //     56. Monitor ...
-    QRegularExpression sourceRx(R"(^\*?\s*(\d+)\.\s+(.+?)(?:\s+\[|$))");
-
-    QStringList lines = output.split('\n');
-
-    for (const QString &rawLine : lines) {
-        QString line = rawLine.trimmed();
-
-        if (line.contains("Sources:")) {
-            inSources = true;
-            continue;
-        }
-
-        if (inSources && (line.contains("Sinks:") || line.contains("Filters:") || line.contains("Streams:") ||
-                          line.contains("Video:") || line.contains("Devices:"))) {
-            break;
-        }
-
-        if (!inSources)
-            continue;
-
-        QRegularExpressionMatch match = sourceRx.match(line);
-        if (!match.hasMatch())
-            continue;
-
-        QString id = match.captured(1).trimmed();
-        QString name = match.captured(2).trimmed();
-
-        detectedSources << QString("%1. %2").arg(id, name);
-
-        bool isDefault = rawLine.contains("*");
-        bool isMonitor = name.contains("monitor", Qt::CaseInsensitive);
-
-        if (isDefault && !isMonitor) {
-            defaultSourceId = id;
-        }
-
-        if (firstNonMonitorSourceId.isEmpty() && !isMonitor) {
-            firstNonMonitorSourceId = id;
-        }
-
-        // Prioritas utama: ReSpeaker / SEEED
-        if (name.contains("respeaker", Qt::CaseInsensitive) || name.contains("seeed", Qt::CaseInsensitive) ||
-            name.contains("4 mic", Qt::CaseInsensitive) || name.contains("mic array", Qt::CaseInsensitive)) {
-            qDebug() << "Matched mic from wpctl status:" << id << name;
-            return id;
-        }
-    }
-
-    if (!defaultSourceId.isEmpty()) {
-        qWarning() << "ReSpeaker source not found. Using default source ID:" << defaultSourceId;
-        return defaultSourceId;
     }
 
-    if (!firstNonMonitorSourceId.isEmpty()) {
-        qWarning() << "Default source not found. Using first non-monitor source ID:"
-                   << firstNonMonitorSourceId;
-        return firstNonMonitorSourceId;
+    if (m_audioLoopback->isRunning()) {
+        qDebug() << "Audio health test masih berjalan";
+        return;
     }
 
-    if (err) {
-        *err = "No valid audio source found from wpctl status.\nDetected sources:\n" +
-               detectedSources.join('\n') + "\n\nFull wpctl output:\n" + output;
+    // Target dari registry kalau sudah siap; kosong = dicari sendiri oleh AudioLoopbackTest
+    QString sink;
+    QString source;
+    if (m_audioDevices && m_audioDevices->isReady()) {
+        sink = m_audioDevices->preferredSink();
+        source = m_audioDevices->preferredSource();
     }
 
-    return {};
+    if (!m_audioLoopback->start(sink, source))
+        qWarning() << "Audio health test tidak bisa dimulai";
 }
 
 // -----------------------------------------------------------------------------
-void MainWindow::getAudioTargetsFromWpctlStatusAsync(
-    std::function<void(const QString &micTarget, const QString &speakerTarget, const QString &err)> callback)
+void MainWindow::onAudioHealthReport(const AudioHealthChecker::Report &report)
 {
-    QProcess *wpctl = new QProcess(this);
-    QByteArray *outputBuffer = new QByteArray();
-
-    wpctl->setProgram("wpctl");
-    wpctl->setArguments(QStringList() << "status");
-    wpctl->setProcessChannelMode(QProcess::MergedChannels);
-
-    connect(wpctl, &QProcess::readyRead, this, [wpctl, outputBuffer]() {
-        outputBuffer->append(wpctl->readAll());
-    });
-
-    connect(
-        wpctl, &QProcess::errorOccurred, this, [wpctl, outputBuffer, callback](QProcess::ProcessError error) {
-            if (error == QProcess::FailedToStart) {
-                QString err = "Failed to start wpctl status";
-
-                qWarning() << err;
-
-                callback(QString(), QString(), err);
-
-                delete outputBuffer;
-                wpctl->deleteLater();
-            }
-        });
-
-    connect(wpctl,
-            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this,
-            [this, wpctl, outputBuffer, callback](int exitCode, QProcess::ExitStatus exitStatus) {
-                outputBuffer->append(wpctl->readAll());
-
-                QString output = QString::fromUtf8(*outputBuffer);
-
-                if (exitStatus != QProcess::NormalExit || exitCode != 0) {
-                    QString err = "wpctl status failed:\n" + output;
-
-                    qWarning().noquote() << err;
-
-                    callback(QString(), QString(), err);
-
-                    delete outputBuffer;
-                    wpctl->deleteLater();
-                    return;
-                }
-
-                QString micTarget;
-                QString speakerTarget;
-                QString parseErr;
-
-                bool ok = parseAudioTargetsFromWpctlStatus(output, &micTarget, &speakerTarget, &parseErr);
-
-                if (!ok) {
-                    callback(QString(), QString(), parseErr);
-                } else {
-                    callback(micTarget, speakerTarget, QString());
-                }
-
-                delete outputBuffer;
-                wpctl->deleteLater();
-            });
-
-    wpctl->start();
-}
-
-// -----------------------------------------------------------------------------
-bool MainWindow::parseAudioTargetsFromWpctlStatus(const QString &output,
-                                                  QString *micTarget,
-                                                  QString *speakerTarget,
-                                                  QString *err) const
-{
-    enum class Section
-    {
-        None,
-        Sinks,
-        Sources
-    };
+    m_audioCheck.audioReport = report;
 
-    Section section = Section::None;
+    QString reportResult = m_audioCheck.formatReportCompact(m_audioCheck.audioReport);
 
-    QString foundMicId;
-    QString fallbackDefaultSourceId;
-    QString fallbackFirstSourceId;
-
-    QString foundSpeakerId;
-
-    QStringList detectedSources;
-    QStringList detectedSinks;
-
-    QRegularExpression nodeRx(R"((\*)?\s*(\d+)\.\s+(.+?)(?:\s+\[|$))");
-
-    const QStringList lines = output.split('\n');
-
-    for (const QString &rawLine : lines) {
-        QString line = rawLine.trimmed();
-
-        if (line.contains("Sinks:") && !line.contains("Sink endpoints:")) {
-            section = Section::Sinks;
-            continue;
-        }
-
-        if (line.contains("Sources:") && !line.contains("Source endpoints:")) {
-            section = Section::Sources;
-            continue;
-        }
-
-        if (line.contains("Devices:") || line.contains("Sink endpoints:") ||
-            line.contains("Source endpoints:") || line.contains("Filters:") || line.contains("Streams:") ||
-            line.contains("Video:")) {
-            section = Section::None;
-            continue;
-        }
-
-        if (section == Section::None)
-            continue;
-
-        QRegularExpressionMatch match = nodeRx.match(rawLine);
-
-        if (!match.hasMatch())
-            continue;
-
-        const bool isDefault = !match.captured(1).isEmpty();
-        const QString id = match.captured(2).trimmed();
-        const QString name = match.captured(3).trimmed();
-
-        if (section == Section::Sources) {
-            detectedSources << QString("%1. %2").arg(id, name);
-
-            const bool isMonitor = name.contains("monitor", Qt::CaseInsensitive);
-
-            if (isDefault && !isMonitor) {
-                fallbackDefaultSourceId = id;
-            }
-
-            if (fallbackFirstSourceId.isEmpty() && !isMonitor) {
-                fallbackFirstSourceId = id;
-            }
-
-            if (name.contains("respeaker", Qt::CaseInsensitive) ||
-                name.contains("seeed", Qt::CaseInsensitive) || name.contains("4 mic", Qt::CaseInsensitive) ||
-                name.contains("mic array", Qt::CaseInsensitive)) {
-                foundMicId = id;
-                qDebug() << "Matched ReSpeaker source:" << id << name;
-            }
-        }
-
-        if (section == Section::Sinks) {
-            detectedSinks << QString("%1. %2").arg(id, name);
-
-            // Target speaker wajib KT USB
-            if (name.contains("kt usb", Qt::CaseInsensitive) ||
-                (name.contains("kt", Qt::CaseInsensitive) && name.contains("usb", Qt::CaseInsensitive))) {
-                foundSpeakerId = id;
-                qDebug() << "Matched KT USB sink:" << id << name;
-            }
-        }
-    }
-
-    if (foundMicId.isEmpty()) {
-        if (!fallbackDefaultSourceId.isEmpty()) {
-            foundMicId = fallbackDefaultSourceId;
-            qWarning() << "ReSpeaker source not found. Using default source:" << foundMicId;
-        } else if (!fallbackFirstSourceId.isEmpty()) {
-            foundMicId = fallbackFirstSourceId;
-            qWarning() << "ReSpeaker source not found. Using first source:" << foundMicId;
-        }
-    }
-
-    QStringList errors;
-
-    if (foundMicId.isEmpty()) {
-        errors << "No valid microphone source found.";
-    }
-
-    if (foundSpeakerId.isEmpty()) {
-        errors << "KT USB speaker sink not found.";
-    }
+    qDebug().noquote() << reportResult;
+    if (client->isConnected()) {
+        QString radar1ReportInfo = "radar1Normal";
+        QString radar2ReportInfo = "radar2Normal";
 
-    if (!errors.isEmpty()) {
-        if (err) {
-            *err = errors.join('\n') + "\n\nDetected Sources:\n" + detectedSources.join('\n') +
-                   "\n\nDetected Sinks:\n" + detectedSinks.join('\n') + "\n\nFull wpctl output:\n" + output;
-        }
+        if (radar1UartHeartBeatCounter > 5)
+            radar1ReportInfo = "radar1Error";
+        if (radar2UartHeartBeatCounter > 5)
+            radar2ReportInfo = "radar2Error";
 
-        return false;
+        QJsonObject obj;
+        obj["audio_report"] = reportResult;
+        obj["radar_report"] = radar1ReportInfo + "_" + radar2ReportInfo;
+        client->enqueueEvent("DEVICE_STATUS_INFO", obj);
     }
-
-    if (micTarget)
-        *micTarget = foundMicId;
-
-    if (speakerTarget)
-        *speakerTarget = foundSpeakerId;
-
-    return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -4245,7 +3919,7 @@ void MainWindow::onSoundFinished(int sentenceIndex, QString langIndex)
             break;
     }
 
-    m_microphoneControl->unmute();
+    soundSettled();
 }
 
 // -----------------------------------------------------------------------------
@@ -4253,6 +3927,18 @@ void MainWindow::onSoundFailed(int sentenceIndex, QString langIndex, QString err
 {
     qWarning() << "Audio playback failed:"
                << "sentenceIndex:" << sentenceIndex << "language:" << langIndex << "error:" << errorMessage;
+
+    // Prompt yang dipotong / gagal juga tidak lagi berbunyi
+    soundSettled();
+}
+
+// -----------------------------------------------------------------------------
+void MainWindow::soundSettled()
+{
+    // Voice lain (di-duck atau antre) masih berbunyi: mic tetap mute
+    m_activeSounds = qMax(0, m_activeSounds - 1);
+    if (m_activeSounds == 0)
+        m_microphoneControl->unmute();
 }
 
 // -----------------------------------------------------------------------------
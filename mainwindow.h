@@ -50,20 +50,26 @@
 #include "AudioHealthChecker.h"
 #include "Pzem004Tv30Qt.h"
 #include "VolumeMonitor.h"
+#include "audioloopbacktest.h"
+#include "voicerecorder.h"
 #include "audioworker.h"
 #include "bme280worker.h"
 #include "brightness.h"
+#include "commandcoalescer.h"
 #include "cputemperatureworker.h"
 #include "gpio.h"
+#include "michealthmonitor.h"
+#include "acousticdetector.h"
 #include "networkmonitor.h"
 #include "payloadprocessor.h"
 #include "qcustomplot.h"
 #include "radar.h"
+#include "radarstreamer.h"
 #include "socketeventworker.h"
 #include "socketioclient.h"
+#include "startupprofiler.h"
 #include "systemdmonitorqt.h"
 #include "utilities.h"
-#include "volume.h"
 #include "microphonecontrol.h"
 
 #ifdef Q_OS_LINUX
@@ -238,13 +244,11 @@ private slots:
     void on_btnsetVol_clicked();
     void onVolumeGetRequested();
     void onVolumeSetRequested(int value);
-    void onVolumeIncreaseReq();
-    void onVolumeDecreaseReq();
+    void onVolumeStepReq(int steps);
     void onVolumeChanged(int percent);
     void onBrightnessSetRequested(int value);
     void onBrightnessGetRequested();
-    void onBrihtnessIncreaseReq();
-    void onBrightnessDecreaseReq();
+    void onBrightnessStepReq(int steps);
     void slotGpioTimer();
 
     // ---------------------------------------------------------------------
@@ -272,7 +276,6 @@ private slots:
     void onIncidentFallHelpEventDetected();
     void onIncidentFallOKEventDetected();
     void onIncidentFallCompleted();
-    void slotTimerSendFallEvent();
     void slotTimerHeartBeat();
     void onRadarHeartBeatDetected();
 
@@ -357,6 +360,7 @@ private slots:
     void onPzemDataReadyComplete(Pzem004Tv30Data data);
     void onPowerInfoReq();
     void onAudioInfoReq();
+    void onMetricsInfoReq();
     void onBme280ReadingReady(double temperatureC,
                               double pressureHpa,
                               double humidityPercent);
@@ -372,6 +376,8 @@ private slots:
                        QString langIndex,
                        QString errorMessage);
     void onUploadFailed();
+    void onAudioHealthReport(const AudioHealthChecker::Report &report);
+    void onMicHealthChanged(MicHealthMonitor::State state, const AudioHealthChecker::Report &report);
 
 private:
     // ---------------------------------------------------------------------
@@ -381,12 +387,12 @@ private:
     QString demoName;
     QString lang;
     QString wifiState = "";
-    int m_volCurrent;
+    int m_volCurrent = -1;
 
     // ---------------------------------------------------------------------
     // Socket.IO and payload workers
     // ---------------------------------------------------------------------
-    SocketIOClient *client;
+    SocketIOClient *client = nullptr;
     SocketEventWorker *m_worker;
     QThread *m_workerThread;
 
@@ -394,6 +400,7 @@ private:
     QThread *m_threadB;
     PayloadProcessor *m_procA;
     PayloadProcessor *m_procB;
+    RadarStreamer *m_radarStreamer = nullptr;
 
     // ---------------------------------------------------------------------
     // Audio worker
@@ -401,17 +408,22 @@ private:
     QThread *m_audioThread;
     AudioWorker *m_audioWorker;
     AudioHealthChecker m_audioCheck;
+    AudioLoopbackTest *m_audioLoopback = nullptr;
+    VoiceRecorder *m_voiceRecorder = nullptr;
+    MicHealthMonitor *m_micHealth = nullptr;
+    AcousticEventDetector *m_acoustic = nullptr;
+    int m_activeSounds = 0;         // request soundPlay yang belum finished / failed
 
 #ifdef Q_OS_LINUX
     // ---------------------------------------------------------------------
     // Linux-specific services and GPIO
     // ---------------------------------------------------------------------
-    VolumeMonitor *m_volumeMonitor;
+    VolumeMonitor *m_volumeMonitor = nullptr;
     gpio *m_gpio;
-    volume *m_volume;
     brightness *m_brightness;
-    utilities *m_utility;
-    systemdmonitorqt *systemdymon;
+    utilities *m_utility = nullptr;
+    CommandCoalescer *m_commands = nullptr;
+    systemdmonitorqt *systemdymon = nullptr;
     QTimer *gpioTimer;
     QElapsedTimer gpioElapsedTimer;
 
@@ -442,6 +454,7 @@ private:
 
     QCPGraph *radarPoint;
     QCPGraph *radarPoint2;
+    bool m_graphicsReady = false;
 
     QSerialPort *m_serial = nullptr;
     QByteArray m_buffer;
@@ -455,7 +468,6 @@ private:
     // ---------------------------------------------------------------------
     // Timers and heartbeat state
     // ---------------------------------------------------------------------
-    QTimer *timerSendFallevent = nullptr;
     QTimer *timerHeartBeatCounter;
     bool fallEventAckReceived = false;
     quint8 radar1UartHeartBeatCounter;
@@ -489,7 +501,12 @@ private:
     void initBME280();
     void initCpuTemp();
     void initUtility();
+    void initNetworkUtility();
+    void initHealthInfo();
     void initMicControl();
+    void initMicHealth();
+
+    StartupProfiler *m_startup = nullptr;
 
     // ---------------------------------------------------------------------
     // Radar and plot helpers
@@ -519,6 +536,7 @@ private:
     // Sound and recording helpers
     // ---------------------------------------------------------------------
     void soundPlay(int request, const QString &lang = "sv");
+    void soundSettled();
     void startRecording();
     void stopRecording();
     void loadWav(const QString &path);
@@ -526,23 +544,7 @@ private:
     double calculateDb(const QByteArray &data);
 
     void runAudioHealthRecordTest();
-    void getMicTargetFromWpctlStatusAsync(
-        std::function<void(const QString &micTarget,
-                           const QString &err)> callback);
-
-    QString parseMicTargetFromWpctlStatus(
-        const QString &output,
-        QString *err = nullptr) const;
-
-    void getAudioTargetsFromWpctlStatusAsync(
-        std::function<void(const QString &micTarget,
-                           const QString &speakerTarget,
-                           const QString &err)> callback);
 
-    bool parseAudioTargetsFromWpctlStatus(const QString &output,
-                                          QString *micTarget,
-                                          QString *speakerTarget,
-                                          QString *err = nullptr) const;
 
     // ---------------------------------------------------------------------
     // System, network, and application helpers
@@ -556,6 +558,7 @@ private:
 
     //Microphone control
     MicrophoneControl *m_microphoneControl = nullptr;
+    AudioDeviceRegistry *m_audioDevices = nullptr;
 
 };
 
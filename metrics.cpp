@@ -0,0 +1,226 @@
+#include "metrics.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <cmath>
+
+Q_LOGGING_CATEGORY(lcHotPath, "radarscan.hotpath", QtInfoMsg)
+
+namespace metrics {
+
+//---------------------------------------------------------------------------------------
+int Histogram::bucketIndex(quint64 v)
+{
+    if (v < quint64(SUB_COUNT))
+        return int(v);
+
+    const int e = 63 - int(qCountLeadingZeroBits(v));
+    const int sub = int((v >> (e - SUB_BITS)) & quint64(SUB_COUNT - 1));
+
+    return (e - SUB_BITS + 1) * SUB_COUNT + sub;
+}
+
+//---------------------------------------------------------------------------------------
+quint64 Histogram::bucketLowerBound(int idx)
+{
+    if (idx < SUB_COUNT)
+        return quint64(idx);
+
+    const int block = idx / SUB_COUNT;
+    const int sub = idx % SUB_COUNT;
+
+    return quint64(SUB_COUNT + sub) << (block - 1);
+}
+
+//---------------------------------------------------------------------------------------
+quint64 Histogram::bucketUpperBound(int idx)
+{
+    if (idx < SUB_COUNT)
+        return quint64(idx);
+
+    const int block = idx / SUB_COUNT;
+    return bucketLowerBound(idx) + ((quint64(1) << (block - 1)) - 1);
+}
+
+//---------------------------------------------------------------------------------------
+void Histogram::record(quint64 v)
+{
+    m_buckets[bucketIndex(v)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(v, std::memory_order_relaxed);
+
+    quint64 prev = m_max.load(std::memory_order_relaxed);
+    while (v > prev && !m_max.compare_exchange_weak(prev, v, std::memory_order_relaxed)) {
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void Histogram::reset()
+{
+    for (auto &b : m_buckets)
+        b.store(0, std::memory_order_relaxed);
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------------------
+double Histogram::mean() const
+{
+    const quint64 n = count();
+    if (n == 0)
+        return 0.0;
+
+    return double(m_sum.load(std::memory_order_relaxed)) / double(n);
+}
+
+//---------------------------------------------------------------------------------------
+quint64 Histogram::percentile(double p) const
+{
+    quint64 total = 0;
+    for (const auto &b : m_buckets)
+        total += b.load(std::memory_order_relaxed);
+
+    if (total == 0)
+        return 0;
+
+    p = std::clamp(p, 0.0, 100.0);
+    const quint64 target = std::max<quint64>(1, quint64(std::ceil(p / 100.0 * double(total))));
+
+    quint64 acc = 0;
+
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        acc += m_buckets[i].load(std::memory_order_relaxed);
+
+        if (acc >= target) {
+            // Titik tengah bucket, tidak melebihi max yang tercatat.
+            const quint64 lo = bucketLowerBound(i);
+            const quint64 mid = lo + (bucketUpperBound(i) - lo) / 2;
+            return std::min(mid, max());
+        }
+    }
+
+    return max();
+}
+
+//---------------------------------------------------------------------------------------
+QJsonObject Histogram::toJson() const
+{
+    QJsonObject o;
+    o["count"] = qint64(count());
+    o["mean"] = mean();
+    o["p50"] = qint64(percentile(50.0));
+    o["p90"] = qint64(percentile(90.0));
+    o["p99"] = qint64(percentile(99.0));
+    o["max"] = qint64(max());
+    return o;
+}
+
+//---------------------------------------------------------------------------------------
+Registry &Registry::instance()
+{
+    static Registry registry;
+    return registry;
+}
+
+//---------------------------------------------------------------------------------------
+Counter &Registry::counter(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto &slot = m_counters[name];
+    if (!slot)
+        slot = std::make_unique<Counter>();
+
+    return *slot;
+}
+
+//---------------------------------------------------------------------------------------
+Gauge &Registry::gauge(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto &slot = m_gauges[name];
+    if (!slot)
+        slot = std::make_unique<Gauge>();
+
+    return *slot;
+}
+
+//---------------------------------------------------------------------------------------
+Histogram &Registry::histogram(const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto &slot = m_histograms[name];
+    if (!slot)
+        slot = std::make_unique<Histogram>();
+
+    return *slot;
+}
+
+//---------------------------------------------------------------------------------------
+QJsonObject Registry::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject counters;
+    for (const auto &it : m_counters)
+        counters[it.first] = qint64(it.second->value());
+
+    QJsonObject gauges;
+    for (const auto &it : m_gauges)
+        gauges[it.first] = it.second->value();
+
+    QJsonObject histograms;
+    for (const auto &it : m_histograms)
+        histograms[it.first] = it.second->toJson();
+
+    QJsonObject obj;
+    obj["counters"] = counters;
+    obj["gauges"] = gauges;
+    obj["histograms"] = histograms;
+    return obj;
+}
+
+//---------------------------------------------------------------------------------------
+void Registry::print() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    qDebug().noquote() << "============== METRICS ==============";
+
+    for (const auto &it : m_counters)
+        qDebug().noquote() << QString("%1 = %2").arg(it.first).arg(it.second->value());
+
+    for (const auto &it : m_gauges)
+        qDebug().noquote() << QString("%1 = %2").arg(it.first).arg(it.second->value());
+
+    for (const auto &it : m_histograms) {
+        const Histogram &h = *it.second;
+        qDebug().noquote() << QString("%1 : n %2 | p50 %3 | p90 %4 | p99 %5 | max %6")
+                                  .arg(it.first)
+                                  .arg(h.count())
+                                  .arg(h.percentile(50.0))
+                                  .arg(h.percentile(90.0))
+                                  .arg(h.percentile(99.0))
+                                  .arg(h.max());
+    }
+
+    qDebug().noquote() << "=====================================";
+}
+
+//---------------------------------------------------------------------------------------
+void Registry::resetHistograms()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (auto &it : m_histograms)
+        it.second->reset();
+}
+
+} // namespace metrics
@@ -0,0 +1,123 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+
+/*
+ * Registry metrics ringan: counter, gauge dan histogram latency (HDR-style).
+ *
+ * Recording (inc/set/record) hanya memakai atomic relaxed, tanpa lock dan
+ * tanpa format string, jadi aman dipanggil dari thread mana pun (radar,
+ * audio, GUI). Lock hanya dipakai saat registrasi nama dan saat snapshot.
+ *
+ * Pemakaian di hot path (lookup nama hanya sekali per call site):
+ *
+ *     METRIC_COUNTER("socketio.enqueue").inc();
+ *     METRIC_HISTOGRAM("fall.enqueue_to_send_us").record(us);
+ */
+
+// Log per-event di hot path (enqueue/dequeue, RX chunk, dll).
+// Default mati; aktifkan dengan QT_LOGGING_RULES="radarscan.hotpath.debug=true".
+Q_DECLARE_LOGGING_CATEGORY(lcHotPath)
+
+namespace metrics {
+
+//---------------------------------------------------------------------------------------
+class Counter
+{
+public:
+    void inc(quint64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+//---------------------------------------------------------------------------------------
+class Gauge
+{
+public:
+    void set(qint64 v) { m_value.store(v, std::memory_order_relaxed); }
+    void add(qint64 d) { m_value.fetch_add(d, std::memory_order_relaxed); }
+    qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> m_value{0};
+};
+
+//---------------------------------------------------------------------------------------
+// Histogram log-linear: 8 sub-bucket per pangkat dua (presisi ~12.5%),
+// range 0 .. 2^64. Unit nilai bebas, konvensi di repo ini: mikrodetik.
+class Histogram
+{
+public:
+    static constexpr int SUB_BITS = 3;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    void record(quint64 v);
+    void reset();
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    quint64 max() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const;
+    quint64 percentile(double p) const;
+
+    QJsonObject toJson() const;
+
+private:
+    static int bucketIndex(quint64 v);
+    static quint64 bucketLowerBound(int idx);
+    static quint64 bucketUpperBound(int idx);
+
+    std::array<std::atomic<quint32>, BUCKET_COUNT> m_buckets{};
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sum{0};
+    std::atomic<quint64> m_max{0};
+};
+
+//---------------------------------------------------------------------------------------
+class Registry
+{
+public:
+    static Registry &instance();
+
+    // Referensi yang dikembalikan valid selama proses hidup.
+    Counter &counter(const QString &name);
+    Gauge &gauge(const QString &name);
+    Histogram &histogram(const QString &name);
+
+    QJsonObject snapshot() const;
+    void print() const;
+    void resetHistograms();
+
+private:
+    Registry() = default;
+
+    mutable QMutex m_mutex;
+    std::map<QString, std::unique_ptr<Counter>> m_counters;
+    std::map<QString, std::unique_ptr<Gauge>> m_gauges;
+    std::map<QString, std::unique_ptr<Histogram>> m_histograms;
+};
+
+} // namespace metrics
+
+// Lookup registry sekali per call site (static lokal per ekspansi macro).
+#define METRIC_COUNTER(name) \
+    ([]() -> metrics::Counter & { static metrics::Counter &m = metrics::Registry::instance().counter(name); return m; }())
+
+#define METRIC_GAUGE(name) \
+    ([]() -> metrics::Gauge & { static metrics::Gauge &m = metrics::Registry::instance().gauge(name); return m; }())
+
+#define METRIC_HISTOGRAM(name) \
+    ([]() -> metrics::Histogram & { static metrics::Histogram &m = metrics::Registry::instance().histogram(name); return m; }())
+
+#endif // METRICS_H
@@ -0,0 +1,458 @@
+#include "michealthmonitor.h"
+
+#include "acousticdetector.h"
+#include "metrics.h"
+#include "pcmutils.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+//---------------------------------------------------------------------------------------
+static double toDbfs(double linear)
+{
+    return pcm::toDbfs(linear);
+}
+
+//---------------------------------------------------------------------------------------
+MicHealthMonitor::MicHealthMonitor(QObject *parent)
+    : QObject(parent)
+{
+    m_poll.setInterval(1000);
+    connect(&m_poll, &QTimer::timeout, this, &MicHealthMonitor::poll);
+}
+
+//---------------------------------------------------------------------------------------
+MicHealthMonitor::~MicHealthMonitor()
+{
+    stop();
+}
+
+//---------------------------------------------------------------------------------------
+QString MicHealthMonitor::stateName(State state)
+{
+    switch (state) {
+    case State::Ok:          return QStringLiteral("ok");
+    case State::Muted:       return QStringLiteral("muted");
+    case State::Silent:      return QStringLiteral("silent");
+    case State::Saturated:   return QStringLiteral("saturated");
+    case State::Stalled:     return QStringLiteral("stalled");
+    case State::Unavailable: return QStringLiteral("unavailable");
+    case State::Unknown:     break;
+    }
+
+    return QStringLiteral("unknown");
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::setMicMuted(bool muted)
+{
+    if (m_muted == muted)
+        return;
+
+    m_muted = muted;
+    m_captureMuted.store(muted, std::memory_order_relaxed);
+    poll();
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::stop()
+{
+    m_poll.stop();
+    teardown();
+    m_running = false;
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::consume(const float *x, int n)
+{
+    if (m_acoustic)
+        m_acoustic->feed(x, n);
+
+    while (n > 0) {
+        Second &s = m_current;
+        const int room = SAMPLE_RATE - int(s.samples + s.lost);
+        const int take = std::min(n, room);
+
+        const pcm::Levels l = pcm::levels(x, take, CLIP_LEVEL);
+
+        s.sum += l.sum;
+        s.sumSq += l.sumSq;
+        s.peak = std::max(s.peak, l.peak);
+        s.clipped += l.clipped;
+        s.samples += quint32(take);
+
+        x += take;
+        n -= take;
+
+        if (int(s.samples + s.lost) >= SAMPLE_RATE)
+            closeSecond();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::lose(int n)
+{
+    // Hole / overflow: sampel hilang tetap memajukan timeline detik
+    if (m_acoustic)
+        m_acoustic->discontinuity();
+
+    while (n > 0) {
+        Second &s = m_current;
+        const int take = std::min(n, SAMPLE_RATE - int(s.samples + s.lost));
+
+        s.lost += quint32(take);
+        n -= take;
+
+        if (int(s.samples + s.lost) >= SAMPLE_RATE)
+            closeSecond();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::closeSecond()
+{
+    Second s = m_current;
+    m_current = Second();
+
+    // Energi AC: mic mati yang hanya mengeluarkan DC offset tetap terbaca diam
+    if (s.samples > 0) {
+        const double mean = s.sum / s.samples;
+        s.acMeanSq = std::max(0.0, s.sumSq / s.samples - mean * mean);
+    }
+
+    m_window[m_windowPos] = s;
+    m_windowPos = (m_windowPos + 1) % WINDOW_S;
+    m_windowFill = std::min(m_windowFill + 1, WINDOW_S);
+    m_seconds++;
+
+    // Saat mute counter di-reset: setelah unmute Silent baru muncul SILENT_AFTER_S kemudian
+    const double acDb = toDbfs(std::sqrt(s.acMeanSq));
+    const bool silent = s.samples > 0 && acDb < SILENT_DBFS && !m_captureMuted.load(std::memory_order_relaxed);
+    m_silentSeconds = silent ? m_silentSeconds + 1 : 0;
+
+    // Agregat rolling window (<= WINDOW_S entri, sekali per detik)
+    double energy = 0.0;
+    double noiseFloor = 0.0;
+    float peak = 0.0f;
+    quint64 samples = 0;
+    quint64 clipped = 0;
+    quint64 lost = 0;
+    quint64 shortSamples = 0;
+    quint64 shortClipped = 0;
+    bool haveFloor = false;
+
+    for (int k = 0; k < m_windowFill; ++k) {
+        // k = 0 detik terbaru
+        const Second &w = m_window[(m_windowPos - 1 - k + WINDOW_S) % WINDOW_S];
+
+        energy += w.acMeanSq * w.samples;
+        peak = std::max(peak, w.peak);
+        samples += w.samples;
+        clipped += w.clipped;
+        lost += w.lost;
+
+        if (w.samples > 0 && (!haveFloor || w.acMeanSq < noiseFloor)) {
+            noiseFloor = w.acMeanSq;
+            haveFloor = true;
+        }
+
+        if (k < SHORT_WINDOW_S) {
+            shortSamples += w.samples;
+            shortClipped += w.clipped;
+        }
+    }
+
+    Snapshot snap;
+    snap.seconds = m_seconds;
+    snap.rmsDbfs = samples ? toDbfs(std::sqrt(energy / double(samples))) : -120.0;
+    snap.peakDbfs = toDbfs(peak);
+    snap.noiseFloorDbfs = haveFloor ? toDbfs(std::sqrt(noiseFloor)) : -120.0;
+    snap.clippingPercent = samples ? 100.0 * double(clipped) / double(samples) : 0.0;
+    snap.shortClippingPercent = shortSamples ? 100.0 * double(shortClipped) / double(shortSamples) : 0.0;
+    snap.dropoutPercent = (samples + lost) ? 100.0 * double(lost) / double(samples + lost) : 0.0;
+    snap.silentSeconds = m_silentSeconds;
+
+    m_snapshots.push(snap);
+}
+
+//---------------------------------------------------------------------------------------
+MicHealthMonitor::State MicHealthMonitor::evaluate() const
+{
+    if (!m_running)
+        return State::Unavailable;
+
+    // m_lastSnapshot dimulai di start(): tanpa snapshot STALL_TIMEOUT_MS -> capture berhenti
+    if (m_lastSnapshot.hasExpired(STALL_TIMEOUT_MS))
+        return State::Stalled;
+
+    // Mute disengaja: level / diam / clipping tidak dinilai sama sekali
+    if (m_muted)
+        return State::Muted;
+
+    if (m_latest.seconds == 0)
+        return State::Unknown;
+
+    if (m_latest.shortClippingPercent > SATURATED_CLIP_PERCENT)
+        return State::Saturated;
+
+    if (m_latest.silentSeconds >= SILENT_AFTER_S)
+        return State::Silent;
+
+    return State::Ok;
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::poll()
+{
+    Snapshot snap;
+    bool fresh = false;
+
+    while (m_snapshots.pop(snap)) {
+        m_latest = snap;
+        fresh = true;
+    }
+
+    if (fresh) {
+        m_lastSnapshot.restart();
+
+        METRIC_GAUGE("mic.rms_dbfs").set(qRound(m_latest.rmsDbfs));
+        METRIC_GAUGE("mic.noise_floor_dbfs").set(qRound(m_latest.noiseFloorDbfs));
+        METRIC_GAUGE("mic.clipping_permille").set(qRound(m_latest.clippingPercent * 10.0));
+        METRIC_GAUGE("mic.dropout_permille").set(qRound(m_latest.dropoutPercent * 10.0));
+    }
+
+    const State next = evaluate();
+
+    if (next != m_state) {
+        m_state = next;
+
+        if (next == State::Silent || next == State::Saturated || next == State::Stalled)
+            METRIC_COUNTER("mic.health_alerts").inc();
+
+        qDebug() << "MicHealthMonitor state:" << stateName(next)
+                 << "rms" << m_latest.rmsDbfs << "floor" << m_latest.noiseFloorDbfs
+                 << "clip%" << m_latest.clippingPercent << "drop%" << m_latest.dropoutPercent;
+
+        emit stateChanged(next, report());
+    }
+
+    // Stream mati (mis. USB mic dicabut lalu dipasang lagi): buka ulang
+    if (m_running && m_state == State::Stalled && m_lastSnapshot.hasExpired(RESTART_AFTER_MS)) {
+        qWarning() << "MicHealthMonitor: capture berhenti, membuka ulang stream";
+        const QString source = m_sourceName;
+        teardown();
+        m_running = false;
+        start(source);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+AudioHealthChecker::Report MicHealthMonitor::report() const
+{
+    AudioHealthChecker::Report r;
+
+    r.peakDbfs = m_latest.peakDbfs;
+    r.clippingPercent = m_latest.clippingPercent;
+    r.noiseFloorDbfs = m_latest.noiseFloorDbfs;
+    r.rmsDbfs = m_latest.rmsDbfs;
+    r.dropoutPercent = m_latest.dropoutPercent;
+
+    r.ok = m_state == State::Ok || m_state == State::Muted;
+    r.verdict = r.ok ? "PASS" : (m_state == State::Unknown ? "UNKNOWN" : "FAIL");
+
+    r.notes << QString("Passive mic monitor: %1 (window %2 s, %3 s captured).")
+                   .arg(stateName(m_state))
+                   .arg(WINDOW_S)
+                   .arg(m_latest.seconds);
+
+    switch (m_state) {
+    case State::Silent:
+        r.diagnose << QString("Microphone delivered no signal for %1 s. Possible causes: microphone unplugged, "
+                              "hardware mute, dead capsule, or the wrong default source.")
+                          .arg(m_latest.silentSeconds);
+        break;
+    case State::Saturated:
+        r.diagnose << QString("Microphone is clipping %1% of the time. Possible causes: gain too high, "
+                              "aggressive AGC, or a loud noise source next to the device.")
+                          .arg(m_latest.shortClippingPercent, 0, 'f', 1);
+        break;
+    case State::Stalled:
+        r.diagnose << "Capture stream delivers no data. Possible causes: USB microphone disconnected, "
+                      "PipeWire restarted, or the audio server is overloaded.";
+        break;
+    case State::Unavailable:
+        r.diagnose << "Passive microphone monitor is not running.";
+        break;
+    default:
+        break;
+    }
+
+    return r;
+}
+
+#ifdef PLATFORM_LINUX
+
+//---------------------------------------------------------------------------------------
+bool MicHealthMonitor::start(const QString &sourceName)
+{
+    if (m_running)
+        return true;
+
+    m_sourceName = sourceName;
+
+    // Thread pulse belum jalan: state capture aman di-reset dari sini
+    m_current = Second();
+    m_windowPos = 0;
+    m_windowFill = 0;
+    m_seconds = 0;
+    m_silentSeconds = 0;
+    m_latest = Snapshot();
+
+    m_mainloop = pa_threaded_mainloop_new();
+    m_context = pa_context_new(pa_threaded_mainloop_get_api(m_mainloop), "radarScanMicHealth");
+    pa_context_set_state_callback(m_context, contextStateCallback, this);
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    if (pa_threaded_mainloop_start(m_mainloop) < 0
+        || pa_context_connect(m_context, nullptr, PA_CONTEXT_NOFAIL, nullptr) < 0) {
+        pa_threaded_mainloop_unlock(m_mainloop);
+        qWarning() << "MicHealthMonitor: gagal konek PulseAudio";
+        teardown();
+        return false;
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    m_running = true;
+    m_lastSnapshot.start();
+    m_poll.start();
+
+    qDebug() << "MicHealthMonitor started on" << (sourceName.isEmpty() ? QStringLiteral("default source") : sourceName);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::teardown()
+{
+    if (!m_mainloop)
+        return;
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    if (m_stream) {
+        pa_stream_set_state_callback(m_stream, nullptr, nullptr);
+        pa_stream_set_read_callback(m_stream, nullptr, nullptr);
+        pa_stream_set_overflow_callback(m_stream, nullptr, nullptr);
+        pa_stream_disconnect(m_stream);
+        pa_stream_unref(m_stream);
+        m_stream = nullptr;
+    }
+
+    if (m_context) {
+        pa_context_set_state_callback(m_context, nullptr, nullptr);
+        pa_context_disconnect(m_context);
+        pa_context_unref(m_context);
+        m_context = nullptr;
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    pa_threaded_mainloop_stop(m_mainloop);
+    pa_threaded_mainloop_free(m_mainloop);
+    m_mainloop = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::contextStateCallback(pa_context *c, void *userdata)
+{
+    auto *self = static_cast<MicHealthMonitor *>(userdata);
+
+    if (pa_context_get_state(c) != PA_CONTEXT_READY || self->m_stream)
+        return;
+
+    pa_sample_spec spec;
+    spec.format = PA_SAMPLE_FLOAT32NE;
+    spec.rate = SAMPLE_RATE;
+    spec.channels = 1;
+
+    self->m_stream = pa_stream_new(c, "micHealth", &spec, nullptr);
+    if (!self->m_stream) {
+        qWarning() << "MicHealthMonitor: gagal membuat stream record";
+        return;
+    }
+
+    pa_stream_set_state_callback(self->m_stream, streamStateCallback, self);
+    pa_stream_set_read_callback(self->m_stream, readCallback, self);
+    pa_stream_set_overflow_callback(self->m_stream, overflowCallback, self);
+
+    // Blok besar = sedikit wakeup; latency tidak penting untuk statistik
+    pa_buffer_attr attr;
+    attr.maxlength = uint32_t(-1);
+    attr.tlength = uint32_t(-1);
+    attr.prebuf = uint32_t(-1);
+    attr.minreq = uint32_t(-1);
+    attr.fragsize = uint32_t(pa_usec_to_bytes(BLOCK_MS * PA_USEC_PER_MSEC, &spec));
+
+    const QByteArray device = self->m_sourceName.toUtf8();
+
+    if (pa_stream_connect_record(self->m_stream, device.isEmpty() ? nullptr : device.constData(), &attr,
+                                 PA_STREAM_ADJUST_LATENCY) < 0) {
+        qWarning() << "MicHealthMonitor: gagal konek stream record";
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::streamStateCallback(pa_stream *s, void *)
+{
+    // Tidak perlu aksi: snapshot berhenti datang -> poll() melaporkan Stalled lalu restart
+    const pa_stream_state_t state = pa_stream_get_state(s);
+    if (state == PA_STREAM_FAILED || state == PA_STREAM_TERMINATED)
+        qWarning() << "MicHealthMonitor: stream record berhenti";
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::readCallback(pa_stream *s, size_t, void *userdata)
+{
+    auto *self = static_cast<MicHealthMonitor *>(userdata);
+
+    while (pa_stream_readable_size(s) > 0) {
+        const void *data = nullptr;
+        size_t len = 0;
+
+        if (pa_stream_peek(s, &data, &len) < 0 || len == 0)
+            break;
+
+        const int frames = int(len / sizeof(float));
+
+        if (data)
+            self->consume(static_cast<const float *>(data), frames);
+        else
+            self->lose(frames);
+
+        pa_stream_drop(s);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void MicHealthMonitor::overflowCallback(pa_stream *, void *userdata)
+{
+    // Buffer server penuh: perkiraan satu blok hilang
+    static_cast<MicHealthMonitor *>(userdata)->lose(SAMPLE_RATE * BLOCK_MS / 1000);
+}
+
+#else
+
+//---------------------------------------------------------------------------------------
+bool MicHealthMonitor::start(const QString &)
+{
+    return false;
+}
+
+void MicHealthMonitor::teardown()
+{
+}
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef MICHEALTHMONITOR_H
+#define MICHEALTHMONITOR_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "AudioHealthChecker.h"
+#include "mpscqueue.h"
+
+#include <atomic>
+
+class AcousticEventDetector;
+
+#ifdef PLATFORM_LINUX
+    #include <pulse/pulseaudio.h>
+#endif
+
+/*
+ * Monitor kesehatan mic pasif (tanpa stimulus, tanpa suara).
+ *
+ * Satu stream record libpulse (float mono SAMPLE_RATE, blok BLOCK_MS) terus
+ * hidup; setiap blok hanya dijumlahkan (energi, DC, peak, clipping, sampel
+ * hilang) di thread mainloop pulse. Per detik satu ringkasan masuk ring
+ * WINDOW_S detik milik thread itu saja, lalu snapshot agregat dikirim ke
+ * thread GUI lewat MpscQueue: tidak ada lock di jalur capture.
+ *
+ * Thread GUI mem-poll snapshot sekali per detik dan meng-emit stateChanged
+ * saat mic diam (Silent), jenuh (Saturated) atau stream berhenti (Stalled).
+ * Biaya: 10 wakeup/detik dan beberapa operasi per sampel 16 kHz.
+ */
+class MicHealthMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State {
+        Unknown,
+        Ok,
+        Muted,          // mic sengaja di-mute aplikasi: diam itu normal
+        Silent,
+        Saturated,
+        Stalled,
+        Unavailable
+    };
+    Q_ENUM(State)
+
+    explicit MicHealthMonitor(QObject *parent = nullptr);
+    ~MicHealthMonitor();
+
+    // sourceName kosong = default source
+    bool start(const QString &sourceName = QString());
+    void stop();
+
+    // Tap PCM capture untuk deteksi event akustik; set sebelum start()
+    void setAcousticDetector(AcousticEventDetector *detector) { m_acoustic = detector; }
+
+    State state() const { return m_state; }
+    AudioHealthChecker::Report report() const;
+    static QString stateName(State state);
+
+    static constexpr int SAMPLE_RATE = 16000;
+    static constexpr int BLOCK_MS = 100;
+    static constexpr int WINDOW_S = 60;
+    static constexpr int SHORT_WINDOW_S = 10;
+
+    static constexpr double SILENT_DBFS = -85.0;        // AC RMS (DC offset tidak dihitung)
+    static constexpr int SILENT_AFTER_S = 60;
+    static constexpr float CLIP_LEVEL = 0.98f;
+    static constexpr double SATURATED_CLIP_PERCENT = 2.0;
+    static constexpr int STALL_TIMEOUT_MS = 10000;
+    static constexpr int RESTART_AFTER_MS = 30000;
+
+public slots:
+    void setMicMuted(bool muted);
+
+signals:
+    void stateChanged(MicHealthMonitor::State state, const AudioHealthChecker::Report &report);
+
+private:
+    // Ringkasan satu detik (thread pulse)
+    struct Second {
+        double sum = 0.0;
+        double sumSq = 0.0;
+        double acMeanSq = 0.0;      // diisi saat detik ditutup
+        float peak = 0.0f;
+        quint32 samples = 0;
+        quint32 clipped = 0;
+        quint32 lost = 0;
+    };
+
+    // Agregat window, dikirim ke thread GUI
+    struct Snapshot {
+        quint64 seconds = 0;
+        double rmsDbfs = -120.0;
+        double peakDbfs = -120.0;
+        double noiseFloorDbfs = -120.0;
+        double clippingPercent = 0.0;
+        double shortClippingPercent = 0.0;
+        double dropoutPercent = 0.0;
+        int silentSeconds = 0;
+    };
+
+    void consume(const float *x, int n);
+    void lose(int n);
+    void closeSecond();
+
+    void poll();
+    State evaluate() const;
+    void teardown();
+
+#ifdef PLATFORM_LINUX
+    static void contextStateCallback(pa_context *c, void *userdata);
+    static void streamStateCallback(pa_stream *s, void *userdata);
+    static void readCallback(pa_stream *s, size_t nbytes, void *userdata);
+    static void overflowCallback(pa_stream *s, void *userdata);
+
+    pa_threaded_mainloop *m_mainloop = nullptr;
+    pa_context *m_context = nullptr;
+    pa_stream *m_stream = nullptr;
+#endif
+
+    QString m_sourceName;
+    AcousticEventDetector *m_acoustic = nullptr;
+
+    // Thread pulse saja
+    Second m_current;
+    Second m_window[WINDOW_S];
+    int m_windowPos = 0;
+    int m_windowFill = 0;
+    quint64 m_seconds = 0;
+    int m_silentSeconds = 0;
+
+    // Ditulis thread GUI, dibaca thread pulse: detik saat mute tidak dihitung diam
+    std::atomic<bool> m_captureMuted{false};
+
+    MpscQueue<Snapshot> m_snapshots;
+
+    // Thread GUI
+    Snapshot m_latest;
+    QElapsedTimer m_lastSnapshot;
+    QTimer m_poll;
+    State m_state = State::Unknown;
+    bool m_muted = false;
+    bool m_running = false;
+};
+
+#endif // MICHEALTHMONITOR_H
@@ -1,34 +1,33 @@
 #include "microphonecontrol.h"
 
-#include <QRegularExpression>
+#include <QDebug>
 
 namespace {
-constexpr auto WPCTL_PROGRAM = "/usr/bin/wpctl";
-constexpr auto DEFAULT_SOURCE = "@DEFAULT_AUDIO_SOURCE@";
+constexpr auto TARGET_SOURCE = AudioDeviceRegistry::DEFAULT_SOURCE;
 }
 
-MicrophoneControl::MicrophoneControl(QObject *parent)
+MicrophoneControl::MicrophoneControl(AudioDeviceRegistry *devices, QObject *parent)
     : QObject(parent),
-      m_process(new QProcess(this))
+      m_devices(devices)
 {
-    connect(m_process,
-            &QProcess::finished,
+    connect(m_devices,
+            &AudioDeviceRegistry::operationFinished,
             this,
-            &MicrophoneControl::onProcessFinished);
+            &MicrophoneControl::onOperationFinished);
 
-    connect(m_process,
-            &QProcess::errorOccurred,
+    connect(m_devices,
+            &AudioDeviceRegistry::sourceChanged,
             this,
-            &MicrophoneControl::onProcessError);
-}
+            &MicrophoneControl::onSourceChanged);
 
-MicrophoneControl::~MicrophoneControl()
-{
-    if (m_process->state() != QProcess::NotRunning) {
-        m_process->kill();
-    }
+    connect(m_devices,
+            &AudioDeviceRegistry::ready,
+            this,
+            &MicrophoneControl::onDevicesReady);
 }
 
+MicrophoneControl::~MicrophoneControl() = default;
+
 bool MicrophoneControl::isBusy() const
 {
     return m_busy;
@@ -36,94 +35,119 @@ bool MicrophoneControl::isBusy() const
 
 void MicrophoneControl::mute()
 {
-    enqueueCommand({
-        QStringLiteral("set-mute"),
-        QString::fromLatin1(DEFAULT_SOURCE),
-        QStringLiteral("1")
-    }, CommandType::Mute);
+    setMuted(true, CommandType::Mute);
 }
 
 void MicrophoneControl::unmute()
 {
-    enqueueCommand({
-        QStringLiteral("set-mute"),
-        QString::fromLatin1(DEFAULT_SOURCE),
-        QStringLiteral("0")
-    }, CommandType::Unmute);
+    setMuted(false, CommandType::Unmute);
 }
 
 void MicrophoneControl::toggleMute()
 {
-    enqueueCommand({
-        QStringLiteral("set-mute"),
-        QString::fromLatin1(DEFAULT_SOURCE),
-        QStringLiteral("toggle")
-    }, CommandType::ToggleMute);
-}
+    AudioDeviceRegistry::Device device;
 
-void MicrophoneControl::getStatus()
-{
-    enqueueCommand({
-        QStringLiteral("get-volume"),
-        QString::fromLatin1(DEFAULT_SOURCE)
-    }, CommandType::GetStatus);
-}
+    if (!m_devices->findSource(QString::fromLatin1(TARGET_SOURCE), &device)) {
+        emit commandFailed(QStringLiteral("toggle-mute %1").arg(QString::fromLatin1(TARGET_SOURCE)),
+                           QStringLiteral("Source default belum diketahui"));
+        return;
+    }
 
-void MicrophoneControl::enqueueCommand(const QStringList &arguments,
-                                       CommandType type)
-{
-    m_queue.enqueue({arguments, type});
-    startNextCommand();
+    if (device.muted)
+        unmute();
+    else
+        mute();
 }
 
-void MicrophoneControl::startNextCommand()
+void MicrophoneControl::setMuted(bool muted, CommandType type)
 {
-    if (m_process->state() != QProcess::NotRunning || m_queue.isEmpty()) {
+    const QString text = QStringLiteral("set-mute %1 %2")
+                             .arg(QString::fromLatin1(TARGET_SOURCE))
+                             .arg(muted ? 1 : 0);
+
+    // Sudah di state yang diminta (registry up to date lewat subscribe) dan
+    // tidak ada perintah lain di jalan: tidak perlu round trip ke server.
+    AudioDeviceRegistry::Device device;
+    if (m_pending.isEmpty()
+        && m_devices->findSource(QString::fromLatin1(TARGET_SOURCE), &device)
+        && device.muted == muted) {
+        m_muteDeferred = false;
+        emit commandCompleted(text, QStringLiteral("unchanged"));
+        emit muteChanged(muted);
         return;
     }
 
-    const PendingCommand command = m_queue.dequeue();
+    const quint64 id = m_devices->setSourceMute(QString::fromLatin1(TARGET_SOURCE), muted);
+
+    if (id == 0) {
+        // Registry belum siap: diterapkan di applyDeferred(), seperti getStatus()
+        qDebug() << "MicrophoneControl: PulseAudio belum siap, mute" << muted << "ditunda";
+        m_muteDeferred = true;
+        m_deferredMuted = muted;
+        setBusy(true);
+        return;
+    }
 
-    m_currentType = command.type;
-    m_currentCommandText = QStringLiteral("%1 %2")
-                               .arg(QString::fromLatin1(WPCTL_PROGRAM),
-                                    command.arguments.join(QLatin1Char(' ')));
-    m_hasCurrentCommand = true;
+    m_muteDeferred = false;
+    m_pending.insert(id, {type, text});
+    setBusy(true);
+}
 
-    m_process->setProgram(QString::fromLatin1(WPCTL_PROGRAM));
-    m_process->setArguments(command.arguments);
+void MicrophoneControl::setVolume(double volume)
+{
+    const QString text = QStringLiteral("set-volume %1 %2")
+                             .arg(QString::fromLatin1(TARGET_SOURCE))
+                             .arg(volume, 0, 'f', 2);
+
+    const quint64 id = m_devices->setSourceVolume(QString::fromLatin1(TARGET_SOURCE), volume);
+
+    if (id == 0) {
+        // PulseAudio belum siap atau source default belum ada: tunggu applyDeferred()
+        qDebug() << "MicrophoneControl: source default belum ada, volume" << volume << "ditunda";
+        m_volumeDeferred = true;
+        m_deferredVolume = volume;
+        setBusy(true);
+        return;
+    }
 
+    m_volumeDeferred = false;
+    m_pending.insert(id, {CommandType::SetVolume, text});
     setBusy(true);
-    m_process->start();
 }
 
-void MicrophoneControl::onProcessFinished(int exitCode,
-                                          QProcess::ExitStatus exitStatus)
+void MicrophoneControl::getStatus()
 {
-    const QString output =
-        QString::fromUtf8(m_process->readAllStandardOutput()).trimmed();
+    AudioDeviceRegistry::Device device;
+
+    if (m_devices->findSource(QString::fromLatin1(TARGET_SOURCE), &device)) {
+        emitStatus(device);
+        return;
+    }
 
-    const QString errorOutput =
-        QString::fromUtf8(m_process->readAllStandardError()).trimmed();
+    // Registry belum siap: dijawab begitu source default diketahui
+    m_statusRequested = true;
+}
 
-    const CommandType completedType = m_currentType;
-    const QString completedCommand = m_currentCommandText;
+void MicrophoneControl::onOperationFinished(quint64 id, bool ok, const QString &error)
+{
+    const auto it = m_pending.constFind(id);
+    if (it == m_pending.constEnd())
+        return;
 
-    resetCurrentCommand();
+    const PendingCommand command = *it;
+    m_pending.erase(it);
 
-    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
-        const QString errorMessage = errorOutput.isEmpty()
-            ? QStringLiteral("wpctl gagal dengan exit code %1").arg(exitCode)
-            : errorOutput;
+    if (m_pending.isEmpty() && !m_muteDeferred && !m_volumeDeferred)
+        setBusy(false);
 
-        emit commandFailed(completedCommand, errorMessage);
-        startNextCommand();
+    if (!ok) {
+        emit commandFailed(command.text, error);
         return;
     }
 
-    emit commandCompleted(completedCommand, output);
+    emit commandCompleted(command.text, QString());
 
-    switch (completedType) {
+    switch (command.type) {
     case CommandType::Mute:
         emit muteChanged(true);
         break;
@@ -132,72 +156,61 @@ void MicrophoneControl::onProcessFinished(int exitCode,
         emit muteChanged(false);
         break;
 
-    case CommandType::ToggleMute:
-        // Ambil status aktual setelah toggle selesai.
-        m_queue.prepend({
-            {
-                QStringLiteral("get-volume"),
-                QString::fromLatin1(DEFAULT_SOURCE)
-            },
-            CommandType::GetStatus
-        });
-        break;
-
-    case CommandType::GetStatus:
-        parseStatusOutput(output);
+    case CommandType::SetVolume:
+        // Nilai aktual datang lewat sourceChanged dari subscribe
         break;
     }
-
-    startNextCommand();
 }
 
-void MicrophoneControl::onProcessError(QProcess::ProcessError error)
+void MicrophoneControl::onSourceChanged(const AudioDeviceRegistry::Device &device)
 {
-    Q_UNUSED(error)
-
-    const QString failedCommand = m_currentCommandText;
-    const QString errorMessage = m_process->errorString();
+    if (device.name != m_devices->defaultSourceName())
+        return;
 
-    resetCurrentCommand();
+    applyDeferred();
 
-    emit commandFailed(failedCommand, errorMessage);
-    startNextCommand();
+    // Perubahan dari luar aplikasi (atau hasil perintah kita) ikut dilaporkan
+    emitStatus(device);
 }
 
-void MicrophoneControl::parseStatusOutput(const QString &output)
+void MicrophoneControl::onDevicesReady()
 {
-    // Contoh:
-    // Volume: 1.00
-    // Volume: 1.00 [MUTED]
-    static const QRegularExpression volumeRegex(
-        QStringLiteral(R"(Volume:\s*([0-9]+(?:\.[0-9]+)?))"),
-        QRegularExpression::CaseInsensitiveOption);
-
-    const QRegularExpressionMatch match = volumeRegex.match(output);
-
-    if (!match.hasMatch()) {
-        emit commandFailed(
-            QStringLiteral("wpctl get-volume @DEFAULT_AUDIO_SOURCE@"),
-            QStringLiteral("Format output wpctl tidak dikenali: %1").arg(output));
+    applyDeferred();
+
+    if (!m_statusRequested)
         return;
-    }
 
-    bool ok = false;
-    const double volume = match.captured(1).toDouble(&ok);
+    AudioDeviceRegistry::Device device;
+    if (m_devices->findSource(QString::fromLatin1(TARGET_SOURCE), &device)) {
+        emitStatus(device);
+    } else {
+        m_statusRequested = false;
+        emit commandFailed(QStringLiteral("get-volume %1").arg(QString::fromLatin1(TARGET_SOURCE)),
+                           QStringLiteral("Source default tidak ditemukan"));
+    }
+}
 
-    if (!ok) {
-        emit commandFailed(
-            QStringLiteral("wpctl get-volume @DEFAULT_AUDIO_SOURCE@"),
-            QStringLiteral("Nilai volume tidak valid: %1")
-                .arg(match.captured(1)));
+void MicrophoneControl::applyDeferred()
+{
+    if (!m_muteDeferred && !m_volumeDeferred)
         return;
-    }
 
-    const bool muted = output.contains(QStringLiteral("[MUTED]"),
-                                       Qt::CaseInsensitive);
+    // setMuted / setVolume menunda lagi kalau source default masih belum ada
+    if (m_muteDeferred)
+        setMuted(m_deferredMuted, m_deferredMuted ? CommandType::Mute : CommandType::Unmute);
+
+    if (m_volumeDeferred)
+        setVolume(m_deferredVolume);
+
+    setBusy(!m_pending.isEmpty() || m_muteDeferred || m_volumeDeferred);
+}
+
+void MicrophoneControl::emitStatus(const AudioDeviceRegistry::Device &device)
+{
+    m_statusRequested = false;
 
-    emit statusReceived(volume, muted);
-    emit muteChanged(muted);
+    emit statusReceived(device.volume, device.muted);
+    emit muteChanged(device.muted);
 }
 
 void MicrophoneControl::setBusy(bool busy)
@@ -209,13 +222,3 @@ void MicrophoneControl::setBusy(bool busy)
     m_busy = busy;
     emit busyChanged(m_busy);
 }
-
-void MicrophoneControl::resetCurrentCommand()
-{
-    m_hasCurrentCommand = false;
-    m_currentCommandText.clear();
-
-    if (m_queue.isEmpty()) {
-        setBusy(false);
-    }
-}
@@ -1,18 +1,26 @@
 #ifndef MICROPHONECONTROL_H
 #define MICROPHONECONTROL_H
 
+#include <QHash>
 #include <QObject>
-#include <QProcess>
-#include <QQueue>
 #include <QString>
-#include <QStringList>
 
+#include "audiodeviceregistry.h"
+
+/*
+ * Kontrol mute / volume source default lewat AudioDeviceRegistry (API
+ * libpulse langsung, tanpa proses wpctl per perintah). Status dibaca dari
+ * registry yang selalu up to date lewat subscribe, jadi getStatus() dan
+ * mute yang tidak mengubah apa-apa tidak menyentuh server sama sekali.
+ * Mute / volume yang diminta sebelum registry siap disimpan (permintaan
+ * terakhir menang) dan diterapkan begitu source default muncul.
+ */
 class MicrophoneControl : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit MicrophoneControl(QObject *parent = nullptr);
+    explicit MicrophoneControl(AudioDeviceRegistry *devices, QObject *parent = nullptr);
     ~MicrophoneControl() override;
 
     bool isBusy() const;
@@ -21,6 +29,7 @@ public slots:
     void mute();
     void unmute();
     void toggleMute();
+    void setVolume(double volume);
     void getStatus();
 
 signals:
@@ -31,36 +40,40 @@ signals:
     void busyChanged(bool busy);
 
 private slots:
-    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    void onProcessError(QProcess::ProcessError error);
+    void onOperationFinished(quint64 id, bool ok, const QString &error);
+    void onSourceChanged(const AudioDeviceRegistry::Device &device);
+    void onDevicesReady();
 
 private:
     enum class CommandType
     {
         Mute,
         Unmute,
-        ToggleMute,
-        GetStatus
+        SetVolume
     };
 
     struct PendingCommand
     {
-        QStringList arguments;
         CommandType type;
+        QString text;
     };
 
-    void enqueueCommand(const QStringList &arguments, CommandType type);
-    void startNextCommand();
-    void parseStatusOutput(const QString &output);
+    void setMuted(bool muted, CommandType type);
+    void applyDeferred();
+    void emitStatus(const AudioDeviceRegistry::Device &device);
     void setBusy(bool busy);
-    void resetCurrentCommand();
 
-    QProcess *m_process = nullptr;
-    QQueue<PendingCommand> m_queue;
+    AudioDeviceRegistry *m_devices = nullptr;
+    QHash<quint64, PendingCommand> m_pending;
+
+    bool m_statusRequested = false;
+
+    // State yang diminta saat registry belum siap / source default belum ada
+    bool m_muteDeferred = false;
+    bool m_deferredMuted = false;
+    bool m_volumeDeferred = false;
+    double m_deferredVolume = 0.0;
 
-    CommandType m_currentType = CommandType::GetStatus;
-    QString m_currentCommandText;
-    bool m_hasCurrentCommand = false;
     bool m_busy = false;
 };
 
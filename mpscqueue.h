@@ -0,0 +1,108 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/*
+ * Queue multi-producer / single-consumer tanpa lock (intrusive, stub node).
+ *
+ * push() aman dari thread mana pun dan wait-free (satu exchange atomik).
+ * pop() hanya boleh dipanggil dari satu thread konsumen. Saat producer
+ * sedang di tengah push(), pop() bisa sesaat mengembalikan false walau
+ * item sudah "masuk"; konsumen cukup mencoba lagi di wakeup berikutnya.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue()
+        : m_head(&m_stub)
+        , m_tail(&m_stub)
+    {
+    }
+
+    ~MpscQueue()
+    {
+        T discard;
+        while (pop(discard)) {
+        }
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    void push(T value)
+    {
+        Node *node = new Node(std::move(value));
+        pushNode(node);
+    }
+
+    bool pop(T &out)
+    {
+        Node *tail = m_tail;
+        Node *next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (!next)
+                return false;
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail = next;
+            out = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+
+        // tail adalah node terakhir; kalau head belum bergerak, sisipkan stub
+        // supaya tail bisa dilepas.
+        if (tail != m_head.load(std::memory_order_acquire))
+            return false;
+
+        pushNode(&m_stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+
+        m_tail = next;
+        out = std::move(tail->value);
+        delete tail;
+        return true;
+    }
+
+    // Perkiraan dari sisi konsumen saja.
+    bool isEmpty() const
+    {
+        return m_tail == &m_stub && !m_stub.next.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T v)
+            : value(std::move(v))
+        {
+        }
+
+        std::atomic<Node *> next{nullptr};
+        T value{};
+    };
+
+    void pushNode(Node *node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node *prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    Node m_stub;
+    std::atomic<Node *> m_head; // sisi producer
+    Node *m_tail;               // sisi konsumen
+};
+
+#endif // MPSCQUEUE_H
@@ -1,16 +1,57 @@
 #include "payloadprocessor.h"
 #include <QtEndian>
+#include "acousticdetector.h"
+#include "falllatency.h"
+#include "metrics.h"
+#include "traceevent.h"
 //#include <qDebug>
 
 PayloadProcessor::PayloadProcessor(const QString &id, QObject *parent)
     : QObject(parent), m_id(id)
 {
+    qRegisterMetaType<QVector<RadarTarget>>("QVector<RadarTarget>");
 }
 
 PayloadProcessor::~PayloadProcessor(){
 
 }
 
+//---------------------------------------------------------------------------------------
+void PayloadProcessor::emitTargetFrame()
+{
+    const int interval = m_targetStreamIntervalMs.load(std::memory_order_relaxed);
+
+    // Streaming mati: tidak ada alokasi / signal antar thread.
+    if (interval <= 0)
+        return;
+
+    if (m_targetStreamTimer.isValid() && m_targetStreamTimer.elapsed() < interval)
+        return;
+
+    m_targetStreamTimer.start();
+
+    QVector<RadarTarget> frame;
+    frame.reserve(TARGET_COUNT_SIZE);
+
+    for (int i = 0; i < TARGET_COUNT_SIZE; ++i) {
+        const TargetInfo &t = targets[i];
+
+        if (!t.valid || t.historyCount == 0)
+            continue;
+
+        RadarTarget rt;
+        rt.trackId = quint8(t.trackId);
+        rt.x = t.x[HISTORY_SIZE - 1];
+        rt.y = t.y[HISTORY_SIZE - 1];
+        rt.height = t.height[HISTORY_SIZE - 1];
+        rt.velocity = t.velocity[HISTORY_SIZE - 1];
+        rt.state = t.state;
+        frame.append(rt);
+    }
+
+    emit targetFrame(m_id, frame);
+}
+
 //---------------------------------------------------------------------------------------
 void PayloadProcessor::initPort(const QString &portName)
 {
@@ -92,9 +133,13 @@ void PayloadProcessor::readData()
 {
     if (!m_serial) return;
 
+    m_lastRxNs = trace::nowNs();
     const QByteArray data = m_serial->readAll();
     if (data.isEmpty()) return;
 
+    TRACE_SCOPE("radar.readData");
+    METRIC_COUNTER("radar.rx_bytes").inc(quint64(data.size()));
+
     m_buffer.append(data);
 
     while (true) {
@@ -119,9 +164,12 @@ void PayloadProcessor::readData()
 
         if (cs != recvCs) {
             //emit debugMessage("[ERR] checksum mismatch");
+            METRIC_COUNTER("radar.checksum_errors").inc();
             continue;
         }
 
+        METRIC_COUNTER("radar.frames").inc();
+
         QByteArray payload = frame.mid(2, frame.size() - 5);
         enqueuePayload(payload);
     }
@@ -651,6 +699,8 @@ void PayloadProcessor::processQueue()
                          anyFalling = true;
                  }
 
+                 emitTargetFrame();
+
                  break;
              }
 
@@ -698,7 +748,8 @@ void PayloadProcessor::processQueue()
                 //qDebug() << "83 01 Fall =" << payload;
 
                 if (val == 1) {
-                    emit fallDetected(m_id);  // UI thread will handle sound & socket
+                    const quint64 latencyId = FallLatencyTracker::instance().begin(m_lastRxNs, trace::nowNs());
+                    emit fallDetected(m_id, latencyId);  // UI thread will handle sound & socket
                 }
                 break;
             }
@@ -1175,6 +1226,8 @@ void PayloadProcessor::decisionFall(TargetInfo &t)
     if(!t.valid)
         return;
 
+    const qint64 decisionNs = trace::nowNs();
+
     //---------------------------------
     // Ambil data terbaru
     //---------------------------------
@@ -1260,10 +1313,18 @@ void PayloadProcessor::decisionFall(TargetInfo &t)
 
         //qDebug() << "konfirmasi hampir jatuh "<< fallMs<< "-"<< lowMs;
 
+        // Fusi akustik: benturan / teriakan di sekitar awal jatuh memperpendek tunggu
+        const qint64 fallStartNs = decisionNs - fallMs * 1000000LL;
+        const bool acoustic = AcousticEventDetector::eventSince(fallStartNs - ACOUSTIC_LEAD_MS * 1000000LL);
+        const qint64 confirmMs = acoustic ? FALL_CONFIRM_ACOUSTIC_MS : FALL_CONFIRM_LOW_MS;
+
         if(fallMs > 300 &&
-           lowMs > 5000){
+           lowMs > confirmMs){
+            if(acoustic && lowMs <= FALL_CONFIRM_LOW_MS)
+                METRIC_COUNTER("fall.acoustic_confirmed").inc();
             //emit fallAlarm(t.trackId);
-            emit fallDetected(QString(t.trackId));  // UI thread will handle sound & socket
+            const quint64 latencyId = FallLatencyTracker::instance().begin(m_lastRxNs, decisionNs);
+            emit fallDetected(QString(t.trackId), latencyId);  // UI thread will handle sound & socket
             //qDebug() << "FALL CONFIRMED "<< t.trackId;
             resetFallState(t);
             t.state = StateLying;
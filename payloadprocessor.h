@@ -8,10 +8,20 @@
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QDateTime>
+#include <QVector>
+
+#include <atomic>
 
 constexpr int HISTORY_SIZE = 40;
 constexpr int TARGET_COUNT_SIZE = 20;
 
+// Konfirmasi fall: lama posisi rendah sebelum alarm. Kalau ada event akustik
+// (benturan / teriakan, AcousticEventDetector) sejak ACOUSTIC_LEAD_MS sebelum
+// kandidat jatuh dimulai, cukup FALL_CONFIRM_ACOUSTIC_MS.
+constexpr qint64 FALL_CONFIRM_LOW_MS = 5000;
+constexpr qint64 FALL_CONFIRM_ACOUSTIC_MS = 1500;
+constexpr qint64 ACOUSTIC_LEAD_MS = 1500;
+
 enum TargetState
 {
     StateUnknown = 0,
@@ -53,6 +63,20 @@ struct TargetInfo
     QElapsedTimer hiddenStableTimer;
 };
 
+// Snapshot satu target untuk streaming ke backend (lihat RadarStreamer).
+struct RadarTarget
+{
+    quint8 trackId = 0;
+    qint16 x = 0;          // satuan mentah dari frame 0x82/0x02
+    qint16 y = 0;
+    qint16 height = 0;
+    qint16 velocity = 0;
+    quint8 state = StateUnknown;
+};
+
+Q_DECLARE_METATYPE(RadarTarget)
+Q_DECLARE_METATYPE(QVector<RadarTarget>)
+
 
 class PayloadProcessor : public QObject {
     Q_OBJECT
@@ -60,6 +84,10 @@ public:
     explicit PayloadProcessor(const QString &id, QObject *parent = nullptr);
     ~PayloadProcessor();
 
+    // Thread-safe. 0 = streaming target mati (default), selain itu interval
+    // minimum (ms) antar emit targetFrame.
+    void setTargetStreamInterval(int ms) { m_targetStreamIntervalMs.store(ms, std::memory_order_relaxed); }
+
 public slots:
     void initPort(const QString &portName);
     void readData();
@@ -75,9 +103,10 @@ signals:
     void debugMessage(const QString &msg);
     void serialOpened(bool ok);
     void serialError(const QString &err);
-    void fallDetected(const QString &source);   // trigger sound / socket
+    void fallDetected(const QString &source, quint64 latencyId = 0);   // trigger sound / socket
     void fallCancel(const QString &source);     //ga jadi fall
     void heartBeat(const QString &source);
+    void targetFrame(const QString &source, const QVector<RadarTarget> &targets);
 
 private:
     void processQueue();
@@ -116,4 +145,10 @@ private:
 
     QElapsedTimer fpsTimer;
     int frameCount = 0;
+
+    qint64 m_lastRxNs = 0;      // waktu chunk UART terakhir (trace::nowNs)
+
+    std::atomic<int> m_targetStreamIntervalMs{0};
+    QElapsedTimer m_targetStreamTimer;
+    void emitTargetFrame();
 };
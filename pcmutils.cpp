@@ -0,0 +1,543 @@
+#include "pcmutils.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define PCM_NEON 1
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+    #define PCM_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define PCM_SSE2 1
+#endif
+
+namespace pcm {
+
+namespace {
+
+constexpr float S16_SCALE = 1.0f / 32768.0f;
+
+// Akumulator float per blok, dijumlah ke double: presisi tetap baik untuk
+// buffer panjang tanpa bayar lane double di loop utama
+constexpr int LEVEL_BLOCK = 1024;
+
+// Buffer stack untuk levels(int16): konversi per potongan lalu kernel float
+constexpr int S16_CHUNK = 256;
+
+struct BlockLevels {
+    float sum = 0.0f;
+    float sumSq = 0.0f;
+    float peak = 0.0f;
+    quint32 clipped = 0;
+};
+
+//---------------------------------------------------------------------------------------
+// Tail / fallback scalar
+//---------------------------------------------------------------------------------------
+inline void s16ToFloatScalar(const qint16 *in, float *out, int n)
+{
+    for (int i = 0; i < n; ++i)
+        out[i] = float(in[i]) * S16_SCALE;
+}
+
+inline void floatToS16Scalar(const float *in, qint16 *out, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        const float v = std::min(std::max(in[i] * 32768.0f, -32768.0f), 32767.0f);
+        out[i] = qint16(std::lrintf(v));
+    }
+}
+
+inline quint32 saturateScalar(const qint32 *in, qint16 *out, int n)
+{
+    quint32 clipped = 0;
+    for (int i = 0; i < n; ++i) {
+        const qint32 s = in[i];
+        clipped += (s > 32767 || s < -32768) ? 1u : 0u;
+        out[i] = qint16(std::min(std::max(s, -32768), 32767));
+    }
+    return clipped;
+}
+
+inline void levelsScalar(const float *x, int n, float clipLevel, BlockLevels &b)
+{
+    for (int i = 0; i < n; ++i) {
+        const float v = x[i];
+        const float a = std::abs(v);
+
+        b.sum += v;
+        b.sumSq += v * v;
+        b.peak = std::max(b.peak, a);
+        b.clipped += a >= clipLevel ? 1u : 0u;
+    }
+}
+
+inline void removeDcScalar(float *x, int n, float dc)
+{
+    for (int i = 0; i < n; ++i)
+        x[i] -= dc;
+}
+
+inline void multiplyScalar(const float *a, const float *b, float *out, int n)
+{
+    for (int i = 0; i < n; ++i)
+        out[i] = a[i] * b[i];
+}
+
+#if defined(PCM_NEON)
+//---------------------------------------------------------------------------------------
+// NEON (aarch64)
+//---------------------------------------------------------------------------------------
+const char *const KERNEL = "neon";
+
+void s16ToFloatKernel(const qint16 *in, float *out, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = vld1q_s16(in + i);
+        vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), S16_SCALE));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), S16_SCALE));
+    }
+    s16ToFloatScalar(in + i, out + i, n - i);
+}
+
+void floatToS16Kernel(const float *in, qint16 *out, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // vcvtnq: round-to-nearest-even dan saturasi int32; vqmovn saturasi ke int16
+        const int32x4_t lo = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(in + i), 32768.0f));
+        const int32x4_t hi = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(in + i + 4), 32768.0f));
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+    floatToS16Scalar(in + i, out + i, n - i);
+}
+
+quint32 saturateKernel(const qint32 *in, qint16 *out, int n)
+{
+    const int32x4_t maxV = vdupq_n_s32(32767);
+    const int32x4_t minV = vdupq_n_s32(-32768);
+    uint32x4_t clipped = vdupq_n_u32(0);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int32x4_t lo = vld1q_s32(in + i);
+        const int32x4_t hi = vld1q_s32(in + i + 4);
+
+        // Mask perbandingan bernilai ~0 (= -1): dikurangkan = +1 per lane
+        clipped = vsubq_u32(clipped, vorrq_u32(vcgtq_s32(lo, maxV), vcltq_s32(lo, minV)));
+        clipped = vsubq_u32(clipped, vorrq_u32(vcgtq_s32(hi, maxV), vcltq_s32(hi, minV)));
+
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+
+    return vaddvq_u32(clipped) + saturateScalar(in + i, out + i, n - i);
+}
+
+void levelsKernel(const float *x, int n, float clipLevel, BlockLevels &b)
+{
+    const float32x4_t clip = vdupq_n_f32(clipLevel);
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    float32x4_t sumSq = vdupq_n_f32(0.0f);
+    float32x4_t peak = vdupq_n_f32(0.0f);
+    uint32x4_t clipped = vdupq_n_u32(0);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t v = vld1q_f32(x + i);
+        const float32x4_t a = vabsq_f32(v);
+
+        sum = vaddq_f32(sum, v);
+        sumSq = vfmaq_f32(sumSq, v, v);
+        peak = vmaxq_f32(peak, a);
+        clipped = vsubq_u32(clipped, vcgeq_f32(a, clip));
+    }
+
+    b.sum += vaddvq_f32(sum);
+    b.sumSq += vaddvq_f32(sumSq);
+    b.peak = std::max(b.peak, vmaxvq_f32(peak));
+    b.clipped += vaddvq_u32(clipped);
+
+    levelsScalar(x + i, n - i, clipLevel, b);
+}
+
+void removeDcKernel(float *x, int n, float dc)
+{
+    const float32x4_t d = vdupq_n_f32(dc);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(x + i, vsubq_f32(vld1q_f32(x + i), d));
+    removeDcScalar(x + i, n - i, dc);
+}
+
+void multiplyKernel(const float *a, const float *b, float *out, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(out + i, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    multiplyScalar(a + i, b + i, out + i, n - i);
+}
+
+#elif defined(PCM_AVX2)
+//---------------------------------------------------------------------------------------
+// AVX2 (x86, -mavx2)
+//---------------------------------------------------------------------------------------
+const char *const KERNEL = "avx2";
+
+inline float hsum(__m256 v)
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+inline float hmax(__m256 v)
+{
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+inline quint32 hsumU32(__m256i v)
+{
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return quint32(_mm_cvtsi128_si32(s));
+}
+
+void s16ToFloatKernel(const qint16 *in, float *out, int n)
+{
+    const __m256 scale = _mm256_set1_ps(S16_SCALE);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    s16ToFloatScalar(in + i, out + i, n - i);
+}
+
+void floatToS16Kernel(const float *in, qint16 *out, int n)
+{
+    const __m256 scale = _mm256_set1_ps(32768.0f);
+    const __m256 lo = _mm256_set1_ps(-32768.0f);
+    const __m256 hi = _mm256_set1_ps(32767.0f);
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        // Clamp dulu: cvtps di luar range int32 menghasilkan INT_MIN
+        const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale), lo), hi);
+        const __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale), lo), hi);
+
+        // packs bekerja per lane 128-bit: susun ulang qword 0,2,1,3
+        const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    floatToS16Scalar(in + i, out + i, n - i);
+}
+
+quint32 saturateKernel(const qint32 *in, qint16 *out, int n)
+{
+    const __m256i maxV = _mm256_set1_epi32(32767);
+    const __m256i minV = _mm256_set1_epi32(-32768);
+    __m256i clipped = _mm256_setzero_si256();
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + 8));
+
+        clipped = _mm256_sub_epi32(clipped, _mm256_or_si256(_mm256_cmpgt_epi32(a, maxV), _mm256_cmpgt_epi32(minV, a)));
+        clipped = _mm256_sub_epi32(clipped, _mm256_or_si256(_mm256_cmpgt_epi32(b, maxV), _mm256_cmpgt_epi32(minV, b)));
+
+        const __m256i packed = _mm256_packs_epi32(a, b);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+
+    return hsumU32(clipped) + saturateScalar(in + i, out + i, n - i);
+}
+
+void levelsKernel(const float *x, int n, float clipLevel, BlockLevels &b)
+{
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 clip = _mm256_set1_ps(clipLevel);
+    __m256 sum = _mm256_setzero_ps();
+    __m256 sumSq = _mm256_setzero_ps();
+    __m256 peak = _mm256_setzero_ps();
+    __m256i clipped = _mm256_setzero_si256();
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(x + i);
+        const __m256 a = _mm256_and_ps(v, absMask);
+
+        sum = _mm256_add_ps(sum, v);
+        sumSq = _mm256_add_ps(sumSq, _mm256_mul_ps(v, v));
+        peak = _mm256_max_ps(peak, a);
+        clipped = _mm256_sub_epi32(clipped, _mm256_castps_si256(_mm256_cmp_ps(a, clip, _CMP_GE_OQ)));
+    }
+
+    b.sum += hsum(sum);
+    b.sumSq += hsum(sumSq);
+    b.peak = std::max(b.peak, hmax(peak));
+    b.clipped += hsumU32(clipped);
+
+    levelsScalar(x + i, n - i, clipLevel, b);
+}
+
+void removeDcKernel(float *x, int n, float dc)
+{
+    const __m256 d = _mm256_set1_ps(dc);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(x + i, _mm256_sub_ps(_mm256_loadu_ps(x + i), d));
+    removeDcScalar(x + i, n - i, dc);
+}
+
+void multiplyKernel(const float *a, const float *b, float *out, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    multiplyScalar(a + i, b + i, out + i, n - i);
+}
+
+#elif defined(PCM_SSE2)
+//---------------------------------------------------------------------------------------
+// SSE2 (baseline x86-64)
+//---------------------------------------------------------------------------------------
+const char *const KERNEL = "sse2";
+
+inline float hsum(__m128 s)
+{
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+inline float hmax(__m128 m)
+{
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+inline quint32 hsumU32(__m128i s)
+{
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return quint32(_mm_cvtsi128_si32(s));
+}
+
+void s16ToFloatKernel(const qint16 *in, float *out, int n)
+{
+    const __m128 scale = _mm_set1_ps(S16_SCALE);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+
+        // Sign-extend int16 -> int32 tanpa SSE4.1: unpack ke word atas lalu geser aritmetik
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    s16ToFloatScalar(in + i, out + i, n - i);
+}
+
+void floatToS16Kernel(const float *in, qint16 *out, int n)
+{
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 lo = _mm_set1_ps(-32768.0f);
+    const __m128 hi = _mm_set1_ps(32767.0f);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // Clamp dulu: cvtps di luar range int32 menghasilkan INT_MIN
+        const __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), lo), hi);
+        const __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale), lo), hi);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                         _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+    floatToS16Scalar(in + i, out + i, n - i);
+}
+
+quint32 saturateKernel(const qint32 *in, qint16 *out, int n)
+{
+    const __m128i maxV = _mm_set1_epi32(32767);
+    const __m128i minV = _mm_set1_epi32(-32768);
+    __m128i clipped = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 4));
+
+        clipped = _mm_sub_epi32(clipped, _mm_or_si128(_mm_cmpgt_epi32(a, maxV), _mm_cmplt_epi32(a, minV)));
+        clipped = _mm_sub_epi32(clipped, _mm_or_si128(_mm_cmpgt_epi32(b, maxV), _mm_cmplt_epi32(b, minV)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(a, b));
+    }
+
+    return hsumU32(clipped) + saturateScalar(in + i, out + i, n - i);
+}
+
+void levelsKernel(const float *x, int n, float clipLevel, BlockLevels &b)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 clip = _mm_set1_ps(clipLevel);
+    __m128 sum = _mm_setzero_ps();
+    __m128 sumSq = _mm_setzero_ps();
+    __m128 peak = _mm_setzero_ps();
+    __m128i clipped = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 v = _mm_loadu_ps(x + i);
+        const __m128 a = _mm_and_ps(v, absMask);
+
+        sum = _mm_add_ps(sum, v);
+        sumSq = _mm_add_ps(sumSq, _mm_mul_ps(v, v));
+        peak = _mm_max_ps(peak, a);
+        clipped = _mm_sub_epi32(clipped, _mm_castps_si128(_mm_cmpge_ps(a, clip)));
+    }
+
+    b.sum += hsum(sum);
+    b.sumSq += hsum(sumSq);
+    b.peak = std::max(b.peak, hmax(peak));
+    b.clipped += hsumU32(clipped);
+
+    levelsScalar(x + i, n - i, clipLevel, b);
+}
+
+void removeDcKernel(float *x, int n, float dc)
+{
+    const __m128 d = _mm_set1_ps(dc);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(x + i, _mm_sub_ps(_mm_loadu_ps(x + i), d));
+    removeDcScalar(x + i, n - i, dc);
+}
+
+void multiplyKernel(const float *a, const float *b, float *out, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    multiplyScalar(a + i, b + i, out + i, n - i);
+}
+
+#else
+//---------------------------------------------------------------------------------------
+// Scalar
+//---------------------------------------------------------------------------------------
+const char *const KERNEL = "scalar";
+
+void s16ToFloatKernel(const qint16 *in, float *out, int n) { s16ToFloatScalar(in, out, n); }
+void floatToS16Kernel(const float *in, qint16 *out, int n) { floatToS16Scalar(in, out, n); }
+quint32 saturateKernel(const qint32 *in, qint16 *out, int n) { return saturateScalar(in, out, n); }
+void levelsKernel(const float *x, int n, float clipLevel, BlockLevels &b) { levelsScalar(x, n, clipLevel, b); }
+void removeDcKernel(float *x, int n, float dc) { removeDcScalar(x, n, dc); }
+void multiplyKernel(const float *a, const float *b, float *out, int n) { multiplyScalar(a, b, out, n); }
+
+#endif
+
+inline void accumulate(Levels &l, const BlockLevels &b)
+{
+    l.sum += b.sum;
+    l.sumSq += b.sumSq;
+    l.peak = std::max(l.peak, b.peak);
+    l.clipped += b.clipped;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------------------
+const char *kernelName()
+{
+    return KERNEL;
+}
+
+//---------------------------------------------------------------------------------------
+void s16ToFloat(const qint16 *in, float *out, int n)
+{
+    if (n > 0)
+        s16ToFloatKernel(in, out, n);
+}
+
+//---------------------------------------------------------------------------------------
+void floatToS16(const float *in, qint16 *out, int n)
+{
+    if (n > 0)
+        floatToS16Kernel(in, out, n);
+}
+
+//---------------------------------------------------------------------------------------
+quint32 saturateS32ToS16(const qint32 *in, qint16 *out, int n)
+{
+    return n > 0 ? saturateKernel(in, out, n) : 0;
+}
+
+//---------------------------------------------------------------------------------------
+Levels levels(const float *x, int n, float clipLevel)
+{
+    Levels l;
+
+    for (int i = 0; i < n; i += LEVEL_BLOCK) {
+        BlockLevels b;
+        levelsKernel(x + i, std::min(LEVEL_BLOCK, n - i), clipLevel, b);
+        accumulate(l, b);
+    }
+
+    return l;
+}
+
+//---------------------------------------------------------------------------------------
+Levels levels(const qint16 *x, int n, float clipLevel)
+{
+    Levels l;
+    float buf[S16_CHUNK];
+
+    for (int i = 0; i < n; i += S16_CHUNK) {
+        const int take = std::min(S16_CHUNK, n - i);
+        s16ToFloatKernel(x + i, buf, take);
+
+        BlockLevels b;
+        levelsKernel(buf, take, clipLevel, b);
+        accumulate(l, b);
+    }
+
+    return l;
+}
+
+//---------------------------------------------------------------------------------------
+void removeDc(float *x, int n, float dc)
+{
+    if (n > 0)
+        removeDcKernel(x, n, dc);
+}
+
+//---------------------------------------------------------------------------------------
+void multiply(const float *a, const float *b, float *out, int n)
+{
+    if (n > 0)
+        multiplyKernel(a, b, out, n);
+}
+
+//---------------------------------------------------------------------------------------
+double toDbfs(double linear, double floorDb)
+{
+    if (linear <= 0.0)
+        return floorDb;
+
+    return std::max(floorDb, 20.0 * std::log10(linear));
+}
+
+} // namespace pcm
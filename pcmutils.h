@@ -0,0 +1,50 @@
+#ifndef PCMUTILS_H
+#define PCMUTILS_H
+
+#include <QtGlobal>
+
+/*
+ * Utilitas PCM bersama: konversi int16 <-> float, level (peak / RMS / DC /
+ * clipping), saturasi mixer, DC removal dan perkalian per sampel.
+ *
+ * Kernel dipilih saat compile: NEON (aarch64, RPi5), AVX2 (x86 yang di-build
+ * dengan -mavx2), SSE2 (x86-64), selain itu scalar. Hasil semua kernel sama
+ * kecuali urutan penjumlahan float (selisih pembulatan di sum / sumSq).
+ *
+ * Float dalam skala [-1, 1): int16 / 32768.
+ */
+namespace pcm {
+
+struct Levels {
+    double sum = 0.0;           // DC offset = sum / n
+    double sumSq = 0.0;         // RMS = sqrt(sumSq / n)
+    float peak = 0.0f;          // max |x|
+    quint32 clipped = 0;        // jumlah |x| >= clipLevel
+};
+
+// Nama kernel aktif: "neon", "avx2", "sse2" atau "scalar"
+const char *kernelName();
+
+void s16ToFloat(const qint16 *in, float *out, int n);
+
+// Dibulatkan ke terdekat, saturasi ke [-32768, 32767]
+void floatToS16(const float *in, qint16 *out, int n);
+
+// Accumulator mixer int32 -> S16 dengan saturasi; mengembalikan jumlah sampel yang terpotong
+quint32 saturateS32ToS16(const qint32 *in, qint16 *out, int n);
+
+Levels levels(const float *x, int n, float clipLevel = 1.0f);
+Levels levels(const qint16 *x, int n, float clipLevel = 1.0f);
+
+// x[i] -= dc (in-place boleh)
+void removeDc(float *x, int n, float dc);
+
+// out[i] = a[i] * b[i] (window, gain per sampel); out boleh sama dengan a
+void multiply(const float *a, const float *b, float *out, int n);
+
+// 20*log10(linear), dibatasi floorDb
+double toDbfs(double linear, double floorDb = -120.0);
+
+} // namespace pcm
+
+#endif // PCMUTILS_H
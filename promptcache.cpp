@@ -0,0 +1,233 @@
+#include "promptcache.h"
+
+#include "audioworker.h"
+#include "pcmutils.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QVector>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+
+//---------------------------------------------------------------------------------------
+QString PromptCache::fileNameFor(int sentenceIndex)
+{
+    switch (sentenceIndex) {
+    case SOUND_FALL_OCCUR:    return QStringLiteral("fall.wav");
+    case SOUND_HELP:          return QStringLiteral("help.wav");
+    case SOUND_IAM_OK:        return QStringLiteral("iam_ok.wav");
+    case SOUND_RECORD:        return QStringLiteral("record.wav");
+    case SOUND_WAITING:       return QStringLiteral("wait.wav");
+    case SOUND_HELPYOU:       return QStringLiteral("helpyou.wav");
+    case SOUND_LOGIN:         return QStringLiteral("login.mp3");
+    case SOUND_UPLOAD_FAILED: return QStringLiteral("fail.wav");
+    default:                  return QString();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+QString PromptCache::key(int sentenceIndex, const QString &lang)
+{
+    return lang + QLatin1Char('/') + QString::number(sentenceIndex);
+}
+
+//---------------------------------------------------------------------------------------
+bool PromptCache::openPack(const QString &path)
+{
+    if (!QFile::exists(path))
+        return false;
+
+    QString error;
+    if (!m_pack.open(path, &error)) {
+        qWarning() << "PromptCache: pack tidak bisa dipakai" << path << error;
+        return false;
+    }
+
+    if (m_pack.sampleRate() != SAMPLE_RATE || m_pack.channels() != CHANNELS) {
+        qWarning() << "PromptCache: format pack" << m_pack.sampleRate() << "Hz" << m_pack.channels()
+                   << "ch tidak cocok dengan engine, pakai WAV";
+        m_pack.close();
+        return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+int PromptCache::load(const QString &basePath, const QStringList &languages)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int loaded = 0;
+    int fromPack = 0;
+
+    const bool havePack = openPack(basePath + QLatin1Char('/') + QLatin1String(PromptPack::FILE_NAME));
+
+    for (const QString &lang : languages) {
+        for (int index = SOUND_FALL_OCCUR; index <= SOUND_UPLOAD_FAILED; ++index) {
+            if (havePack) {
+                // Zero-copy: QByteArray menunjuk langsung ke halaman mapping
+                const QByteArray mapped = m_pack.pcm(index, lang);
+                if (!mapped.isEmpty()) {
+                    m_prompts.insert(key(index, lang), mapped);
+                    fromPack++;
+                    loaded++;
+                    continue;
+                }
+            }
+
+            const QString name = fileNameFor(index);
+            if (!name.endsWith(QLatin1String(".wav")))
+                continue;
+
+            QFile file(basePath + QLatin1Char('/') + lang + QLatin1Char('/') + name);
+            if (!file.open(QIODevice::ReadOnly)) {
+                qWarning() << "PromptCache: tidak bisa membuka" << file.fileName();
+                continue;
+            }
+
+            QByteArray pcm;
+            QString error;
+            if (!decodeWav(file.readAll(), pcm, &error)) {
+                qWarning() << "PromptCache: decode gagal" << file.fileName() << error;
+                continue;
+            }
+
+            m_totalBytes += pcm.size();
+            m_prompts.insert(key(index, lang), pcm);
+            loaded++;
+        }
+    }
+
+    qDebug() << "PromptCache:" << loaded << "prompt (" << fromPack << "dari pack),"
+             << m_totalBytes / 1024 << "KiB decode dalam" << timer.elapsed() << "ms";
+
+    return loaded;
+}
+
+//---------------------------------------------------------------------------------------
+QByteArray PromptCache::pcm(int sentenceIndex, const QString &lang) const
+{
+    return m_prompts.value(key(sentenceIndex, lang));
+}
+
+//---------------------------------------------------------------------------------------
+bool PromptCache::contains(int sentenceIndex, const QString &lang) const
+{
+    return m_prompts.contains(key(sentenceIndex, lang));
+}
+
+//---------------------------------------------------------------------------------------
+bool PromptCache::decodeWav(const QByteArray &file, QByteArray &out, QString *error)
+{
+    auto fail = [error](const char *msg) {
+        if (error)
+            *error = QString::fromLatin1(msg);
+        return false;
+    };
+
+    const uchar *p = reinterpret_cast<const uchar *>(file.constData());
+    const qsizetype size = file.size();
+
+    if (size < 12 || std::memcmp(p, "RIFF", 4) != 0 || std::memcmp(p + 8, "WAVE", 4) != 0)
+        return fail("bukan RIFF/WAVE");
+
+    quint16 format = 0;
+    quint16 channels = 0;
+    quint32 rate = 0;
+    quint16 bits = 0;
+    const uchar *data = nullptr;
+    qsizetype dataSize = 0;
+
+    qsizetype pos = 12;
+    while (pos + 8 <= size) {
+        const uchar *chunk = p + pos;
+        const quint32 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        const qsizetype body = pos + 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && body + 16 <= size) {
+            format = qFromLittleEndian<quint16>(p + body);
+            channels = qFromLittleEndian<quint16>(p + body + 2);
+            rate = qFromLittleEndian<quint32>(p + body + 4);
+            bits = qFromLittleEndian<quint16>(p + body + 14);
+
+            // WAVE_FORMAT_EXTENSIBLE: subformat GUID diawali kode format asli
+            if (format == 0xFFFE && chunkSize >= 26 && body + 26 <= size)
+                format = qFromLittleEndian<quint16>(p + body + 24);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            data = p + body;
+            dataSize = qMin<qsizetype>(chunkSize, size - body);
+            break;
+        }
+
+        pos = body + chunkSize + (chunkSize & 1);
+    }
+
+    if (!data || channels == 0 || rate == 0)
+        return fail("chunk fmt/data tidak lengkap");
+
+    const bool isFloat = format == 3 && bits == 32;
+    if (!(format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) && !isFloat)
+        return fail("format sampel tidak didukung");
+
+    const int bytesPerSample = bits / 8;
+    const int frameBytes = bytesPerSample * channels;
+    const qsizetype frames = dataSize / frameBytes;
+
+    // 1. Downmix ke mono float
+    QVector<float> mono(frames);
+    for (qsizetype i = 0; i < frames; ++i) {
+        const uchar *f = data + i * frameBytes;
+        float sum = 0.0f;
+
+        for (int c = 0; c < channels; ++c) {
+            const uchar *s = f + c * bytesPerSample;
+            float v;
+
+            if (isFloat) {
+                quint32 u = qFromLittleEndian<quint32>(s);
+                std::memcpy(&v, &u, sizeof(v));
+            } else if (bits == 8) {
+                v = (float(*s) - 128.0f) / 128.0f;
+            } else if (bits == 16) {
+                v = float(qFromLittleEndian<qint16>(s)) / 32768.0f;
+            } else if (bits == 24) {
+                const qint32 x = qint32(quint32(s[0]) << 8 | quint32(s[1]) << 16 | quint32(s[2]) << 24) >> 8;
+                v = float(x) / 8388608.0f;
+            } else {
+                v = float(qFromLittleEndian<qint32>(s)) / 2147483648.0f;
+            }
+
+            sum += v;
+        }
+
+        mono[i] = sum / channels;
+    }
+
+    // 2. Resample linear ke SAMPLE_RATE (sekali saat load, kualitas cukup untuk suara)
+    if (rate != quint32(SAMPLE_RATE)) {
+        const qsizetype outFrames = qsizetype((double(frames) * SAMPLE_RATE) / rate);
+        const double ratio = double(rate) / SAMPLE_RATE;
+
+        QVector<float> resampled(outFrames);
+        for (qsizetype i = 0; i < outFrames; ++i) {
+            const double srcPos = i * ratio;
+            const qsizetype i0 = qsizetype(srcPos);
+            const qsizetype i1 = qMin(i0 + 1, frames - 1);
+            const float frac = float(srcPos - double(i0));
+            resampled[i] = mono[i0] + (mono[i1] - mono[i0]) * frac;
+        }
+
+        mono.swap(resampled);
+    }
+
+    // 3. Float -> S16 (bulat + saturasi)
+    out.resize(mono.size() * BYTES_PER_FRAME);
+    pcm::floatToS16(mono.constData(), reinterpret_cast<qint16 *>(out.data()), int(mono.size()));
+
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef PROMPTCACHE_H
+#define PROMPTCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include "promptpack.h"
+
+/*
+ * Cache PCM prompt suara di memory.
+ *
+ * Kalau <basePath>/prompts.pack ada (lihat PromptPack), prompt diambil
+ * langsung dari mapping pack tanpa decode. Prompt yang tidak ada di pack
+ * di-decode dari WAV di <basePath>/<lang>/ sekali saat startup ke format
+ * engine (S16 native-endian mono, SAMPLE_RATE) supaya playback tidak lagi membuka file,
+ * mem-parse header, atau resample. File non-WAV (mis. login.mp3) di luar
+ * pack tidak di-cache; AudioWorker memutarnya lewat fallback paplay.
+ */
+class PromptCache
+{
+public:
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr int CHANNELS = 1;
+    static constexpr int BYTES_PER_FRAME = 2 * CHANNELS;
+
+    // Nama file per sentenceIndex (SOUND_*), kosong kalau tidak dikenal.
+    static QString fileNameFor(int sentenceIndex);
+
+    // Map pack (kalau ada) lalu decode prompt yang belum tercakup untuk setiap
+    // bahasa; mengembalikan jumlah prompt yang masuk cache.
+    int load(const QString &basePath, const QStringList &languages);
+
+    // QByteArray implicitly shared: aman diteruskan ke thread audio tanpa copy.
+    QByteArray pcm(int sentenceIndex, const QString &lang) const;
+    bool contains(int sentenceIndex, const QString &lang) const;
+    qint64 totalBytes() const { return m_totalBytes; }
+    qint64 packBytes() const { return m_pack.mappedBytes(); }
+
+    // WAV PCM 8/16/24/32-bit atau float32, mono/stereo -> S16 mono SAMPLE_RATE
+    static bool decodeWav(const QByteArray &file, QByteArray &out, QString *error = nullptr);
+
+private:
+    static QString key(int sentenceIndex, const QString &lang);
+
+    bool openPack(const QString &path);
+
+    PromptPack m_pack;
+    QHash<QString, QByteArray> m_prompts;
+    qint64 m_totalBytes = 0;
+};
+
+#endif // PROMPTCACHE_H
@@ -0,0 +1,213 @@
+#include "promptpack.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+    #include <sys/mman.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[4] = {'R', 'S', 'P', 'K'};
+constexpr int MAX_SENTENCE_INDEX = 255;
+
+qint64 alignUp(qint64 v)
+{
+    return (v + PromptPack::ALIGN - 1) / PromptPack::ALIGN * PromptPack::ALIGN;
+}
+
+bool fail(QString *error, const QString &msg)
+{
+    if (error)
+        *error = msg;
+    return false;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------------------
+PromptPack::~PromptPack()
+{
+    close();
+}
+
+//---------------------------------------------------------------------------------------
+void PromptPack::close()
+{
+    m_byLang.clear();
+    m_count = 0;
+
+    if (m_map) {
+#ifdef Q_OS_LINUX
+        if (m_locked)
+            munlock(m_map, size_t(m_size));
+#endif
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    m_locked = false;
+    m_size = 0;
+
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+//---------------------------------------------------------------------------------------
+bool PromptPack::open(const QString &path, QString *error)
+{
+    close();
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    Q_UNUSED(path);
+    return fail(error, QStringLiteral("pack PCM little-endian, host big-endian"));
+#else
+    QElapsedTimer timer;
+    timer.start();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return fail(error, m_file.errorString());
+
+    m_size = m_file.size();
+    if (m_size < HEADER_SIZE) {
+        close();
+        return fail(error, QStringLiteral("file terlalu kecil"));
+    }
+
+    m_map = m_file.map(0, m_size);
+    if (!m_map) {
+        const QString msg = m_file.errorString();
+        close();
+        return fail(error, msg);
+    }
+
+    const uchar *h = m_map;
+
+    if (std::memcmp(h, MAGIC, 4) != 0 || qFromLittleEndian<quint32>(h + 4) != VERSION) {
+        close();
+        return fail(error, QStringLiteral("magic / versi tidak dikenal"));
+    }
+
+    m_sampleRate = int(qFromLittleEndian<quint32>(h + 8));
+    m_channels = qFromLittleEndian<quint16>(h + 12);
+    const quint16 bits = qFromLittleEndian<quint16>(h + 14);
+    const quint32 entries = qFromLittleEndian<quint32>(h + 16);
+    const quint32 tableOffset = qFromLittleEndian<quint32>(h + 20);
+    const quint64 fileSize = qFromLittleEndian<quint64>(h + 24);
+
+    if (bits != 16 || m_channels <= 0 || m_sampleRate <= 0 || fileSize != quint64(m_size)
+        || qint64(tableOffset) + qint64(entries) * ENTRY_SIZE > m_size) {
+        close();
+        return fail(error, QStringLiteral("header rusak atau file terpotong"));
+    }
+
+    for (quint32 i = 0; i < entries; ++i) {
+        const uchar *e = m_map + tableOffset + qint64(i) * ENTRY_SIZE;
+
+        const QString lang = QString::fromLatin1(reinterpret_cast<const char *>(e),
+                                                 int(qstrnlen(reinterpret_cast<const char *>(e), LANG_SIZE)));
+        const quint32 index = qFromLittleEndian<quint32>(e + 8);
+        const quint32 bytes = qFromLittleEndian<quint32>(e + 12);
+        const quint64 offset = qFromLittleEndian<quint64>(e + 16);
+
+        if (lang.isEmpty() || index > MAX_SENTENCE_INDEX || offset % ALIGN != 0
+            || offset > quint64(m_size) || bytes > quint64(m_size) - offset) {
+            close();
+            return fail(error, QStringLiteral("entry %1 tidak valid").arg(i));
+        }
+
+        QVector<QByteArray> &slots = m_byLang[lang];
+        if (slots.size() <= int(index))
+            slots.resize(int(index) + 1);
+
+        slots[int(index)] = QByteArray::fromRawData(reinterpret_cast<const char *>(m_map + offset), qsizetype(bytes));
+        m_count++;
+    }
+
+#ifdef Q_OS_LINUX
+    // Baca semua halaman sekarang (startup), bukan saat play pertama; mlock
+    // mencegah page cache dibuang. Gagal mlock (RLIMIT_MEMLOCK) tidak fatal.
+    madvise(m_map, size_t(m_size), MADV_WILLNEED);
+    m_locked = mlock(m_map, size_t(m_size)) == 0;
+    if (!m_locked)
+        qWarning() << "PromptPack: mlock gagal, halaman bisa di-evict dari page cache";
+#endif
+
+    qDebug() << "PromptPack:" << path << m_count << "prompt," << m_byLang.size() << "bahasa,"
+             << m_size / 1024 << "KiB dalam" << timer.elapsed() << "ms";
+
+    return true;
+#endif
+}
+
+//---------------------------------------------------------------------------------------
+QByteArray PromptPack::pcm(int sentenceIndex, const QString &lang) const
+{
+    const auto it = m_byLang.constFind(lang);
+    if (it == m_byLang.constEnd() || sentenceIndex < 0 || sentenceIndex >= it->size())
+        return QByteArray();
+
+    return it->at(sentenceIndex);
+}
+
+//---------------------------------------------------------------------------------------
+bool PromptPack::write(const QString &path, const QVector<Entry> &entries, int sampleRate, int channels,
+                       QString *error)
+{
+    const qint64 tableOffset = HEADER_SIZE;
+    qint64 dataOffset = alignUp(tableOffset + qint64(entries.size()) * ENTRY_SIZE);
+
+    QByteArray out(dataOffset, '\0');
+    uchar *h = reinterpret_cast<uchar *>(out.data());
+
+    std::memcpy(h, MAGIC, 4);
+    qToLittleEndian<quint32>(VERSION, h + 4);
+    qToLittleEndian<quint32>(quint32(sampleRate), h + 8);
+    qToLittleEndian<quint16>(quint16(channels), h + 12);
+    qToLittleEndian<quint16>(16, h + 14);
+    qToLittleEndian<quint32>(quint32(entries.size()), h + 16);
+    qToLittleEndian<quint32>(quint32(tableOffset), h + 20);
+
+    qint64 offset = dataOffset;
+
+    for (int i = 0; i < entries.size(); ++i) {
+        const Entry &entry = entries.at(i);
+        const QByteArray lang = entry.lang.toLatin1();
+
+        if (lang.isEmpty() || lang.size() > LANG_SIZE || entry.sentenceIndex < 0
+            || entry.sentenceIndex > MAX_SENTENCE_INDEX)
+            return fail(error, QStringLiteral("entry tidak valid: %1/%2").arg(entry.lang).arg(entry.sentenceIndex));
+
+        uchar *e = reinterpret_cast<uchar *>(out.data()) + tableOffset + qint64(i) * ENTRY_SIZE;
+        std::memcpy(e, lang.constData(), size_t(lang.size()));
+        qToLittleEndian<quint32>(quint32(entry.sentenceIndex), e + 8);
+        qToLittleEndian<quint32>(quint32(entry.pcm.size()), e + 12);
+        qToLittleEndian<quint64>(quint64(offset), e + 16);
+
+        offset = alignUp(offset + entry.pcm.size());
+    }
+
+    out.resize(offset, '\0');
+    qToLittleEndian<quint64>(quint64(offset), reinterpret_cast<uchar *>(out.data()) + 24);
+
+    for (int i = 0; i < entries.size(); ++i) {
+        const uchar *e = reinterpret_cast<const uchar *>(out.constData()) + tableOffset + qint64(i) * ENTRY_SIZE;
+        const qint64 at = qint64(qFromLittleEndian<quint64>(e + 16));
+        const QByteArray &pcm = entries.at(i).pcm;
+
+        // PCM disimpan little-endian apa pun host packer-nya
+        qToLittleEndian<qint16>(pcm.constData(), pcm.size() / 2, out.data() + at);
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit())
+        return fail(error, file.errorString());
+
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef PROMPTPACK_H
+#define PROMPTPACK_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*
+ * Asset pack PCM prompt: semua prompt semua bahasa dalam satu file.
+ *
+ * Dibuat offline oleh tool promptpack (promptpacker.cpp), dibaca di device
+ * lewat mmap. PCM sudah dalam format engine (S16LE mono, sample rate di
+ * header), jadi playback langsung dari mapping: tanpa open/read/decode per
+ * play, dan ganti bahasa hanya ganti lookup.
+ *
+ * Layout (little-endian):
+ *   header  HEADER_SIZE byte
+ *     magic "RSPK" | version u32 | sample rate u32 | channels u16
+ *     | bits per sample u16 | jumlah entry u32 | offset tabel entry u32
+ *     | ukuran file u64 | reserved
+ *   entry   ENTRY_SIZE byte per prompt
+ *     lang ASCII[LANG_SIZE] (0-padded) | sentenceIndex u32 | byte PCM u32
+ *     | offset PCM u64 | reserved
+ *   data    PCM tiap prompt, offset rata ALIGN byte
+ */
+class PromptPack
+{
+public:
+    static constexpr int HEADER_SIZE = 64;
+    static constexpr int ENTRY_SIZE = 32;
+    static constexpr int LANG_SIZE = 8;
+    static constexpr int ALIGN = 64;
+    static constexpr quint32 VERSION = 1;
+    static constexpr char FILE_NAME[] = "prompts.pack";
+
+    struct Entry {
+        QString lang;
+        int sentenceIndex = 0;
+        QByteArray pcm;             // S16 native-endian
+    };
+
+    PromptPack() = default;
+    ~PromptPack();
+
+    PromptPack(const PromptPack &) = delete;
+    PromptPack &operator=(const PromptPack &) = delete;
+
+    // Map file dan validasi header / tabel. Halaman PCM di-prefetch dan
+    // dikunci di RAM (best effort) supaya play pertama tidak menunggu SD card.
+    bool open(const QString &path, QString *error = nullptr);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+
+    int sampleRate() const { return m_sampleRate; }
+    int channels() const { return m_channels; }
+    qint64 mappedBytes() const { return m_size; }
+    int count() const { return m_count; }
+    QStringList languages() const { return m_byLang.keys(); }
+
+    // Zero-copy (QByteArray::fromRawData di atas mapping); valid selama pack terbuka.
+    QByteArray pcm(int sentenceIndex, const QString &lang) const;
+
+    static bool write(const QString &path, const QVector<Entry> &entries, int sampleRate, int channels,
+                      QString *error = nullptr);
+
+private:
+    QFile m_file;
+    uchar *m_map = nullptr;
+    qint64 m_size = 0;
+    bool m_locked = false;
+
+    int m_sampleRate = 0;
+    int m_channels = 0;
+    int m_count = 0;
+
+    // lang -> PCM per sentenceIndex
+    QHash<QString, QVector<QByteArray>> m_byLang;
+};
+
+#endif // PROMPTPACK_H
@@ -0,0 +1,125 @@
+/*
+ * promptpack: tool offline pembuat asset pack prompt (lihat PromptPack).
+ *
+ *   promptpack <wav-dir> <output.pack> [lang ...]
+ *
+ * Semua prompt <wav-dir>/<lang>/<file> untuk setiap bahasa (default sv id en)
+ * di-decode ke format engine dan ditulis ke satu pack. WAV di-decode dengan
+ * PromptCache::decodeWav; format lain (login.mp3) lewat ffmpeg, jadi ffmpeg
+ * hanya dibutuhkan di mesin build, bukan di device.
+ */
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QProcess>
+#include <QStringList>
+
+#include "audioworker.h"
+#include "promptcache.h"
+#include "promptpack.h"
+
+namespace {
+
+constexpr int FFMPEG_TIMEOUT_MS = 30000;
+
+bool decodeWithFfmpeg(const QString &path, QByteArray &out, QString *error)
+{
+    QProcess ffmpeg;
+    ffmpeg.start(QStringLiteral("ffmpeg"),
+                 {QStringLiteral("-nostdin"), QStringLiteral("-v"), QStringLiteral("error"),
+                  QStringLiteral("-i"), path,
+                  QStringLiteral("-f"), QStringLiteral("wav"), QStringLiteral("-acodec"), QStringLiteral("pcm_s16le"),
+                  QStringLiteral("-ac"), QString::number(PromptCache::CHANNELS),
+                  QStringLiteral("-ar"), QString::number(PromptCache::SAMPLE_RATE),
+                  QStringLiteral("pipe:1")});
+
+    if (!ffmpeg.waitForFinished(FFMPEG_TIMEOUT_MS) || ffmpeg.exitStatus() != QProcess::NormalExit
+        || ffmpeg.exitCode() != 0) {
+        if (error) {
+            const QString stderrText = QString::fromLocal8Bit(ffmpeg.readAllStandardError()).trimmed();
+            *error = QStringLiteral("ffmpeg gagal: ") + (stderrText.isEmpty() ? ffmpeg.errorString() : stderrText);
+        }
+        return false;
+    }
+
+    // Output pipe: ukuran chunk data bisa 0xFFFFFFFF, decodeWav memotong ke ukuran file
+    return PromptCache::decodeWav(ffmpeg.readAllStandardOutput(), out, error);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments().mid(1);
+    if (args.size() < 2) {
+        qWarning().noquote() << "usage: promptpack <wav-dir> <output.pack> [lang ...]";
+        return 2;
+    }
+
+    const QString baseDir = args.takeFirst();
+    const QString output = args.takeFirst();
+    const QStringList languages = args.isEmpty()
+                                      ? QStringList{QStringLiteral("sv"), QStringLiteral("id"), QStringLiteral("en")}
+                                      : args;
+
+    QVector<PromptPack::Entry> entries;
+    qint64 totalBytes = 0;
+    int missing = 0;
+
+    for (const QString &lang : languages) {
+        for (int index = SOUND_FALL_OCCUR; index <= SOUND_UPLOAD_FAILED; ++index) {
+            const QString name = PromptCache::fileNameFor(index);
+            if (name.isEmpty())
+                continue;
+
+            const QString path = baseDir + QLatin1Char('/') + lang + QLatin1Char('/') + name;
+
+            PromptPack::Entry entry;
+            entry.lang = lang;
+            entry.sentenceIndex = index;
+
+            QString error;
+            bool ok = false;
+
+            if (name.endsWith(QLatin1String(".wav"))) {
+                QFile file(path);
+                if (!file.open(QIODevice::ReadOnly))
+                    error = file.errorString();
+                else
+                    ok = PromptCache::decodeWav(file.readAll(), entry.pcm, &error);
+            } else if (QFile::exists(path)) {
+                ok = decodeWithFfmpeg(path, entry.pcm, &error);
+            } else {
+                error = QStringLiteral("file tidak ada");
+            }
+
+            if (!ok || entry.pcm.isEmpty()) {
+                qWarning().noquote() << "skip" << path << ":" << error;
+                missing++;
+                continue;
+            }
+
+            totalBytes += entry.pcm.size();
+            entries.append(entry);
+        }
+    }
+
+    if (entries.isEmpty()) {
+        qWarning() << "promptpack: tidak ada prompt yang bisa di-pack";
+        return 1;
+    }
+
+    QString error;
+    if (!PromptPack::write(output, entries, PromptCache::SAMPLE_RATE, PromptCache::CHANNELS, &error)) {
+        qWarning().noquote() << "promptpack: gagal menulis" << output << ":" << error;
+        return 1;
+    }
+
+    qInfo().noquote() << "promptpack:" << entries.size() << "prompt," << languages.size() << "bahasa,"
+                      << totalBytes / 1024 << "KiB PCM ->" << output << "(" << missing << "dilewati)";
+
+    return 0;
+}
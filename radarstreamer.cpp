@@ -0,0 +1,313 @@
+#include "radarstreamer.h"
+
+#include "metrics.h"
+#include "socketioclient.h"
+#include "telemetrycodec.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+
+#include <algorithm>
+#include <iterator>
+
+//---------------------------------------------------------------------------------------
+RadarStreamer::RadarStreamer(SocketIOClient *client, QObject *parent)
+    : QObject(parent)
+    , m_client(client)
+{
+    connect(&m_sendTimer, &QTimer::timeout, this, &RadarStreamer::sendTick);
+
+    m_adaptTimer.setInterval(ADAPT_INTERVAL_MS);
+    connect(&m_adaptTimer, &QTimer::timeout, this, &RadarStreamer::adapt);
+
+    // Stream live: cukup nilai terbaru, tidak perlu bertahan saat restart.
+    for (const char *name : {"RADAR_TARGETS", "RADAR_SUMMARY"}) {
+        m_client->setEventLane(name, SocketIOClient::EventLane::Telemetry);
+        m_client->setEventPersistent(name, false);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+const char *RadarStreamer::modeName(Mode mode)
+{
+    switch (mode) {
+    case Mode::Off:     return "off";
+    case Mode::Summary: return "summary";
+    case Mode::Reduced: return "reduced";
+    case Mode::Full:    return "full";
+    }
+    return "unknown";
+}
+
+//---------------------------------------------------------------------------------------
+void RadarStreamer::addSource(PayloadProcessor *proc, const QString &source, quint8 index)
+{
+    SourceState &s = m_sources[source];
+    s.proc = proc;
+    s.index = index;
+
+    connect(proc, &PayloadProcessor::targetFrame, this, &RadarStreamer::onTargetFrame);
+}
+
+//---------------------------------------------------------------------------------------
+void RadarStreamer::setEnabled(bool enabled)
+{
+    if (enabled == isEnabled())
+        return;
+
+    qDebug() << "Radar target streaming:" << (enabled ? "ON" : "OFF");
+
+    // Mulai dari Reduced, naik ke Full kalau link longgar.
+    setMode(enabled ? Mode::Reduced : Mode::Off);
+}
+
+//---------------------------------------------------------------------------------------
+int RadarStreamer::intervalFor(Mode mode) const
+{
+    switch (mode) {
+    case Mode::Full:    return FULL_INTERVAL_MS;
+    case Mode::Reduced: return REDUCED_INTERVAL_MS;
+    case Mode::Summary: return SUMMARY_INTERVAL_MS;
+    case Mode::Off:     break;
+    }
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+void RadarStreamer::setMode(Mode mode)
+{
+    if (mode == m_mode)
+        return;
+
+    qDebug() << "Radar stream mode:" << modeName(m_mode) << "->" << modeName(mode);
+
+    m_mode = mode;
+    m_calmTicks = 0;
+
+    METRIC_GAUGE("radar_stream.mode").set(int(mode));
+
+    // Decimation di thread radar: frame di luar interval tidak pernah di-emit.
+    const int procInterval = mode == Mode::Off     ? 0
+                             : mode == Mode::Full  ? FULL_INTERVAL_MS
+                                                   : REDUCED_INTERVAL_MS;
+
+    for (SourceState &s : m_sources) {
+        s.proc->setTargetStreamInterval(procInterval);
+        s.latest.clear();
+        s.fresh = false;
+        s.frames = s.occupancySum = s.occupancyMax = s.speedSamples = 0;
+        s.speedSum = 0;
+        std::fill(std::begin(s.stateCounts), std::end(s.stateCounts), 0);
+    }
+
+    m_summaryWindowStartMs = QDateTime::currentMSecsSinceEpoch();
+
+    if (mode == Mode::Off) {
+        m_sendTimer.stop();
+        m_adaptTimer.stop();
+        return;
+    }
+
+    m_sendTimer.start(intervalFor(mode));
+
+    if (!m_adaptTimer.isActive()) {
+        m_lastTxBytes = METRIC_COUNTER("socketio.tx_bytes").value()
+                        + METRIC_COUNTER("socketio.tx_binary_bytes").value();
+        m_adaptTimer.start();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void RadarStreamer::onTargetFrame(const QString &source, const QVector<RadarTarget> &targets)
+{
+    auto it = m_sources.find(source);
+    if (it == m_sources.end() || m_mode == Mode::Off)
+        return;
+
+    SourceState &s = it.value();
+    s.latest = targets;
+    s.fresh = true;
+
+    s.frames++;
+    s.occupancySum += int(targets.size());
+    s.occupancyMax = qMax(s.occupancyMax, int(targets.size()));
+
+    for (const RadarTarget &t : targets) {
+        s.speedSum += qAbs(t.velocity);
+        s.speedSamples++;
+
+        if (t.state <= StateFalling)
+            s.stateCounts[t.state]++;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void RadarStreamer::sendTick()
+{
+    if (m_mode == Mode::Summary)
+        sendSummary();
+    else if (m_mode != Mode::Off)
+        sendTargets();
+}
+
+//---------------------------------------------------------------------------------------
+void RadarStreamer::sendTargets()
+{
+    QVector<telemetry::RadarFrame> frames;
+    QJsonArray radars;
+    int targetCount = 0;
+
+    for (auto it = m_sources.begin(); it != m_sources.end(); ++it) {
+        SourceState &s = it.value();
+        if (!s.fresh)
+            continue;
+
+        s.fresh = false;
+
+        telemetry::RadarFrame frame;
+        frame.radarIndex = s.index;
+        frame.targets = s.latest;
+        frames.append(frame);
+
+        QJsonArray targets;
+        for (const RadarTarget &t : s.latest) {
+            QJsonObject o;
+            o["id"] = t.trackId;
+            o["x"] = t.x;
+            o["y"] = t.y;
+            o["h"] = t.height;
+            o["v"] = t.velocity;
+            o["state"] = t.state;
+            targets.append(o);
+        }
+        targetCount += int(s.latest.size());
+
+        QJsonObject radar;
+        radar["source"] = it.key();
+        radar["targets"] = targets;
+        radars.append(radar);
+    }
+
+    if (frames.isEmpty())
+        return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QJsonObject obj;
+    obj["ts"] = now;
+    obj["mode"] = modeName(m_mode);
+    obj["radars"] = radars;
+
+    const QByteArray binary = telemetry::encodeRadarTargets(now, frames);
+
+    // Perkiraan ukuran JSON tanpa serialisasi ulang.
+    m_lastPayloadBytes = m_client->binaryTelemetryEnabled() ? binary.size()
+                                                            : 48 + 40 * qint64(radars.size()) + 64 * targetCount;
+
+    m_client->enqueueTelemetry("RADAR_TARGETS", obj, binary);
+    METRIC_COUNTER("radar_stream.frames_sent").inc();
+}
+
+//---------------------------------------------------------------------------------------
+void RadarStreamer::sendSummary()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QJsonArray radars;
+
+    for (auto it = m_sources.begin(); it != m_sources.end(); ++it) {
+        SourceState &s = it.value();
+
+        QJsonObject states;
+        states["unknown"] = s.stateCounts[StateUnknown];
+        states["standing"] = s.stateCounts[StateStanding];
+        states["sitting"] = s.stateCounts[StateSitting];
+        states["lying"] = s.stateCounts[StateLying];
+        states["falling"] = s.stateCounts[StateFalling];
+
+        QJsonObject radar;
+        radar["source"] = it.key();
+        radar["frames"] = s.frames;
+        radar["occupancy_max"] = s.occupancyMax;
+        radar["occupancy_avg"] = s.frames ? double(s.occupancySum) / s.frames : 0.0;
+        radar["mean_speed"] = s.speedSamples ? double(s.speedSum) / s.speedSamples : 0.0;
+        radar["states"] = states;
+        radars.append(radar);
+
+        s.frames = s.occupancySum = s.occupancyMax = s.speedSamples = 0;
+        s.speedSum = 0;
+        std::fill(std::begin(s.stateCounts), std::end(s.stateCounts), 0);
+    }
+
+    QJsonObject obj;
+    obj["ts"] = now;
+    obj["window_ms"] = now - m_summaryWindowStartMs;
+    obj["radars"] = radars;
+
+    m_summaryWindowStartMs = now;
+
+    m_client->enqueueEvent("RADAR_SUMMARY", obj);
+    METRIC_COUNTER("radar_stream.summaries_sent").inc();
+}
+
+//---------------------------------------------------------------------------------------
+void RadarStreamer::adapt()
+{
+    const quint64 tx = METRIC_COUNTER("socketio.tx_bytes").value()
+                       + METRIC_COUNTER("socketio.tx_binary_bytes").value();
+    const double bps = double(tx - m_lastTxBytes) * 1000.0 / ADAPT_INTERVAL_MS;
+
+    m_lastTxBytes = tx;
+    m_throughputBps = m_throughputBps * 0.7 + bps * 0.3;
+    m_peakThroughputBps = qMax(m_peakThroughputBps, bps);
+
+    if (m_mode == Mode::Off)
+        return;
+
+    // Offline: hanya ringkasan (yang terbaru saja yang menunggu di queue).
+    if (!m_client->isConnected()) {
+        setMode(Mode::Summary);
+        return;
+    }
+
+    const int pending = m_client->pendingEventCount();
+    const qint64 buffered = m_client->outboundBufferedBytes();
+
+    if (pending > CONGESTED_QUEUE || buffered > CONGESTED_BYTES) {
+        METRIC_COUNTER("radar_stream.congested").inc();
+        m_calmTicks = 0;
+
+        if (m_mode > Mode::Summary)
+            setMode(Mode(int(m_mode) - 1));
+        return;
+    }
+
+    if (pending <= 2 && buffered < IDLE_BYTES)
+        m_calmTicks++;
+    else
+        m_calmTicks = 0;
+
+    if (m_calmTicks < CALM_TICKS_TO_STEP_UP || m_mode == Mode::Full)
+        return;
+
+    m_calmTicks = 0;
+
+    // Naik hanya kalau perkiraan kebutuhan byte/s masih di bawah throughput terukur.
+    const Mode next = Mode(int(m_mode) + 1);
+    const double perFrame = m_lastPayloadBytes > 0 ? double(m_lastPayloadBytes) : 256.0;
+    const double required = perFrame * 1000.0 / intervalFor(next);
+
+    if (required <= qMax(m_peakThroughputBps, MIN_LINK_BPS))
+        setMode(next);
+}
+
+//---------------------------------------------------------------------------------------
+QJsonObject RadarStreamer::status() const
+{
+    QJsonObject obj;
+    obj["mode"] = modeName(m_mode);
+    obj["throughput_bps"] = m_throughputBps;
+    obj["peak_throughput_bps"] = m_peakThroughputBps;
+    obj["last_payload_bytes"] = m_lastPayloadBytes;
+    return obj;
+}
@@ -0,0 +1,106 @@
+#ifndef RADARSTREAMER_H
+#define RADARSTREAMER_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include "payloadprocessor.h"
+
+class SocketIOClient;
+
+/*
+ * Streaming target radar ke backend (opt-in, default mati).
+ *
+ * Mode (turun saat link padat, naik lagi saat link longgar):
+ *   Full     RADAR_TARGETS tiap FULL_INTERVAL_MS
+ *   Reduced  RADAR_TARGETS tiap REDUCED_INTERVAL_MS
+ *   Summary  hanya RADAR_SUMMARY (okupansi, kecepatan, state) tiap SUMMARY_INTERVAL_MS
+ *
+ * Evaluasi tiap ADAPT_INTERVAL_MS dari kedalaman queue SocketIOClient,
+ * byte tertahan di socket, dan throughput yang terukur. Event stream masuk
+ * lane telemetry (coalesce, prioritas terendah, tidak dijournal), jadi
+ * tidak pernah menahan lane insiden.
+ */
+class RadarStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        Off = 0,
+        Summary,
+        Reduced,
+        Full
+    };
+
+    explicit RadarStreamer(SocketIOClient *client, QObject *parent = nullptr);
+
+    void addSource(PayloadProcessor *proc, const QString &source, quint8 index);
+
+    bool isEnabled() const { return m_mode != Mode::Off; }
+    Mode mode() const { return m_mode; }
+    QJsonObject status() const;
+
+    static const char *modeName(Mode mode);
+
+public slots:
+    void setEnabled(bool enabled);
+    void onTargetFrame(const QString &source, const QVector<RadarTarget> &targets);
+
+private slots:
+    void adapt();
+    void sendTick();
+
+private:
+    struct SourceState {
+        PayloadProcessor *proc = nullptr;
+        quint8 index = 0;
+
+        QVector<RadarTarget> latest;
+        bool fresh = false;
+
+        // Akumulasi untuk RADAR_SUMMARY
+        int frames = 0;
+        int occupancySum = 0;
+        int occupancyMax = 0;
+        qint64 speedSum = 0;
+        int speedSamples = 0;
+        int stateCounts[StateFalling + 1] = {};
+    };
+
+    void setMode(Mode mode);
+    int intervalFor(Mode mode) const;
+    void sendTargets();
+    void sendSummary();
+
+    SocketIOClient *m_client;
+    QHash<QString, SourceState> m_sources;
+
+    Mode m_mode = Mode::Off;
+    QTimer m_sendTimer;
+    QTimer m_adaptTimer;
+
+    int m_calmTicks = 0;
+    qint64 m_lastPayloadBytes = 0;
+    quint64 m_lastTxBytes = 0;
+    double m_throughputBps = 0;       // EWMA byte/s yang benar-benar terkirim
+    double m_peakThroughputBps = 0;
+    qint64 m_summaryWindowStartMs = 0;
+
+    static constexpr int FULL_INTERVAL_MS = 200;
+    static constexpr int REDUCED_INTERVAL_MS = 1000;
+    static constexpr int SUMMARY_INTERVAL_MS = 5000;
+    static constexpr int ADAPT_INTERVAL_MS = 1000;
+
+    static constexpr int CONGESTED_QUEUE = 20;
+    static constexpr qint64 CONGESTED_BYTES = 32 * 1024;
+    static constexpr qint64 IDLE_BYTES = 4 * 1024;
+    static constexpr int CALM_TICKS_TO_STEP_UP = 3;
+    static constexpr double MIN_LINK_BPS = 8 * 1024;
+};
+
+#endif // RADARSTREAMER_H
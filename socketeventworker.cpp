@@ -1,10 +1,26 @@
 #include "socketeventworker.h"
 #include <QJsonObject>
 #include <QDebug>
+#include <QMetaObject>
+#include "metrics.h"
+
+namespace {
+
+// VOLUME_SET / SCREEN_BRIGHTNESS_SET: angka, string angka, atau {"level": n}
+int levelFrom(const QJsonValue &data)
+{
+    if (data.isDouble()) return data.toInt();
+    if (data.isString()) return data.toString().toInt();
+    if (data.isObject()) return data.toObject().value("level").toInt(0);
+    return 0;
+}
+
+} // namespace
 
 SocketEventWorker::SocketEventWorker(QObject *parent)
-    : QObject(parent), m_running(true)
+    : QObject(parent)
 {
+    registerBuiltinHandlers();
 }
 
 SocketEventWorker::~SocketEventWorker(){
@@ -14,251 +30,303 @@ SocketEventWorker::~SocketEventWorker(){
 //------------------------------------------------------------------------
 void SocketEventWorker::stop()
 {
-    QMutexLocker locker(&m_mutex);
-    m_running = false;
-    m_cond.wakeAll();
+    m_running.store(false, std::memory_order_release);
 }
 
 //------------------------------------------------------------------------
-void SocketEventWorker::enqueue(const QString &eventName, const QJsonValue &data)
+void SocketEventWorker::registerHandler(const QString &eventName, Handler handler, Coalesce coalesce)
 {
-    QMutexLocker locker(&m_mutex);
-    m_queue.enqueue(qMakePair(eventName, data));
-    m_cond.wakeOne();
+    Entry entry;
+    entry.handler = std::move(handler);
+    entry.coalesce = coalesce;
+    m_handlers.insert(eventName, std::move(entry));
 }
 
 //------------------------------------------------------------------------
-void SocketEventWorker::process()
+void SocketEventWorker::registerPrefixHandler(const QString &prefix, Handler handler)
 {
-    while (true) {
-        m_mutex.lock();
-        while (m_queue.isEmpty() && m_running) {
-            m_cond.wait(&m_mutex);   // tidur sampai ada data
-        }
+    m_prefixHandlers.append(qMakePair(prefix, std::move(handler)));
+}
 
-        if (!m_running) {
-            m_mutex.unlock();
-            break;
-        }
+//------------------------------------------------------------------------
+void SocketEventWorker::registerBuiltinHandlers()
+{
+    // Event tanpa payload -> langsung emit signal
+    auto emitOnly = [this](void (SocketEventWorker::*sig)()) -> Handler {
+        return [this, sig](const QString &, const QJsonValue &) { (this->*sig)(); };
+    };
 
-        auto event = m_queue.dequeue();
-        m_mutex.unlock();
-
-        const QString &eventName = event.first;
-        const QJsonValue &data = event.second;
-
-        qDebug() << "Worker processing event:" << eventName << "data:" << data;
-
-        //Robot mode
-        if (eventName == "LISTENING") {
-            emit modeListen();
-        }else if (eventName == "TALKING") {
-            emit modeTalking();
-        }else if (eventName == "PING_DEVICE_UP") {
-            emit pingDeviceUp();
-        }else if (eventName == "SLEEP") {
-            emit modeSleep();
-        }else if(eventName == "WAKE_UP"){
-            emit modeWakeUp();
-        }else if (eventName == "WAITING") {
-            emit modeWaiting();
-        }else if (eventName == "RECORDING") {
-            emit modeRecording();
-        }else if(eventName == "SPEECH_MODULE_READY"){
-            emit speechModuleReady();
-        }else if(eventName == "UPLOAD_FAILED"){
-            emit modeUploadFailed();
-        }
+    // Coalesce::Sum: data = {"steps": n}
+    auto steps = [](const QJsonValue &data) { return data.toObject().value("steps").toInt(1); };
 
-        //Brightness, Volume
-        else if (eventName == "VOLUME_SET_REQUEST") {
-            emit volumeGetRequested();
-        }else if (eventName == "VOLUME_SET") {
-            int vt = 0;
-            if (data.isDouble()) vt = data.toInt();
-            else if (data.isString()) vt = data.toString().toInt();
-            else if (data.isObject()) {
-                QJsonObject obj = data.toObject();
-                vt = obj.value("level").toInt(0);
-            }
-            emit volumeSetRequested(vt);
-        }else if (eventName == "SCREEN_BRIGHTNESS_SET") {
-            int bst = 0;
-            if (data.isDouble()) bst = data.toInt();
-            else if (data.isString()) bst = data.toString().toInt();
-            else if (data.isObject()) {
-                QJsonObject obj = data.toObject();
-                bst = obj.value("level").toInt(0);
-            }
-            emit brightnessSetRequested(bst);
-        }else if(eventName == "INCREASE_VOLUME"){
-            emit volumeIncreaseReq();
-        }else if(eventName == "DECREASE_VOLUME"){
-            emit volumeDecreaseReq();
-        }else if(eventName == "INCREASE_BRIGHTNESS"){
-            emit brightnessIncreaseReq();
-        }else if(eventName == "DECREASE_BRIGHTNESS"){
-            emit brightnessDecreaseReq();
-        }else if(eventName == "SCREEN_BRIGHTNESS_REQUEST"){
-            emit brightnessGetRequested();
-        }
+    //Robot mode
+    registerHandler("LISTENING", emitOnly(&SocketEventWorker::modeListen));
+    registerHandler("TALKING", emitOnly(&SocketEventWorker::modeTalking));
+    registerHandler("PING_DEVICE_UP", emitOnly(&SocketEventWorker::pingDeviceUp));
+    registerHandler("SLEEP", emitOnly(&SocketEventWorker::modeSleep));
+    registerHandler("WAKE_UP", emitOnly(&SocketEventWorker::modeWakeUp));
+    registerHandler("WAITING", emitOnly(&SocketEventWorker::modeWaiting));
+    registerHandler("RECORDING", emitOnly(&SocketEventWorker::modeRecording));
+    registerHandler("SPEECH_MODULE_READY", emitOnly(&SocketEventWorker::speechModuleReady));
+    registerHandler("UPLOAD_FAILED", emitOnly(&SocketEventWorker::modeUploadFailed));
 
-        //ALARM
-        else if (eventName == "ALARM_RING") {
-            emit alarmRing();
-        }else if (eventName == "ALARM_STOP") {
-            emit alarmStop();
-        }else if (eventName == "ALARM_SNOOZE") {
-            emit  alarmSnooze();
-        }else if (eventName == "WAKE_UP_BY_ALARM") {
-            emit  alarmWakeUp();
-        }else if (eventName == "ALARM_STOP_BUTTON") {
-            emit  alarmStopButton();
-        }else if (eventName == "ALARM_SNOOSE_BUTTON") {
-            emit  alarmSnoozeButton();
-        }
+    //Brightness, Volume
+    registerHandler("VOLUME_SET_REQUEST", emitOnly(&SocketEventWorker::volumeGetRequested), Coalesce::Latest);
+    registerHandler("VOLUME_SET", [this](const QString &, const QJsonValue &data) {
+        emit volumeSetRequested(levelFrom(data));
+    }, Coalesce::Latest);
+    registerHandler("SCREEN_BRIGHTNESS_SET", [this](const QString &, const QJsonValue &data) {
+        emit brightnessSetRequested(levelFrom(data));
+    }, Coalesce::Latest);
+    registerHandler("INCREASE_VOLUME", [this, steps](const QString &, const QJsonValue &data) {
+        emit volumeStepReq(steps(data));
+    }, Coalesce::Sum);
+    registerHandler("DECREASE_VOLUME", [this, steps](const QString &, const QJsonValue &data) {
+        emit volumeStepReq(-steps(data));
+    }, Coalesce::Sum);
+    registerHandler("INCREASE_BRIGHTNESS", [this, steps](const QString &, const QJsonValue &data) {
+        emit brightnessStepReq(steps(data));
+    }, Coalesce::Sum);
+    registerHandler("DECREASE_BRIGHTNESS", [this, steps](const QString &, const QJsonValue &data) {
+        emit brightnessStepReq(-steps(data));
+    }, Coalesce::Sum);
+    registerHandler("SCREEN_BRIGHTNESS_REQUEST", emitOnly(&SocketEventWorker::brightnessGetRequested), Coalesce::Latest);
 
-        //LAnguage
-        else if (eventName == "LANGUAGE_CURRENT") {
-            if (data.isObject()) {
-                QJsonObject obj = data.toObject();
-                QString lang = obj["lang"].toString();
-                qDebug() << "lang current:" << eventName << obj;
-                emit langCurrent(lang);
-            }
-        }else if(eventName == "LANGUAGE_GET"){
-            emit langGet();
-        }else if(eventName == "LANGUAGE_SET"){
-            if (data.isObject()) {
-                QJsonObject obj = data.toObject();
-                QString ret = obj["success"].toString();
-                QString lang = obj["lang"].toString();
-                qDebug() << "lang current:" << eventName << obj;
-                emit langSet(lang);
-            }
-        }else if(eventName == "ACK_LANGUAGE_SET"){
-            emit langAckSet();
-        }
+    //ALARM
+    registerHandler("ALARM_RING", emitOnly(&SocketEventWorker::alarmRing));
+    registerHandler("ALARM_STOP", emitOnly(&SocketEventWorker::alarmStop));
+    registerHandler("ALARM_SNOOZE", emitOnly(&SocketEventWorker::alarmSnooze));
+    registerHandler("WAKE_UP_BY_ALARM", emitOnly(&SocketEventWorker::alarmWakeUp));
+    registerHandler("ALARM_STOP_BUTTON", emitOnly(&SocketEventWorker::alarmStopButton));
+    registerHandler("ALARM_SNOOSE_BUTTON", emitOnly(&SocketEventWorker::alarmSnoozeButton));
 
-        //FALL EVENT DETECTED
-        else if(eventName == "INCIDENT_FALL_EVENT_DETECTED"){    //1
-            emit incidentFallEventDetected();
-        }else if(eventName == "WAKE_UP_BY_FALL_DETECTION"){      //2
-            emit incidentFallWakeUpByFallDetection();
-        }else if(eventName == "ACK_FALL_EVENT_DETECTED"){        //3
-            emit incidentAckFallEventDetected();
-        }else if(eventName == "INCIDENT_FALL_DOWN_NO_RESPONSE"){  //4
-            emit incidentFallNoResponse();
-        }else if(eventName == "INCIDENT_HELP_EVENT_DETECTED"){   //5
-            emit incidentFallHelpEventDetected();
-        }else if(eventName == "INCIDENT_OK_EVENT_DETECTED"){     //6
-            emit incidentFallOKEventDetected();
-        }else if(eventName == "INCIDENT_COMPLETED"){             //7
-            emit incidentFallCompleted();
-        }else if(eventName == "INCIDENT_NOT_OK_EVENT_DETECTED"){
-            emit incidentFallIamnotOK();
-        }else if (eventName == "i_am_ok"){
-            emit incidentFallIamOK();
-        }
+    //Language
+    registerHandler("LANGUAGE_CURRENT", [this](const QString &eventName, const QJsonValue &data) {
+        if (!data.isObject())
+            return;
+        QJsonObject obj = data.toObject();
+        qDebug() << "lang current:" << eventName << obj;
+        emit langCurrent(obj["lang"].toString());
+    });
+    registerHandler("LANGUAGE_GET", emitOnly(&SocketEventWorker::langGet));
+    registerHandler("LANGUAGE_SET", [this](const QString &eventName, const QJsonValue &data) {
+        if (!data.isObject())
+            return;
+        QJsonObject obj = data.toObject();
+        qDebug() << "lang current:" << eventName << obj;
+        emit langSet(obj["lang"].toString());
+    });
+    registerHandler("ACK_LANGUAGE_SET", emitOnly(&SocketEventWorker::langAckSet));
 
-        //WIFI ori
-        else if (eventName == "WIFI_ON") {
-            qDebug() << "Wifi request:" << eventName;
-            emit wifiOn();
-        }else if (eventName == "WIFI_OFF") {
-            qDebug() << "Wifi request:" << eventName;
-            emit wifiOff();
-        }else if (eventName == "disconnect_wifi") {
-            qDebug() << "Wifi disconnect from current ssid :" << eventName;
-            emit wifiDisconnectCurrentSsid();
-        }else if (eventName == "get_wifi_status") {
-            qDebug() << "Wifi request:" << eventName;
-            emit wifiGetSsid();
-        }else if (eventName == "scan_wifi_stream") {
-            qDebug() << "Wifi scan re received:" << eventName;
-            emit wifiScanSsidReqReceived();
-        }else if (eventName.startsWith("connect_wifi")) {
-          if (data.isObject()) {
-                QJsonObject obj = data.toObject();
-                QString ssid = obj["ssid"].toString();
-                QString pwd = obj["password"].toString();
-                qDebug() << "Wifi request:" << eventName << obj;
-                emit wifiConnect(ssid,pwd);
-            }
-        }else if (eventName.startsWith("FORGET_WIFI")) {
-            if (data.isObject()) {
-                  QJsonObject obj = data.toObject();
-                  QString ssid = obj["ssid"].toString();
-                  qDebug() << "Wifi request:" << eventName << obj;
-                  emit wifiForget(ssid);
-            }
-        }
+    //FALL EVENT DETECTED
+    registerHandler("INCIDENT_FALL_EVENT_DETECTED", emitOnly(&SocketEventWorker::incidentFallEventDetected));          //1
+    registerHandler("WAKE_UP_BY_FALL_DETECTION", emitOnly(&SocketEventWorker::incidentFallWakeUpByFallDetection));    //2
+    registerHandler("ACK_FALL_EVENT_DETECTED", emitOnly(&SocketEventWorker::incidentAckFallEventDetected));           //3
+    registerHandler("INCIDENT_FALL_DOWN_NO_RESPONSE", emitOnly(&SocketEventWorker::incidentFallNoResponse));          //4
+    registerHandler("INCIDENT_HELP_EVENT_DETECTED", emitOnly(&SocketEventWorker::incidentFallHelpEventDetected));     //5
+    registerHandler("INCIDENT_OK_EVENT_DETECTED", emitOnly(&SocketEventWorker::incidentFallOKEventDetected));         //6
+    registerHandler("INCIDENT_COMPLETED", emitOnly(&SocketEventWorker::incidentFallCompleted));                       //7
+    registerHandler("INCIDENT_NOT_OK_EVENT_DETECTED", emitOnly(&SocketEventWorker::incidentFallIamnotOK));
+    registerHandler("i_am_ok", emitOnly(&SocketEventWorker::incidentFallIamOK));
 
-        //Wifi CAPITAL
-        else if (eventName == "DISCONNECT_WIFI") {
-                qDebug() << "Wifi disconnect from current ssid :" << eventName;
-                emit wifiDisconnectCurrentSsid();
-        }else if (eventName == "GET_WIFI_STATUS") {
-                  qDebug() << "Wifi request:" << eventName;
-                  emit wifiGetSsid();
-        }else if (eventName == "SCAN_WIFI_STREAM") {
-                  qDebug() << "Wifi scan re received:" << eventName;
-                  emit wifiScanSsidReqReceived();
-        }else if (eventName.startsWith("CONNECT_WIFI")) {
-                if (data.isObject()) {
-                    QJsonObject obj = data.toObject();
-                    QString ssid = obj["ssid"].toString();
-                    QString pwd = obj["password"].toString();
-                    qDebug() << "Wifi request:" << eventName << obj;
-                    emit wifiConnect(ssid,pwd);
-                }
-        }else if (eventName.startsWith("WIFI_SSID_FORGET")) {
-                if (data.isObject()) {
-                    QJsonObject obj = data.toObject();
-                    QString ssid = obj["ssid"].toString();
-                    qDebug() << "Wifi request:" << eventName << obj;
-                    emit wifiForget(ssid);
-                    }
-        } else if (eventName == "wifi_on") {
-                   qDebug() << "Wifi request:" << eventName;
-                   emit wifiOn();
-        }else if (eventName == "wifi_off") {
-            qDebug() << "Wifi request:" << eventName;
-            emit wifiOff();
-        }
+    //Wifi (huruf kecil & kapital dipetakan ke handler yang sama)
+    auto wifiOnHandler = [this](const QString &eventName, const QJsonValue &) {
+        qDebug() << "Wifi request:" << eventName;
+        emit wifiOn();
+    };
+    auto wifiOffHandler = [this](const QString &eventName, const QJsonValue &) {
+        qDebug() << "Wifi request:" << eventName;
+        emit wifiOff();
+    };
+    auto wifiDisconnectHandler = [this](const QString &eventName, const QJsonValue &) {
+        qDebug() << "Wifi disconnect from current ssid :" << eventName;
+        emit wifiDisconnectCurrentSsid();
+    };
+    auto wifiStatusHandler = [this](const QString &eventName, const QJsonValue &) {
+        qDebug() << "Wifi request:" << eventName;
+        emit wifiGetSsid();
+    };
+    auto wifiScanHandler = [this](const QString &eventName, const QJsonValue &) {
+        qDebug() << "Wifi scan re received:" << eventName;
+        emit wifiScanSsidReqReceived();
+    };
+    auto wifiConnectHandler = [this](const QString &eventName, const QJsonValue &data) {
+        if (!data.isObject())
+            return;
+        QJsonObject obj = data.toObject();
+        qDebug() << "Wifi request:" << eventName << obj;
+        emit wifiConnect(obj["ssid"].toString(), obj["password"].toString());
+    };
+    auto wifiForgetHandler = [this](const QString &eventName, const QJsonValue &data) {
+        if (!data.isObject())
+            return;
+        QJsonObject obj = data.toObject();
+        qDebug() << "Wifi request:" << eventName << obj;
+        emit wifiForget(obj["ssid"].toString());
+    };
+
+    registerHandler("WIFI_ON", wifiOnHandler);
+    registerHandler("wifi_on", wifiOnHandler);
+    registerHandler("WIFI_OFF", wifiOffHandler);
+    registerHandler("wifi_off", wifiOffHandler);
+    registerHandler("disconnect_wifi", wifiDisconnectHandler);
+    registerHandler("DISCONNECT_WIFI", wifiDisconnectHandler);
+    registerHandler("get_wifi_status", wifiStatusHandler, Coalesce::Latest);
+    registerHandler("GET_WIFI_STATUS", wifiStatusHandler, Coalesce::Latest);
+    registerHandler("scan_wifi_stream", wifiScanHandler, Coalesce::Latest);
+    registerHandler("SCAN_WIFI_STREAM", wifiScanHandler, Coalesce::Latest);
+    registerPrefixHandler("connect_wifi", wifiConnectHandler);
+    registerPrefixHandler("CONNECT_WIFI", wifiConnectHandler);
+    registerPrefixHandler("FORGET_WIFI", wifiForgetHandler);
+    registerPrefixHandler("WIFI_SSID_FORGET", wifiForgetHandler);
+
+    //TimeZone
+    registerPrefixHandler("TIMEZONE_SET", [this](const QString &eventName, const QJsonValue &data) {
+        if (!data.isObject())
+            return;
+        QJsonObject obj = data.toObject();
+        qDebug() << "timezone set request:" << eventName << obj;
+        emit tzSetReq(obj["timezone"].toString());
+    });
+    registerPrefixHandler("TIMEZONE_GET", [this](const QString &eventName, const QJsonValue &data) {
+        if (!data.isObject())
+            return;
+        qDebug() << "timezone get request:" << eventName;
+        emit tzGetReq();
+    });
 
-        //TimeZone
-        else if (eventName.startsWith("TIMEZONE_SET")) {
-            if (data.isObject()) {
-                  QJsonObject obj = data.toObject();
-                  QString tz = obj["timezone"].toString();
-                  qDebug() << "timezone set request:" << eventName << obj;
-                  emit tzSetReq(tz);
-            }
-        }else if (eventName.startsWith("TIMEZONE_GET")) {
-            if (data.isObject()) {
-                  qDebug() << "timezone get request:" << eventName;
-                  emit tzGetReq();
-            }
+    //Utility
+    registerHandler("DEVICE_RESTART", [this](const QString &eventName, const QJsonValue &) {
+        qDebug() << "Rpi restart" << eventName;
+        emit rpiRestart();
+    });
+    registerHandler("DEVICE_OFF", [this](const QString &eventName, const QJsonValue &) {
+        qDebug() << "Rpi OFF" << eventName;
+        emit rpiShutdown();
+    });
+
+    //Device Status health
+    registerHandler("DEVICE_STATUS_GET", emitOnly(&SocketEventWorker::audioRadarInfoRequest), Coalesce::Latest);
+    registerHandler("DEVICE_POWER_GET", emitOnly(&SocketEventWorker::powerInfoRequest), Coalesce::Latest);
+    registerHandler("DEVICE_METRICS_GET", emitOnly(&SocketEventWorker::metricsInfoRequest), Coalesce::Latest);
+    registerHandler("RADAR_STREAM_SET", [this](const QString &, const QJsonValue &data) {
+        emit radarStreamSet(data.toObject().value("enabled").toBool());
+    }, Coalesce::Latest);
+}
+
+//------------------------------------------------------------------------
+void SocketEventWorker::dispatch(const QString &eventName, const QJsonValue &data)
+{
+    METRIC_COUNTER("worker.events").inc();
+    qCDebug(lcHotPath) << "Worker processing event:" << eventName << "data:" << data;
+
+    auto it = m_handlers.constFind(eventName);
+    if (it != m_handlers.constEnd()) {
+        it.value().handler(eventName, data);
+        return;
+    }
+
+    for (const auto &entry : std::as_const(m_prefixHandlers)) {
+        if (eventName.startsWith(entry.first)) {
+            entry.second(eventName, data);
+            return;
         }
+    }
+
+    METRIC_COUNTER("worker.unhandled_events").inc();
+    qCDebug(lcHotPath) << "Worker: no handler for event" << eventName;
+}
 
-        //Utility
-        else if (eventName == "DEVICE_RESTART") {
-            qDebug() << "Rpi restart" << eventName;
-            emit rpiRestart();
+//------------------------------------------------------------------------
+void SocketEventWorker::enqueue(const QString &eventName, const QJsonValue &data)
+{
+    if (!m_running.load(std::memory_order_acquire))
+        return;
+
+    m_queue.push(qMakePair(eventName, data));
+    scheduleDrain();
+}
+
+//------------------------------------------------------------------------
+void SocketEventWorker::scheduleDrain()
+{
+    // Satu wakeup saja yang boleh antre di event loop worker
+    if (m_drainPending.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    QMetaObject::invokeMethod(this, &SocketEventWorker::drainQueue, Qt::QueuedConnection);
+}
+
+//------------------------------------------------------------------------
+void SocketEventWorker::drainQueue()
+{
+    // Reset sebelum pop: push yang terjadi selama drain akan memposting wakeup baru.
+    m_drainPending.store(false, std::memory_order_release);
+
+    QVector<Event> batch;
+    batch.reserve(MAX_BATCH);
+
+    Event event;
+    while (batch.size() < MAX_BATCH && m_queue.pop(event))
+        batch.append(std::move(event));
+
+    if (!m_running.load(std::memory_order_acquire))
+        return;
+
+    if (batch.isEmpty())
+        return;
+
+    const int received = int(batch.size());
+    coalesceBatch(batch);
+
+    METRIC_HISTOGRAM("worker.batch_size").record(quint64(received));
+    if (received > batch.size())
+        METRIC_COUNTER("worker.coalesced_events").inc(quint64(received - batch.size()));
+
+    for (const Event &e : std::as_const(batch))
+        dispatch(e.first, e.second);
+
+    // Batch penuh: sisa diproses di putaran event loop berikutnya.
+    if (received == MAX_BATCH)
+        scheduleDrain();
+}
+
+//------------------------------------------------------------------------
+void SocketEventWorker::coalesceBatch(QVector<Event> &batch) const
+{
+    if (batch.size() < 2)
+        return;
+
+    QVector<Event> out;
+    out.reserve(batch.size());
+    QHash<QString, int> slot;   // nama event -> index di out
+
+    for (Event &e : batch) {
+        auto it = m_handlers.constFind(e.first);
+        const Coalesce mode = it != m_handlers.constEnd() ? it.value().coalesce : Coalesce::None;
+
+        if (mode == Coalesce::None) {
+            out.append(std::move(e));
+            continue;
         }
-        else if (eventName == "DEVICE_OFF") {
-            qDebug() << "Rpi OFF" << eventName;
-            emit rpiShutdown();
+
+        auto s = slot.constFind(e.first);
+        if (s == slot.constEnd()) {
+            slot.insert(e.first, int(out.size()));
+            if (mode == Coalesce::Sum)
+                e.second = QJsonObject{{"steps", 1}};
+            out.append(std::move(e));
+            continue;
         }
 
-        //Device Status health
-        else if (eventName == "DEVICE_STATUS_GET") {
-            qDebug() << "dev status get";
-            emit audioRadarInfoRequest();
-        }else if(eventName == "DEVICE_POWER_GET"){
-            qDebug() << "dev power get";
-            emit powerInfoRequest();
+        Event &prev = out[s.value()];
+        if (mode == Coalesce::Latest) {
+            prev.second = e.second;
+        } else {
+            const int steps = prev.second.toObject().value("steps").toInt() + 1;
+            prev.second = QJsonObject{{"steps", steps}};
         }
     }
+
+    batch = std::move(out);
 }
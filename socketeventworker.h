@@ -1,11 +1,25 @@
 #pragma once
 
 #include <QObject>
-#include <QQueue>
 #include <QPair>
-#include <QMutex>
-#include <QWaitCondition>
 #include <QJsonValue>
+#include <QHash>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+
+#include "mpscqueue.h"
+
+/*
+ * Worker event Socket.IO, hidup di QThread sendiri dengan event loop Qt.
+ *
+ * enqueue() (thread mana pun) push ke MpscQueue tanpa lock lalu memposting
+ * satu wakeup drainQueue() ke thread worker; wakeup berikutnya baru diposting
+ * setelah drain sebelumnya mulai. drainQueue() mengambil batch, menggabungkan
+ * event yang redundant (lihat Coalesce), lalu dispatch lewat tabel handler.
+ * Karena thread tidak pernah blocking, worker boleh memiliki timer/socket.
+ */
 
 class SocketEventWorker : public QObject
 {
@@ -14,21 +28,42 @@ public:
     explicit SocketEventWorker(QObject *parent = nullptr);
     ~SocketEventWorker();
 
+    // Handler dijalankan di thread worker. eventName diteruskan untuk
+    // handler prefix (mis. "connect_wifi..."), yang exact boleh mengabaikannya.
+    using Handler = std::function<void(const QString &eventName, const QJsonValue &data)>;
+
+    // Penggabungan event dengan nama sama dalam satu batch drain:
+    //   None   : semua dijalankan berurutan
+    //   Latest : hanya data terakhir yang dijalankan (posisi kemunculan pertama)
+    //   Sum    : dijalankan sekali dengan data {"steps": jumlah kemunculan}
+    enum class Coalesce {
+        None,
+        Latest,
+        Sum
+    };
+
+    // Registrasi sebaiknya sebelum thread worker start; event baru dari backend
+    // cukup didaftarkan di sini, tanpa menambah rantai if/else.
+    void registerHandler(const QString &eventName, Handler handler, Coalesce coalesce = Coalesce::None);
+    void registerPrefixHandler(const QString &prefix, Handler handler);
+
     void enqueue(const QString &eventName, const QJsonValue &data);
+
+    // Event yang masih antre dibuang; aman dipanggil dari thread lain,
+    // setelah itu thread worker boleh di-quit().
     void stop();
 
 signals:
     void volumeGetRequested();
     void volumeSetRequested(int value);
 
-    void volumeIncreaseReq();
-    void volumeDecreaseReq();
+    // steps > 0 naik, < 0 turun; burst INCREASE/DECREASE digabung jadi satu
+    void volumeStepReq(int steps);
 
     void brightnessSetRequested(int value);
     void brightnessGetRequested();
 
-    void brightnessIncreaseReq();
-    void brightnessDecreaseReq();
+    void brightnessStepReq(int steps);
 
     //Robot mode
     void modeSleep();
@@ -85,13 +120,33 @@ signals:
     void tzGetReq();
     void powerInfoRequest();
     void audioRadarInfoRequest();
+    void metricsInfoRequest();
+    void radarStreamSet(bool enabled);
 
-public slots:
-    void process();
+private slots:
+    void drainQueue();
 
 private:
-    QQueue<QPair<QString, QJsonValue>> m_queue;
-    QMutex m_mutex;
-    QWaitCondition m_cond;
-    bool m_running;
+    using Event = QPair<QString, QJsonValue>;
+
+    struct Entry {
+        Handler handler;
+        Coalesce coalesce = Coalesce::None;
+    };
+
+    void registerBuiltinHandlers();
+    void coalesceBatch(QVector<Event> &batch) const;
+    void dispatch(const QString &eventName, const QJsonValue &data);
+    void scheduleDrain();
+
+    // Lookup exact O(1); prefix hanya dicoba kalau exact tidak ketemu.
+    QHash<QString, Entry> m_handlers;
+    QVector<QPair<QString, Handler>> m_prefixHandlers;
+
+    MpscQueue<Event> m_queue;
+    std::atomic<bool> m_drainPending{false};
+    std::atomic<bool> m_running{true};
+
+    // Batas event per drain supaya event lain di thread worker tetap jalan.
+    static constexpr int MAX_BATCH = 64;
 };
@@ -6,10 +6,24 @@
 //#include <cmath>
 //#include <iostream>
 #include <QRandomGenerator>  // <-- TAMBAHKAN INI
+#include <QElapsedTimer>
+#include <QUuid>
+#include <algorithm>
+#include <vector>
+#include "falllatency.h"
+#include "metrics.h"
+#include "traceevent.h"
+#include "telemetrycodec.h"
 
 //ST-2026-04-IND-PRD-V1-000001
 
 SocketIOClient::SocketIOClient(QObject *parent)
+    : SocketIOClient(defaultJournalPath(), parent)
+{
+}
+
+//------------------------------------------------------------------------
+SocketIOClient::SocketIOClient(const QString &journalPath, QObject *parent)
     : QObject(parent)
     , m_webSocket(nullptr)
     , m_pingTimer(new QTimer(this))
@@ -17,6 +31,7 @@ SocketIOClient::SocketIOClient(QObject *parent)
     , m_isConnected(false)
     , m_packetId(0)
     , m_reconnectAttempts(0)
+    , m_nextAckId(1)
     , m_port(3000)
     , m_version(SocketIOVersion::V4)
 {
@@ -35,8 +50,34 @@ SocketIOClient::SocketIOClient(QObject *parent)
 
     connect(&m_queueTimer,&QTimer::timeout,this,&SocketIOClient::processEventQueue);
 
-    vol = sioVolume.getVolumePercent();
-    britnes = sioBritness.getBrightnessPercent();
+    // Selain prefix "INCIDENT_" (critical) dan default (control).
+    m_eventLanes.insert(QStringLiteral("WAKE_UP_BY_FALL_DETECTION"), EventLane::Critical);
+    m_eventLanes.insert(QStringLiteral("DEVICE_POWER_INFO"), EventLane::Telemetry);
+    m_eventLanes.insert(QStringLiteral("DEVICE_STATUS_INFO"), EventLane::Telemetry);
+    m_eventLanes.insert(QStringLiteral("DEVICE_METRICS_INFO"), EventLane::Telemetry);
+
+    // Selain ACK Socket.IO, event aplikasi ini juga menandakan alarm sudah sampai.
+    m_journalAckEvents.insert(QStringLiteral("ACK_FALL_EVENT_DETECTED"),
+                              {QStringLiteral("INCIDENT_FALL_EVENT_DETECTED"),
+                               QStringLiteral("WAKE_UP_BY_FALL_DETECTION")});
+
+    m_journal = new EventJournal(journalPath, this);
+
+    if (m_journal->open()) {
+        replayJournal();
+    } else {
+        qWarning() << "Event journal tidak aktif, queue hanya di memory";
+    }
+}
+
+//------------------------------------------------------------------------
+QString SocketIOClient::defaultJournalPath()
+{
+#ifdef Q_OS_LINUX
+    return QStringLiteral("/home/pi/app/radarScan-outbox.journal");
+#else
+    return QStringLiteral("/Volumes/DATA/app/radarScan-outbox.journal");
+#endif
 }
 
 //------------------------------------------------------------------------
@@ -82,6 +123,7 @@ void SocketIOClient::sendSocketIoConnectWithAuth()
 {
     QJsonObject auth;
     auth["robotId"] = "TESTING-1";
+    auth["capabilities"] = QJsonArray{QString::fromLatin1(telemetry::CAPABILITY)};
 
     QString authJson = QString::fromUtf8(
         QJsonDocument(auth).toJson(QJsonDocument::Compact)
@@ -104,38 +146,249 @@ void SocketIOClient::sendSocketIoConnectWithAuth()
     }
 }
 
-void SocketIOClient::enqueueEvent(const QString &eventName, const QJsonObject &data)
+void SocketIOClient::enqueueEvent(const QString &eventName, const QJsonObject &data, quint64 latencyId)
+{
+    enqueue(eventName, data, latencyId, QByteArray());
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::enqueueTelemetry(const QString &eventName, const QJsonObject &json, const QByteArray &binary)
+{
+    enqueue(eventName, json, 0, binary);
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::enqueue(const QString &eventName, const QJsonObject &data, quint64 latencyId, const QByteArray &attachment)
 {
     /*
       * Queue tetap menerima event walaupun socket sedang disconnect.
       * Event akan dikirim setelah socket kembali connected.
       */
 
-     if (m_eventQueue.size() >= MAX_QUEUE_SIZE) {
-         qWarning() << "Event queue penuh. Event tertua dibuang:"
-                    << m_eventQueue.head().eventName;
+     const EventLane lane = laneForEvent(eventName);
+     QQueue<QueuedEvent> &queue = m_laneQueue[int(lane)];
+     const qint64 nowNs = trace::nowNs();
+
+     if (latencyId)
+         FallLatencyTracker::instance().mark(latencyId, FallLatencyTracker::Enqueue, nowNs);
+
+     // Telemetry: yang masih antre cukup diganti dengan nilai terbaru.
+     if (lane == EventLane::Telemetry) {
+         for (QueuedEvent &pending : queue) {
+             if (pending.eventName == eventName) {
+                 // Nilai lama di journal diganti record baru.
+                 acknowledgeJournal(pending);
+                 pending.journalSeq = m_volatileEvents.contains(eventName)
+                                          ? 0 : m_journal->append(eventName, data, false);
+                 pending.data = data;
+                 pending.attachment = attachment;
+                 pending.enqueuedNs = nowNs;
+                 METRIC_COUNTER("socketio.telemetry_coalesced").inc();
+
+                 if (m_isConnected && !m_queueTimer.isActive())
+                     scheduleQueueDrain(true);
+                 return;
+             }
+         }
+     }
+
+     // Critical tidak dibuang, jadi retry event yang sama (mis. saat
+     // disconnect) jangan sampai menumpuk di queue.
+     if (lane == EventLane::Critical) {
+         for (const QueuedEvent &pending : queue) {
+             if (pending.eventName == eventName && pending.data == data)
+                 return;
+         }
+     }
 
-         m_eventQueue.dequeue();
+     if (pendingEventCount() >= MAX_QUEUE_SIZE) {
+         // Event critical tidak pernah dibuang; kalau yang tersisa hanya
+         // critical, event non-critical yang baru ini yang dibuang.
+         if (!evictOldestNonCritical() && lane != EventLane::Critical) {
+             qWarning() << "Event queue penuh (critical). Event baru dibuang:" << eventName;
+             METRIC_COUNTER("socketio.queue_dropped").inc();
+             return;
+         }
      }
 
      QueuedEvent event;
      event.eventName = eventName;
      event.data = data;
+     event.enqueuedNs = nowNs;
+     event.latencyId = latencyId;
+     event.attachment = attachment;
 
-     m_eventQueue.enqueue(event);
+     // Dari enqueueReliableEvent: dikirim dengan ACK + retry, tetap di journal sampai ACK
+     event.idempotencyKey = data.value("idempotency_key").toString();
 
-     qDebug() << "Event masuk queue:"
-              << eventName
-              << "| queue size:"
-              << m_eventQueue.size();
+     // Ditulis ke journal sebelum return; insiden langsung di-msync.
+     if (!m_volatileEvents.contains(eventName))
+         event.journalSeq = m_journal->append(eventName, data, lane == EventLane::Critical);
+
+     queue.enqueue(event);
+
+     METRIC_COUNTER("socketio.enqueued").inc();
+     METRIC_GAUGE("socketio.queue_depth").set(pendingEventCount());
+
+     qCDebug(lcHotPath) << "Event masuk queue:"
+                        << eventName
+                        << "| lane:" << int(lane)
+                        << "| queue size:"
+                        << pendingEventCount();
+
+     if (!m_isConnected)
+         return;
+
+     // Insiden tidak menunggu tick timer.
+     if (lane == EventLane::Critical) {
+         flushCriticalLane();
+         return;
+     }
 
      /*
       * Jalankan pemrosesan secara asynchronous.
       * Tidak langsung memanggil fungsi pengiriman pada call stack yang sama.
       */
-    if (m_isConnected && !m_queueTimer.isActive()) {
+    if (!m_queueTimer.isActive()) {
+        scheduleQueueDrain(true);
+    }
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::setEventLane(const QString &eventName, EventLane lane)
+{
+    m_eventLanes.insert(eventName, lane);
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::setDrainBudget(qint64 maxBufferedBytes, int maxTickMs)
+{
+    m_drainMaxBufferedBytes = qMax<qint64>(1024, maxBufferedBytes);
+    m_drainMaxTickMs = qMax(1, maxTickMs);
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::scheduleQueueDrain(bool immediate)
+{
+    // immediate: masih ada backlog dan socket sanggup menerima, jalan di
+    // putaran event loop berikutnya. Selain itu kembali ke interval normal.
+    const int interval = immediate ? 0 : QUEUE_PROCESS_INTERVAL_MS;
+
+    if (m_queueTimer.interval() != interval)
+        m_queueTimer.setInterval(interval);
+
+    if (!m_queueTimer.isActive())
         m_queueTimer.start();
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::replayJournal()
+{
+    const QVector<EventJournal::Entry> entries = m_journal->pendingEntries();
+
+    if (entries.isEmpty())
+        return;
+
+    qDebug() << "Replay event journal:" << entries.size() << "event";
+
+    for (const EventJournal::Entry &entry : entries) {
+        QueuedEvent event;
+        event.eventName = entry.eventName;
+        event.data = entry.data;
+        event.enqueuedNs = trace::nowNs();
+        event.journalSeq = entry.seq;
+        event.idempotencyKey = entry.data.value("idempotency_key").toString();
+
+        // Event reliable tetap reliable setelah restart (key yang sama).
+        const EventLane lane = event.idempotencyKey.isEmpty() ? laneForEvent(entry.eventName)
+                                                              : EventLane::Critical;
+        m_laneQueue[int(lane)].enqueue(event);
     }
+
+    METRIC_COUNTER("socketio.journal_replayed").inc(quint64(entries.size()));
+    METRIC_GAUGE("socketio.queue_depth").set(pendingEventCount());
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::acknowledgeJournal(const QueuedEvent &event)
+{
+    if (event.journalSeq)
+        m_journal->acknowledge(event.journalSeq);
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::handleServerAckEvent(const QString &eventName)
+{
+    auto it = m_journalAckEvents.constFind(eventName);
+    if (it == m_journalAckEvents.constEnd())
+        return;
+
+    // Server lama hanya membalas lewat event, tanpa ACK Socket.IO.
+    const QStringList acked = it.value();
+    const QStringList keys = m_inFlight.keys();
+
+    for (const QString &key : keys) {
+        if (acked.contains(m_inFlight.value(key).eventName))
+            settleReliable(key);
+    }
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::setEventPersistent(const QString &eventName, bool persistent)
+{
+    if (persistent)
+        m_volatileEvents.remove(eventName);
+    else
+        m_volatileEvents.insert(eventName);
+}
+
+//------------------------------------------------------------------------
+qint64 SocketIOClient::outboundBufferedBytes() const
+{
+    return (m_webSocket && m_isConnected) ? m_webSocket->bytesToWrite() : 0;
+}
+
+//------------------------------------------------------------------------
+int SocketIOClient::pendingEventCount() const
+{
+    int total = 0;
+    for (const QQueue<QueuedEvent> &queue : m_laneQueue)
+        total += queue.size();
+    return total;
+}
+
+//------------------------------------------------------------------------
+SocketIOClient::EventLane SocketIOClient::laneForEvent(const QString &eventName) const
+{
+    auto it = m_eventLanes.constFind(eventName);
+    if (it != m_eventLanes.constEnd())
+        return it.value();
+
+    if (eventName.startsWith(QLatin1String("INCIDENT_")))
+        return EventLane::Critical;
+
+    return EventLane::Control;
+}
+
+//------------------------------------------------------------------------
+bool SocketIOClient::evictOldestNonCritical()
+{
+    // Telemetry dulu, baru control.
+    for (int lane = LANE_COUNT - 1; lane > int(EventLane::Critical); --lane) {
+        QQueue<QueuedEvent> &queue = m_laneQueue[lane];
+
+        if (!queue.isEmpty()) {
+            qWarning() << "Event queue penuh. Event tertua dibuang:"
+                       << queue.head().eventName;
+
+            acknowledgeJournal(queue.head());
+            queue.dequeue();
+            METRIC_COUNTER("socketio.queue_dropped").inc();
+            return true;
+        }
+    }
+
+    return false;
 }
 
 //------------------------------------------------------------------------
@@ -154,6 +407,14 @@ void SocketIOClient::setupWebSocket()
     connect(m_webSocket, &QWebSocket::textMessageReceived,
             this, &SocketIOClient::onWebSocketTextMessage);
 
+    // Buffer socket mulai kosong: lanjutkan backlog tanpa menunggu tick 100 ms.
+    connect(m_webSocket, &QWebSocket::bytesWritten, this, [this]() {
+        if (m_isConnected && pendingEventCount() > 0
+            && m_webSocket->bytesToWrite() < m_drainMaxBufferedBytes / 2) {
+            scheduleQueueDrain(true);
+        }
+    });
+
     // Gunakan macro untuk kompatibilitas
     CONNECT_WEBSOCKET_ERROR(m_webSocket, this, &SocketIOClient::onWebSocketError);
 }
@@ -221,6 +482,8 @@ void SocketIOClient::onWebSocketConnected()
                       QStringLiteral("TESTING-1"));
 
     authObject.insert(QStringLiteral("processor_id"), m_cpuSerial);
+    authObject.insert(QStringLiteral("capabilities"),
+                      QJsonArray{QString::fromLatin1(telemetry::CAPABILITY)});
     const QByteArray jsonData = QJsonDocument(authObject).toJson(QJsonDocument::Compact);
     const QString payload = QStringLiteral("40") + QString::fromUtf8(jsonData);
 
@@ -231,8 +494,8 @@ void SocketIOClient::onWebSocketConnected()
     /*
      * Kirim event-event yang sebelumnya tertahan.
      */
-    if (!m_eventQueue.isEmpty() && !m_queueTimer.isActive()) {
-        m_queueTimer.start();
+    if (pendingEventCount() > 0 && !m_queueTimer.isActive()) {
+        scheduleQueueDrain(true);
     }
 }
 
@@ -243,7 +506,9 @@ void SocketIOClient::onWebSocketDisconnected()
     //m_pingTimer->stop();
     qDebug() << "WebSocket disconnected";
     m_queueTimer.stop();
+    m_binaryTelemetry = false;
 
+    requeueInFlight();
     m_ackCallbacks.clear();
     scheduleReconnect();
     emit disconnected();
@@ -252,37 +517,39 @@ void SocketIOClient::onWebSocketDisconnected()
 //------------------------------------------------------------------------
 void SocketIOClient::onWebSocketTextMessage(const QString &message)
 {
-    qDebug() << "Received message:" << message;
+    METRIC_COUNTER("socketio.rx_messages").inc();
+    qCDebug(lcHotPath) << "Received message:" << message;
 
-    parseSocketIOMessage(message);
+    // QWebSocket memberi QString; satu kali konversi, selanjutnya UTF-8.
+    parseSocketIOMessage(message.toUtf8());
 }
 
 //------------------------------------------------------------------------
-void SocketIOClient::parseSocketIOMessage(const QString &message)
+void SocketIOClient::parseSocketIOMessage(const QByteArray &message)
 {
     if (message.isEmpty()) {
         qDebug() << "Empty message received";
         return;
     }
 
-    bool ok;
-    int packetType = QString(message[0]).toInt(&ok);
-    if (!ok) {
+    socketio::Packet packet;
+    if (!socketio::parsePacket(message, packet)) {
         qWarning() << "Invalid packet type:" << message;
         return;
     }
 
-    QString data = message.mid(1);
-    handleSocketIOJsonPacket(packetType, data);
+    handleSocketIOJsonPacket(packet);
 }
 
 //------------------------------------------------------------------------
-void SocketIOClient::handleSocketIOJsonPacket(int type, const QString &data)
+void SocketIOClient::handleSocketIOJsonPacket(const socketio::Packet &packet)
 {
-    switch (type) {
+    const QByteArray &data = packet.payload;
+
+    switch (packet.engineType) {
     case 0: { // Engine.IO OPEN
         if (!data.isEmpty()) {
-            QJsonDocument doc = QJsonDocument::fromJson(data.toUtf8());
+            QJsonDocument doc = QJsonDocument::fromJson(data);
 
             if (doc.isObject()) {
                 QJsonObject obj = doc.object();
@@ -325,24 +592,22 @@ void SocketIOClient::handleSocketIOJsonPacket(int type, const QString &data)
         break;
 
     case 4: { // MESSAGE (Engine.IO)
-        if (data.isEmpty()) break;
-
-        // Data diawali subtype Socket.IO:
+        // Subtype Socket.IO (sudah dipisah parsePacket):
         // 0{...} -> CONNECT
-        // 2["EVENT","DATA"]
-        // 3[ackId,"RESPONSE"]
+        // 2[ackId]["EVENT","DATA"]
+        // 3ackId["RESPONSE"]
 
-        QChar subTypeChar = data[0];
-        QString subData = data.mid(1);
+        const int subType = packet.socketType;
+        const QByteArray &subData = data;
 
-        int subType = subTypeChar.digitValue();
+        if (subType < 0) break;
 
         if (subType == 0) { // Socket.IO CONNECT accepted
             QString sid;
 
             if (!subData.isEmpty()) {
                 QJsonParseError err;
-                QJsonDocument doc = QJsonDocument::fromJson(subData.toUtf8(), &err);
+                QJsonDocument doc = QJsonDocument::fromJson(subData, &err);
 
                 if (err.error == QJsonParseError::NoError && doc.isObject()) {
                     QJsonObject obj = doc.object();
@@ -359,6 +624,9 @@ void SocketIOClient::handleSocketIOJsonPacket(int type, const QString &data)
 
             emit connected(sid);
 
+            // Insiden yang tertahan selama disconnect dikirim duluan.
+            flushCriticalLane();
+
             // Baru aman kirim DEVICE_READY di sini
             QTimer::singleShot(300, this, [this]() {
                 if (!m_isConnected) {
@@ -372,7 +640,7 @@ void SocketIOClient::handleSocketIOJsonPacket(int type, const QString &data)
         }
 
         else if (subType == 2) { // EVENT
-            QJsonDocument doc = QJsonDocument::fromJson(subData.toUtf8());
+            QJsonDocument doc = QJsonDocument::fromJson(subData);
             if (!doc.isArray()) {
                 qWarning() << "Invalid event JSON:" << subData;
                 return;
@@ -387,15 +655,20 @@ void SocketIOClient::handleSocketIOJsonPacket(int type, const QString &data)
             QString eventName = arr[0].toString();
             QJsonValue dataValue = arr[1];
 
-            int ackId = -1;
-            if (arr.size() >= 3 && arr[2].isDouble()) {
+            int ackId = int(packet.ackId);
+            if (ackId < 0 && arr.size() >= 3 && arr[2].isDouble()) {
                 ackId = arr[2].toInt();
             }
 
-            qDebug() << "Parse Event:" << eventName
+            qCDebug(lcHotPath) << "Parse Event:" << eventName
                      << "Data:" << dataValue
                      << "AckId:" << ackId;
 
+            handleServerAckEvent(eventName);
+
+            if (eventName == QLatin1String("TELEMETRY_FORMAT"))
+                handleTelemetryFormat(dataValue);
+
             // ===== DEDUPLICATION LOGIC =====
             if (eventName == m_lastEventName && dataValue == m_lastEventData) {
                 qDebug() << "Duplicate event skipped:" << eventName << dataValue;
@@ -413,26 +686,19 @@ void SocketIOClient::handleSocketIOJsonPacket(int type, const QString &data)
 
         else if (subType == 3) { // ACK
 
-            int pos = 0;
-
-            // cari posisi '[' pertama
-            while (pos < subData.size() && subData[pos].isDigit())
-                pos++;
-
-            int ackId = subData.left(pos).toInt();
-            QString jsonPart = subData.mid(pos);
+            const int ackId = int(packet.ackId);
 
-            QJsonDocument doc = QJsonDocument::fromJson(jsonPart.toUtf8());
+            QJsonDocument doc = QJsonDocument::fromJson(subData);
 
             if (!doc.isArray()) {
-                qWarning() << "Invalid ACK JSON:" << jsonPart;
+                qWarning() << "Invalid ACK JSON:" << subData;
                 return;
             }
 
             QJsonArray arr = doc.array();
             QJsonValue ackData = arr.isEmpty() ? QJsonValue() : arr[0];
 
-            qDebug() << "ACK received:" << ackId << ackData;
+            qCDebug(lcHotPath) << "ACK received:" << ackId << ackData;
 
             handleIncomingAck(ackId, ackData);
         }
@@ -461,7 +727,7 @@ void SocketIOClient::handleSocketIOJsonPacket(int type, const QString &data)
         break;
 
     default:
-        qWarning() << "Unknown packet type:" << type;
+        qWarning() << "Unknown packet type:" << packet.engineType;
         break;
     }
 }
@@ -470,11 +736,11 @@ void SocketIOClient::handleSocketIOJsonPacket(int type, const QString &data)
 //------------------------------------------------------------------------
 void SocketIOClient::handleIncomingAck(int ackId, const QJsonValue &data)
 {
-    qDebug() << "ACK received for id:" << ackId << "Data:" << data;
+    qCDebug(lcHotPath) << "ACK received for id:" << ackId << "Data:" << data;
 
     auto it = m_ackCallbacks.find(ackId);
     if (it != m_ackCallbacks.end()) {
-        auto callback = it->second;
+        auto callback = it->second.callback;
         m_ackCallbacks.erase(it);
         if(callback){
           callback(true, data); //success = true
@@ -690,48 +956,74 @@ void SocketIOClient::emitEventStringMsgJsoned(const QString &eventName,
         return;
     }
 
-    QJsonValue fixedData = data;
+    // Field "timestamp" string ISO dikirim sebagai epoch ms (lihat PacketWriter).
+    const QByteArray packet = m_packetWriter.event(eventName, data);
 
-    // 🔥 Jika object, cek field timestamp
-    if (data.isObject()) {
-        QJsonObject obj = data.toObject();
+    // QWebSocket hanya menerima QString untuk text frame.
+    m_webSocket->sendTextMessage(QString::fromUtf8(packet));
 
-        if (obj.contains("timestamp")) {
-            QJsonValue ts = obj.value("timestamp");
+    METRIC_COUNTER("socketio.tx_events").inc();
+    METRIC_COUNTER("socketio.tx_bytes").inc(quint64(packet.size()));
 
-            // ❌ kalau string → convert ke number (ms)
-            if (ts.isString()) {
-                QDateTime dt = QDateTime::fromString(ts.toString(), Qt::ISODate);
-                if (dt.isValid()) {
-                    obj["timestamp"] = dt.toMSecsSinceEpoch(); // jadi number
-                } else {
-                    qWarning() << "Invalid timestamp string format";
-                }
-            }
-        }
+    qCDebug(lcHotPath) << "Emitted event:" << eventName
+                       << "Payload:" << packet;
+}
 
-        fixedData = obj;
+
+
+//------------------------------------------------------------------------
+void SocketIOClient::emitBinaryEvent(const QString &eventName, const QByteArray &attachment)
+{
+    if (!m_isConnected || !m_webSocket) {
+        qWarning() << "Not connected, cannot emit:" << eventName;
+        return;
     }
 
-    QJsonArray packetArray;
-    packetArray.append(eventName);
-    packetArray.append(fixedData);
+    const QByteArray packet = m_packetWriter.binaryEvent(eventName, 1);
 
-    QJsonDocument doc(packetArray);
-    QString message = "42" + QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
+    m_webSocket->sendTextMessage(QString::fromUtf8(packet));
 
-    m_webSocket->sendTextMessage(message);
+    // EIO=3 memberi prefix byte 0x04 (message) di frame biner, EIO=4 tidak.
+    if (m_version == SocketIOVersion::V4)
+        m_webSocket->sendBinaryMessage(attachment);
+    else
+        m_webSocket->sendBinaryMessage(QByteArray(1, '\x04') + attachment);
 
-    qDebug() << "Emitted event:" << eventName
-             << "Payload:" << message;
+    METRIC_COUNTER("socketio.tx_events").inc();
+    METRIC_COUNTER("socketio.tx_bytes").inc(quint64(packet.size()));
+    METRIC_COUNTER("socketio.tx_binary_bytes").inc(quint64(attachment.size()));
+
+    qCDebug(lcHotPath) << "Emitted binary event:" << eventName
+                       << "| attachment bytes:" << attachment.size();
 }
 
+//------------------------------------------------------------------------
+void SocketIOClient::handleTelemetryFormat(const QJsonValue &payload)
+{
+    const QJsonObject obj = payload.toObject();
+
+    // {"format":"binary","version":1} -> aktif; selain itu kembali ke JSON.
+    const bool binary = obj.value("format").toString() == QLatin1String("binary")
+                        && obj.value("version").toInt() == telemetry::FORMAT_VERSION;
+
+    if (binary != m_binaryTelemetry)
+        qDebug() << "Telemetry format:" << (binary ? "binary" : "json");
 
+    m_binaryTelemetry = binary;
+}
 
 //------------------------------------------------------------------------
 void SocketIOClient::emitEventWithAck(const QString &eventName,
                                        const QJsonObject &data,
                                        std::function<void(bool, QJsonValue)> callback, int timeoutMs)
+{
+    sendWithAck(eventName, data, std::move(callback), timeoutMs, false);
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::sendWithAck(const QString &eventName,
+                                  const QJsonObject &data,
+                                  std::function<void(bool, QJsonValue)> callback, int timeoutMs, bool reliable)
 {
     if (!m_isConnected || !m_webSocket) {
         qWarning() << "Not connected, cannot emit:" << eventName;
@@ -746,22 +1038,17 @@ void SocketIOClient::emitEventWithAck(const QString &eventName,
             m_nextAckId = 1;
     } while (m_ackCallbacks.count(ackId));
 
-    m_ackCallbacks.emplace(ackId, std::move(callback));
+    m_ackCallbacks.emplace(ackId, PendingAck{std::move(callback), reliable});
 
-    if(m_ackCallbacks.size() > 1000) {
-        qWarning() << "ACK map too large! Possible leak:" << m_ackCallbacks.size();
-        qWarning() << "FORCE CLEAR ACK MAP!";
-        m_ackCallbacks.clear();
-    }
+    if (m_ackCallbacks.size() > MAX_PENDING_ACKS)
+        evictAckCallbacks();
 
-    QJsonArray arr;
-    arr.append(eventName);
-    arr.append(data);
+    const QByteArray packet = m_packetWriter.event(eventName, data, qint64(ackId), false);
 
-    QString message = "42" + QString::number(ackId) +
-                      QString::fromUtf8(QJsonDocument(arr).toJson(QJsonDocument::Compact));
+    m_webSocket->sendTextMessage(QString::fromUtf8(packet));
 
-    m_webSocket->sendTextMessage(message);
+    METRIC_COUNTER("socketio.tx_events").inc();
+    METRIC_COUNTER("socketio.tx_bytes").inc(quint64(packet.size()));
 
     // timeout handler
     QTimer::singleShot(timeoutMs, this, [this, ackId]() {
@@ -770,7 +1057,7 @@ void SocketIOClient::emitEventWithAck(const QString &eventName,
         if (it == m_ackCallbacks.end())
             return; // ACK sudah datang
 
-        auto cb = it->second;
+        auto cb = it->second.callback;
         m_ackCallbacks.erase(it);
 
         if (cb) {
@@ -781,6 +1068,38 @@ void SocketIOClient::emitEventWithAck(const QString &eventName,
     });
 }
 
+//------------------------------------------------------------------------
+void SocketIOClient::evictAckCallbacks()
+{
+    // Callback non-reliable tertua digagalkan eksplisit supaya pemanggil tahu;
+    // callback event reliable tetap menunggu ACK / timeout -> retry.
+    std::vector<std::function<void(bool, QJsonValue)>> dropped;
+
+    for (auto it = m_ackCallbacks.begin();
+         it != m_ackCallbacks.end() && m_ackCallbacks.size() > MAX_PENDING_ACKS;) {
+        if (it->second.reliable) {
+            ++it;
+            continue;
+        }
+
+        dropped.push_back(std::move(it->second.callback));
+        it = m_ackCallbacks.erase(it);
+    }
+
+    if (dropped.empty())
+        return;
+
+    qWarning() << "ACK map too large, dropping" << dropped.size() << "oldest non-reliable callbacks"
+               << "| pending:" << m_ackCallbacks.size();
+    METRIC_COUNTER("socketio.ack_dropped").inc(quint64(dropped.size()));
+
+    // Dipanggil setelah map konsisten: callback boleh emit lagi
+    for (const auto &cb : dropped) {
+        if (cb)
+            cb(false, QJsonValue("ack dropped"));
+    }
+}
+
 //------------------------------------------------------------------------
 void SocketIOClient::emitEventWithAckqString(const QString &eventName,
                                       const QString &data,
@@ -937,40 +1256,238 @@ void SocketIOClient::processEventQueue()
         return;
     }
 
-    if (!m_isConnected) {
+    if (!m_isConnected || !m_webSocket) {
         m_queueTimer.stop();
         return;
     }
 
-    if (m_eventQueue.isEmpty()) {
+    if (pendingEventCount() == 0) {
         m_queueTimer.stop();
         return;
     }
 
+    TRACE_SCOPE("socketio.processEventQueue");
+
     m_processingQueue = true;
 
     /*
-     * Ambil event paling depan.
-     *
-     * Jangan langsung dequeue sebelum fungsi pengiriman dipanggil.
-     * Event baru dihapus dari queue setelah perintah pengiriman dijalankan.
+     * Kirim sebanyak mungkin event dalam satu tick, selama buffer tulis
+     * socket masih di bawah budget dan tick belum melewati batas waktu.
+     * Event selalu diambil dari lane dengan prioritas tertinggi.
      */
-    const QueuedEvent event = m_eventQueue.head();
+    QElapsedTimer tick;
+    tick.start();
 
-    emitEventStringMsgJsoned(event.eventName, event.data);
+    int sent = 0;
+    bool socketFull = false;
 
-    m_eventQueue.dequeue();
+    while (m_isConnected) {
+        if (m_webSocket->bytesToWrite() >= m_drainMaxBufferedBytes) {
+            socketFull = true;
+            break;
+        }
+
+        if (sent > 0 && tick.elapsed() >= m_drainMaxTickMs)
+            break;
 
-    qDebug() << "Event dikirim dari queue:"
-             << event.eventName
-             << "| queue tersisa:"
-             << m_eventQueue.size();
+        QQueue<QueuedEvent> *queue = nullptr;
+        for (QQueue<QueuedEvent> &lane : m_laneQueue) {
+            if (!lane.isEmpty()) {
+                queue = &lane;
+                break;
+            }
+        }
+
+        if (!queue)
+            break;
+
+        /*
+         * Jangan langsung dequeue sebelum fungsi pengiriman dipanggil.
+         * Event baru dihapus dari queue setelah perintah pengiriman dijalankan.
+         */
+        sendQueuedEvent(queue->head());
+        queue->dequeue();
+        ++sent;
+    }
+
+    METRIC_HISTOGRAM("socketio.batch_size").record(quint64(sent));
+    METRIC_GAUGE("socketio.queue_depth").set(pendingEventCount());
+
+    qCDebug(lcHotPath) << "Batch queue terkirim:" << sent
+                       << "| queue tersisa:" << pendingEventCount()
+                       << "| bytesToWrite:" << m_webSocket->bytesToWrite();
 
     m_processingQueue = false;
 
-    if (m_eventQueue.isEmpty()) {
+    if (pendingEventCount() == 0 || !m_isConnected) {
         m_queueTimer.stop();
+        return;
+    }
+
+    // Socket penuh: tunggu bytesWritten / tick normal. Habis waktu: lanjut segera.
+    scheduleQueueDrain(!socketFull);
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::sendQueuedEvent(const QueuedEvent &event)
+{
+    if (!event.idempotencyKey.isEmpty()) {
+        // Tetap di journal sampai ACK.
+        sendReliable(event);
+    } else if (m_binaryTelemetry && !event.attachment.isEmpty()) {
+        emitBinaryEvent(event.eventName, event.attachment);
+        acknowledgeJournal(event);
+    } else {
+        emitEventStringMsgJsoned(event.eventName, event.data);
+        acknowledgeJournal(event);
     }
+
+    const qint64 sentNs = trace::nowNs();
+    METRIC_HISTOGRAM("socketio.queue_wait_us").record(quint64(std::max<qint64>(0, (sentNs - event.enqueuedNs) / 1000)));
+
+    if (event.latencyId)
+        FallLatencyTracker::instance().mark(event.latencyId, FallLatencyTracker::Send, sentNs);
+}
+
+//------------------------------------------------------------------------
+QString SocketIOClient::enqueueReliableEvent(const QString &eventName, const QJsonObject &data, quint64 latencyId)
+{
+    const QString key = QUuid::createUuid().toString(QUuid::WithoutBraces);
+
+    // Server memakai key ini untuk membuang duplikat dari retry.
+    QJsonObject payload = data;
+    payload["idempotency_key"] = key;
+
+    if (laneForEvent(eventName) != EventLane::Critical)
+        setEventLane(eventName, EventLane::Critical);
+
+    enqueueEvent(eventName, payload, latencyId);
+
+    return key;
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::sendReliable(const QueuedEvent &event)
+{
+    QueuedEvent inFlight = event;
+    inFlight.attempts++;
+
+    const QString key = inFlight.idempotencyKey;
+    const int attempt = inFlight.attempts;
+
+    m_inFlight.insert(key, inFlight);
+
+    METRIC_COUNTER("socketio.reliable_sent").inc();
+    if (attempt > 1)
+        METRIC_COUNTER("socketio.reliable_retries").inc();
+
+    qDebug() << "Reliable send:" << inFlight.eventName << "| key:" << key << "| attempt:" << attempt;
+
+    sendWithAck(inFlight.eventName, inFlight.data,
+                [this, key, attempt](bool ok, QJsonValue) {
+                    onReliableAck(key, attempt, ok);
+                },
+                RELIABLE_ACK_TIMEOUT_MS, true);
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::onReliableAck(const QString &key, int attempt, bool ok)
+{
+    auto it = m_inFlight.find(key);
+
+    // Sudah settle / sudah dikirim ulang dengan attempt lain.
+    if (it == m_inFlight.end() || it->attempts != attempt)
+        return;
+
+    if (ok) {
+        settleReliable(key);
+        return;
+    }
+
+    // Exponential backoff + jitter, event tetap di m_inFlight selama menunggu.
+    const int shift = qMin(attempt - 1, 5);
+    const int base = qMin(RELIABLE_BACKOFF_BASE_MS << shift, RELIABLE_BACKOFF_MAX_MS);
+    const int delay = base + int(QRandomGenerator::global()->bounded(base / 4 + 1));
+
+    qWarning() << "Reliable event belum di-ACK:" << it->eventName
+               << "| attempt:" << attempt << "| retry dalam" << delay << "ms";
+
+    QTimer::singleShot(delay, this, [this, key, attempt]() {
+        auto it = m_inFlight.find(key);
+        if (it == m_inFlight.end() || it->attempts != attempt)
+            return;
+
+        const QueuedEvent event = m_inFlight.take(key);
+        m_laneQueue[int(EventLane::Critical)].enqueue(event);
+        flushCriticalLane();
+    });
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::settleReliable(const QString &key)
+{
+    const QueuedEvent event = m_inFlight.take(key);
+
+    acknowledgeJournal(event);
+
+    if (event.latencyId)
+        FallLatencyTracker::instance().mark(event.latencyId, FallLatencyTracker::Ack);
+
+    METRIC_COUNTER("socketio.reliable_delivered").inc();
+    qDebug() << "Reliable event delivered:" << event.eventName << "| key:" << key
+             << "| attempts:" << event.attempts;
+
+    emit eventDelivered(event.eventName, key);
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::requeueInFlight()
+{
+    // Callback ACK hilang saat disconnect: kirim ulang sekali setelah reconnect.
+    QQueue<QueuedEvent> &critical = m_laneQueue[int(EventLane::Critical)];
+
+    for (const QueuedEvent &event : std::as_const(m_inFlight)) {
+        if (!isQueued(EventLane::Critical, event.idempotencyKey))
+            critical.enqueue(event);
+    }
+
+    m_inFlight.clear();
+}
+
+//------------------------------------------------------------------------
+bool SocketIOClient::isQueued(EventLane lane, const QString &idempotencyKey) const
+{
+    for (const QueuedEvent &event : m_laneQueue[int(lane)]) {
+        if (event.idempotencyKey == idempotencyKey)
+            return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------
+void SocketIOClient::flushCriticalLane()
+{
+    if (m_processingQueue || !m_isConnected)
+        return;
+
+    TRACE_SCOPE("socketio.flushCriticalLane");
+
+    m_processingQueue = true;
+
+    QQueue<QueuedEvent> &queue = m_laneQueue[int(EventLane::Critical)];
+
+    while (!queue.isEmpty() && m_isConnected) {
+        sendQueuedEvent(queue.head());
+        queue.dequeue();
+    }
+
+    METRIC_GAUGE("socketio.queue_depth").set(pendingEventCount());
+
+    m_processingQueue = false;
+
+    if (pendingEventCount() > 0 && !m_queueTimer.isActive())
+        scheduleQueueDrain(true);
 }
 
 //------------------------------------------------------------------------
@@ -12,8 +12,6 @@
 #include <functional>
 #include <map>
 #include <radar.h>
-#include <volume.h>
-#include <brightness.h>
 #include <VolumeMonitor.h>
 #include <QMutexLocker>
 #include <QMutex>
@@ -21,6 +19,10 @@
 #include <QObject>
 #include <QJsonObject>
 #include <QQueue>
+#include <QHash>
+#include <QSet>
+#include "eventjournal.h"
+#include "socketiopacket.h"
 #include <QTimer>
 
 // Macro untuk kompatibilitas Qt version
@@ -43,7 +45,18 @@ public:
         V2   // EIO=3 (v2 juga pakai EIO=3)
     };
 
+    // Lane prioritas queue outbound. Urutan enum = urutan pengiriman.
+    enum class EventLane {
+        Critical = 0,   // insiden jatuh: langsung dikirim, tidak pernah dibuang
+        Control,        // balasan ke backend (wifi, volume, status, ...)
+        Telemetry       // data periodik: hanya nilai terbaru per event yang disimpan
+    };
+
     explicit SocketIOClient(QObject *parent = nullptr);
+    // journalPath: lokasi outbox journal (default defaultJournalPath())
+    explicit SocketIOClient(const QString &journalPath, QObject *parent = nullptr);
+
+    static QString defaultJournalPath();
 
     ~SocketIOClient();
 
@@ -57,7 +70,34 @@ public:
     void sendSocketIoConnectWithAuth();
 
     // Fungsi baru untuk memasukkan event ke queue
-    void enqueueEvent(const QString &eventName, const QJsonObject &data);
+    // latencyId: id FallLatencyTracker untuk event alarm jatuh (0 = bukan alarm)
+    void enqueueEvent(const QString &eventName, const QJsonObject &data, quint64 latencyId = 0);
+    void setEventLane(const QString &eventName, EventLane lane);
+
+    // Telemetry dengan dua bentuk: JSON (default) dan frame biner yang dipakai
+    // kalau server sudah menyetujui format biner (TELEMETRY_FORMAT).
+    void enqueueTelemetry(const QString &eventName, const QJsonObject &json, const QByteArray &binary);
+    bool binaryTelemetryEnabled() const { return m_binaryTelemetry; }
+
+    // Event yang tidak perlu bertahan saat restart (stream live) tidak dijournal.
+    void setEventPersistent(const QString &eventName, bool persistent);
+
+    // Byte yang masih tertahan di buffer tulis WebSocket.
+    qint64 outboundBufferedBytes() const;
+
+    // At-least-once: event dikirim dengan ACK Socket.IO + idempotency_key,
+    // diulang dengan backoff sampai ACK datang. Selalu lewat lane critical.
+    // Mengembalikan idempotency key.
+    QString enqueueReliableEvent(const QString &eventName, const QJsonObject &data, quint64 latencyId = 0);
+    int pendingEventCount() const;
+
+    // Batas pengiriman per tick queue: berhenti kalau buffer tulis socket
+    // sudah >= maxBufferedBytes atau tick sudah berjalan >= maxTickMs.
+    void setDrainBudget(qint64 maxBufferedBytes, int maxTickMs);
+
+    // Level untuk DEVICE_READY (diisi dari VolumeMonitor / brightness)
+    void setVolumeLevel(int percent) { vol = percent; }
+    void setBrightnessLevel(int percent) { britnes = percent; }
 
     //void emitEvent(const QString &eventName, const QJsonObject &data = QJsonObject());
     void emitEvent(const QString &eventName,const QJsonValue &data,std::function<void(QJsonValue)> ackCallback);
@@ -98,6 +138,7 @@ signals:
     //void eventReceived(const QString &eventName, const QJsonObject &data);
     //void eventReceived(const QString &eventName, const QString &message);
     void eventReceived(const QString &eventName, const QJsonValue &payload);
+    void eventDelivered(const QString &eventName, const QString &idempotencyKey);
 
     // Specific events dari frontend
     void screenBrightnessSet(int level);
@@ -123,17 +164,69 @@ private:
     struct QueuedEvent{
         QString eventName;
         QJsonObject data;
+        qint64 enqueuedNs = 0;
+        quint64 latencyId = 0;
+        quint64 journalSeq = 0;   // 0 = tidak dijournal
+        QString idempotencyKey;   // tidak kosong = reliable (butuh ACK)
+        int attempts = 0;
+        QByteArray attachment;    // bentuk biner (tidak dijournal)
     };
 
-    QQueue<QueuedEvent> m_eventQueue;
+    void enqueue(const QString &eventName, const QJsonObject &data, quint64 latencyId, const QByteArray &attachment);
+    void emitBinaryEvent(const QString &eventName, const QByteArray &attachment);
+    void handleTelemetryFormat(const QJsonValue &payload);
+
+    // Hasil negosiasi per koneksi, reset saat disconnect.
+    bool m_binaryTelemetry = false;
+
+    static constexpr int LANE_COUNT = 3;
+    QQueue<QueuedEvent> m_laneQueue[LANE_COUNT];
+    QHash<QString, EventLane> m_eventLanes;
+    socketio::PacketWriter m_packetWriter;
+    QSet<QString> m_volatileEvents;
     QTimer m_queueTimer;
 
+    EventLane laneForEvent(const QString &eventName) const;
+    bool evictOldestNonCritical();
+    void sendQueuedEvent(const QueuedEvent &event);
+    void flushCriticalLane();
+
+    // Journal persistent: event bertahan saat restart / power loss.
+    EventJournal *m_journal = nullptr;
+    // Event ACK dari server -> event outbound yang dianggap sampai.
+    QHash<QString, QStringList> m_journalAckEvents;
+
+    void replayJournal();
+    void acknowledgeJournal(const QueuedEvent &event);
+    void handleServerAckEvent(const QString &eventName);
+
+    // Event reliable yang sudah dikirim / menunggu retry, per idempotency key.
+    QHash<QString, QueuedEvent> m_inFlight;
+
+    static constexpr int RELIABLE_ACK_TIMEOUT_MS = 3000;
+    static constexpr int RELIABLE_BACKOFF_BASE_MS = 1000;
+    static constexpr int RELIABLE_BACKOFF_MAX_MS = 30000;
+
+    void sendReliable(const QueuedEvent &event);
+    void sendWithAck(const QString &eventName, const QJsonObject &data,
+                     std::function<void(bool, QJsonValue)> callback, int timeoutMs, bool reliable);
+    void evictAckCallbacks();
+    void onReliableAck(const QString &key, int attempt, bool ok);
+    void settleReliable(const QString &key);
+    void requeueInFlight();
+    bool isQueued(EventLane lane, const QString &idempotencyKey) const;
+
     bool m_processingQueue = false;
     bool m_isConnected = false;
 
     static constexpr int QUEUE_PROCESS_INTERVAL_MS = 100;
     static constexpr int MAX_QUEUE_SIZE = 1000;
 
+    qint64 m_drainMaxBufferedBytes = 64 * 1024;
+    int m_drainMaxTickMs = 5;
+
+    void scheduleQueueDrain(bool immediate);
+
     QWebSocket *m_webSocket;
     QTimer *m_pingTimer;
     QTimer *m_reconnectTimer;
@@ -145,13 +238,10 @@ private:
     int m_nextAckId;
     QMutex m_mutex;
 
-   // VolumeMonitor *m_volumeMonitor;
-
-    volume sioVolume;
-    brightness sioBritness;
+    // volume / brightness dari cache VolumeMonitor & brightness (MainWindow)
 
-    int vol;
-    int britnes;
+    int vol = -1;
+    int britnes = -1;
 
     QString m_lastEventName;
     QJsonValue m_lastEventData;
@@ -162,7 +252,15 @@ private:
 
     //std::map<int, std::function<void(const QString&)>> m_ackCallbacksQString;
     //std::map<int, std::function<void(QJsonValue)>> m_ackCallbacks;
-    std::map<quint64, std::function<void(bool, QJsonValue)>> m_ackCallbacks;
+    struct PendingAck {
+        std::function<void(bool, QJsonValue)> callback;
+        bool reliable = false;  // event reliable: tidak pernah di-evict
+    };
+
+    // Batas callback ACK non-reliable yang menunggu; sisanya digagalkan
+    static constexpr std::size_t MAX_PENDING_ACKS = 1000;
+
+    std::map<quint64, PendingAck> m_ackCallbacks;
 
     QProcess *m_cpuSerialProcess = nullptr;
     QString m_cpuSerial;
@@ -170,8 +268,8 @@ private:
 
     void setupWebSocket();
     void constructWebSocketUrl();
-    void parseSocketIOMessage(const QString &message);
-    void handleSocketIOJsonPacket(int type, const QString &data);
+    void parseSocketIOMessage(const QByteArray &message);
+    void handleSocketIOJsonPacket(const socketio::Packet &packet);
     void handleIncomingAck(int ackId, const QJsonValue &data);
 
     void sendSocketIOPacket(int type, const QString &data = QString());
@@ -0,0 +1,313 @@
+#include "socketiopacket.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QLocale>
+#include <QTimeZone>
+
+#include <cmath>
+
+namespace socketio {
+
+namespace {
+
+constexpr char HEX[] = "0123456789abcdef";
+
+void appendEscapedByte(QByteArray &out, uchar c)
+{
+    switch (c) {
+    case '"':  out += "\\\""; return;
+    case '\\': out += "\\\\"; return;
+    case '\b': out += "\\b"; return;
+    case '\f': out += "\\f"; return;
+    case '\n': out += "\\n"; return;
+    case '\r': out += "\\r"; return;
+    case '\t': out += "\\t"; return;
+    default:
+        break;
+    }
+
+    if (c < 0x20) {
+        out += "\\u00";
+        out += HEX[c >> 4];
+        out += HEX[c & 0xF];
+        return;
+    }
+
+    out += char(c);
+}
+
+void appendDouble(QByteArray &out, double d)
+{
+    if (!std::isfinite(d)) {
+        out += "null";
+        return;
+    }
+
+    // Bilangan bulat (mis. timestamp ms) ditulis tanpa eksponen, sama seperti QJsonDocument.
+    if (std::floor(d) == d && std::fabs(d) < 9007199254740992.0) {
+        out += QByteArray::number(qint64(d));
+        return;
+    }
+
+    out += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+}
+
+int digits(const QString &s, int pos, int count, bool *ok)
+{
+    int v = 0;
+
+    for (int i = pos; i < pos + count; ++i) {
+        const ushort c = s.at(i).unicode();
+        if (c < '0' || c > '9') {
+            *ok = false;
+            return 0;
+        }
+        v = v * 10 + int(c - '0');
+    }
+
+    return v;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------------------
+const QByteArray &PacketWriter::prefix(const QString &eventName)
+{
+    auto it = m_prefixes.find(eventName);
+
+    if (it == m_prefixes.end()) {
+        QByteArray p;
+        p += '[';
+        appendString(p, eventName);
+        p += ',';
+        it = m_prefixes.insert(eventName, p);
+    }
+
+    return it.value();
+}
+
+//---------------------------------------------------------------------------------------
+QByteArray PacketWriter::event(const QString &eventName,
+                               const QJsonValue &data,
+                               qint64 ackId,
+                               bool fixTimestamp)
+{
+    const QByteArray &head = prefix(eventName);
+
+    QByteArray out;
+    out.reserve(head.size() + 128);
+
+    out += "42";
+    if (ackId >= 0)
+        out += QByteArray::number(ackId);
+    out += head;
+
+    if (data.isObject())
+        appendObject(out, data.toObject(), fixTimestamp);
+    else
+        appendValue(out, data);
+
+    out += ']';
+    return out;
+}
+
+//---------------------------------------------------------------------------------------
+QByteArray PacketWriter::binaryEvent(const QString &eventName, int attachmentCount)
+{
+    const QByteArray &head = prefix(eventName);
+
+    QByteArray out;
+    out.reserve(head.size() + 40 * attachmentCount + 8);
+
+    out += "45";
+    out += QByteArray::number(attachmentCount);
+    out += '-';
+    out += head;
+
+    for (int i = 0; i < attachmentCount; ++i) {
+        if (i)
+            out += ',';
+        out += "{\"_placeholder\":true,\"num\":";
+        out += QByteArray::number(i);
+        out += '}';
+    }
+
+    out += ']';
+    return out;
+}
+
+//---------------------------------------------------------------------------------------
+void PacketWriter::appendString(QByteArray &out, QStringView str)
+{
+    out += '"';
+
+    // Fast path ASCII; begitu ketemu non-ASCII sisa string di-encode UTF-8.
+    qsizetype i = 0;
+    for (; i < str.size(); ++i) {
+        const ushort c = str.at(i).unicode();
+        if (c >= 0x80)
+            break;
+        appendEscapedByte(out, uchar(c));
+    }
+
+    if (i < str.size()) {
+        const QByteArray rest = str.mid(i).toUtf8();
+        for (char c : rest)
+            appendEscapedByte(out, uchar(c));
+    }
+
+    out += '"';
+}
+
+//---------------------------------------------------------------------------------------
+void PacketWriter::appendObject(QByteArray &out, const QJsonObject &obj, bool fixTimestamp)
+{
+    out += '{';
+
+    bool first = true;
+
+    for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+        if (!first)
+            out += ',';
+        first = false;
+
+        appendString(out, it.key());
+        out += ':';
+
+        const QJsonValue value = it.value();
+
+        if (fixTimestamp && value.isString() && it.key() == QLatin1String("timestamp")) {
+            bool ok = false;
+            const qint64 ms = isoToMSecs(value.toString(), &ok);
+
+            if (ok) {
+                out += QByteArray::number(ms);
+                continue;
+            }
+
+            qWarning() << "Invalid timestamp string format";
+        }
+
+        appendValue(out, value);
+    }
+
+    out += '}';
+}
+
+//---------------------------------------------------------------------------------------
+void PacketWriter::appendValue(QByteArray &out, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        out += "null";
+        break;
+    case QJsonValue::Bool:
+        out += value.toBool() ? "true" : "false";
+        break;
+    case QJsonValue::Double:
+        appendDouble(out, value.toDouble());
+        break;
+    case QJsonValue::String:
+        appendString(out, value.toString());
+        break;
+    case QJsonValue::Array: {
+        const QJsonArray arr = value.toArray();
+        out += '[';
+        for (qsizetype i = 0; i < arr.size(); ++i) {
+            if (i)
+                out += ',';
+            appendValue(out, arr.at(i));
+        }
+        out += ']';
+        break;
+    }
+    case QJsonValue::Object:
+        appendObject(out, value.toObject());
+        break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+qint64 PacketWriter::isoToMSecs(const QString &iso, bool *ok)
+{
+    // yyyy-MM-ddTHH:mm:ss[.zzz][Z]
+    bool valid = iso.size() >= 19
+                 && iso.at(4) == '-' && iso.at(7) == '-'
+                 && (iso.at(10) == 'T' || iso.at(10) == ' ')
+                 && iso.at(13) == ':' && iso.at(16) == ':';
+
+    int pos = 19;
+    int msec = 0;
+    bool utc = false;
+
+    if (valid && pos < iso.size() && iso.at(pos) == '.') {
+        if (iso.size() >= pos + 4) {
+            msec = digits(iso, pos + 1, 3, &valid);
+            pos += 4;
+        } else {
+            valid = false;
+        }
+    }
+
+    if (valid && pos < iso.size()) {
+        if (iso.at(pos) == 'Z' && pos + 1 == iso.size())
+            utc = true;
+        else
+            valid = false; // offset zona waktu: serahkan ke QDateTime
+    }
+
+    if (valid) {
+        const QDate date(digits(iso, 0, 4, &valid), digits(iso, 5, 2, &valid), digits(iso, 8, 2, &valid));
+        const QTime time(digits(iso, 11, 2, &valid), digits(iso, 14, 2, &valid), digits(iso, 17, 2, &valid), msec);
+
+        if (valid && date.isValid() && time.isValid()) {
+            const QDateTime dt = utc ? QDateTime(date, time, QTimeZone::utc())
+                                     : QDateTime(date, time);
+            *ok = true;
+            return dt.toMSecsSinceEpoch();
+        }
+    }
+
+    const QDateTime dt = QDateTime::fromString(iso, Qt::ISODate);
+    *ok = dt.isValid();
+    return *ok ? dt.toMSecsSinceEpoch() : 0;
+}
+
+//---------------------------------------------------------------------------------------
+bool parsePacket(const QByteArray &raw, Packet &packet)
+{
+    packet = Packet();
+
+    if (raw.isEmpty() || raw.at(0) < '0' || raw.at(0) > '9')
+        return false;
+
+    packet.engineType = raw.at(0) - '0';
+    qsizetype pos = 1;
+
+    if (packet.engineType == 4 && pos < raw.size() && raw.at(pos) >= '0' && raw.at(pos) <= '9') {
+        packet.socketType = raw.at(pos) - '0';
+        ++pos;
+
+        // 42<ackId>[...] / 43<ackId>[...]
+        if (packet.socketType == 2 || packet.socketType == 3) {
+            qint64 id = 0;
+            const qsizetype start = pos;
+
+            while (pos < raw.size() && raw.at(pos) >= '0' && raw.at(pos) <= '9') {
+                id = id * 10 + (raw.at(pos) - '0');
+                ++pos;
+            }
+
+            if (pos > start)
+                packet.ackId = id;
+        }
+    }
+
+    packet.payload = QByteArray::fromRawData(raw.constData() + pos, raw.size() - pos);
+    return true;
+}
+
+} // namespace socketio
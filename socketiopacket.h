@@ -0,0 +1,63 @@
+#ifndef SOCKETIOPACKET_H
+#define SOCKETIOPACKET_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <QStringView>
+
+/*
+ * Encoder / decoder paket Socket.IO yang bekerja langsung di QByteArray UTF-8.
+ *
+ * Outbound: JSON ditulis langsung ke satu buffer (tanpa QJsonArray +
+ * QJsonDocument + fromUtf8), prefix `["EVENT",` di-cache per nama event.
+ * Output identik dengan QJsonDocument::Compact (key object tetap urut).
+ *
+ * Inbound: header Engine.IO / Socket.IO (type, subtype, ack id) dibaca
+ * tanpa copy; payload JSON berupa view ke buffer asal.
+ */
+namespace socketio {
+
+class PacketWriter
+{
+public:
+    // 42[<ackId>]["EVENT",<data>]
+    // fixTimestamp: field "timestamp" (string ISO) di object top-level
+    // ditulis sebagai epoch ms.
+    QByteArray event(const QString &eventName,
+                     const QJsonValue &data,
+                     qint64 ackId = -1,
+                     bool fixTimestamp = true);
+
+    // 451-["EVENT",{"_placeholder":true,"num":0},...] ; attachment dikirim
+    // sebagai frame biner setelah paket ini.
+    QByteArray binaryEvent(const QString &eventName, int attachmentCount);
+
+    static void appendValue(QByteArray &out, const QJsonValue &value);
+    static void appendString(QByteArray &out, QStringView str);
+    static void appendObject(QByteArray &out, const QJsonObject &obj, bool fixTimestamp = false);
+
+    // ISO 8601 -> epoch ms. Format umum di-parse manual, sisanya lewat QDateTime.
+    static qint64 isoToMSecs(const QString &iso, bool *ok);
+
+private:
+    const QByteArray &prefix(const QString &eventName);
+
+    QHash<QString, QByteArray> m_prefixes;
+};
+
+struct Packet {
+    int engineType = -1;   // Engine.IO: 0 open, 2 ping, 3 pong, 4 message, ...
+    int socketType = -1;   // Socket.IO (kalau engineType == 4): 0 connect, 2 event, 3 ack, ...
+    qint64 ackId = -1;
+    QByteArray payload;    // view (fromRawData) ke buffer input, jangan disimpan
+};
+
+// raw harus tetap hidup selama Packet dipakai.
+bool parsePacket(const QByteArray &raw, Packet &packet);
+
+} // namespace socketio
+
+#endif // SOCKETIOPACKET_H
@@ -0,0 +1,242 @@
+#include "startupprofiler.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QTimer>
+
+StartupProfiler::StartupProfiler(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+}
+
+//---------------------------------------------------------------------------------------
+void StartupProfiler::addStage(const QString &name,
+                               Phase phase,
+                               const QStringList &dependsOn,
+                               std::function<void()> fn)
+{
+    if (m_running) {
+        qWarning() << "[Startup] addStage after run() ignored:" << name;
+        return;
+    }
+
+    Stage stage;
+    stage.name = name;
+    stage.phase = phase;
+    stage.dependsOn = dependsOn;
+    stage.fn = std::move(fn);
+
+    m_stages.append(stage);
+}
+
+//---------------------------------------------------------------------------------------
+void StartupProfiler::run()
+{
+    if (m_running)
+        return;
+
+    m_running = true;
+
+    // Jalur kritis dijalankan langsung, urut sesuai dependency.
+    int idx;
+    while ((idx = nextReadyStage(Phase::Critical)) >= 0)
+        runStage(m_stages[idx]);
+
+    // Dependency tidak terpenuhi (typo nama / tergantung stage deferred):
+    // tetap dijalankan supaya jalur alarm tidak pernah hilang.
+    for (Stage &stage : m_stages) {
+        if (stage.phase == Phase::Critical && !stage.done) {
+            qWarning() << "[Startup] Critical stage with unresolved dependency:"
+                       << stage.name << stage.dependsOn;
+            runStage(stage);
+        }
+    }
+
+    // Sisanya lewat event loop, satu stage per iterasi.
+    QTimer::singleShot(0, this, &StartupProfiler::runNextDeferred);
+}
+
+//---------------------------------------------------------------------------------------
+void StartupProfiler::runNextDeferred()
+{
+    int idx = nextReadyStage(Phase::Deferred);
+
+    if (idx < 0) {
+        for (int i = 0; i < m_stages.size(); ++i) {
+            if (!m_stages[i].done) {
+                qWarning() << "[Startup] Deferred stage with unresolved dependency:"
+                           << m_stages[i].name << m_stages[i].dependsOn;
+                idx = i;
+                break;
+            }
+        }
+    }
+
+    if (idx < 0) {
+        m_finished = true;
+        markMilestone("startup complete");
+
+        // Milestone dari slot allStagesFinished ikut masuk report
+        emit allStagesFinished();
+        printReport();
+        return;
+    }
+
+    runStage(m_stages[idx]);
+    QTimer::singleShot(0, this, &StartupProfiler::runNextDeferred);
+}
+
+//---------------------------------------------------------------------------------------
+void StartupProfiler::markMilestone(const QString &name)
+{
+    Milestone m;
+    m.name = name;
+    m.sinceStartMs = m_clock.elapsed();
+    m.uptimeMs = systemUptimeMs();
+
+    m_milestones.append(m);
+
+    qDebug().noquote() << QString("[Startup] Milestone '%1' at %2 ms (uptime %3 ms)")
+                              .arg(name)
+                              .arg(m.sinceStartMs)
+                              .arg(m.uptimeMs);
+
+    emit milestoneReached(m.name, m.sinceStartMs, m.uptimeMs);
+}
+
+//---------------------------------------------------------------------------------------
+bool StartupProfiler::isStageDone(const QString &name) const
+{
+    for (const Stage &stage : m_stages) {
+        if (stage.name == name)
+            return stage.done;
+    }
+
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+QJsonObject StartupProfiler::report() const
+{
+    QJsonArray stages;
+
+    for (const StageResult &r : m_results) {
+        QJsonObject o;
+        o["name"] = r.name;
+        o["phase"] = (r.phase == Phase::Critical) ? "critical" : "deferred";
+        o["start_ms"] = r.startMs;
+        o["duration_us"] = r.durationUs;
+        stages.append(o);
+    }
+
+    QJsonArray milestones;
+
+    for (const Milestone &m : m_milestones) {
+        QJsonObject o;
+        o["name"] = m.name;
+        o["since_start_ms"] = m.sinceStartMs;
+        o["uptime_ms"] = m.uptimeMs;
+        milestones.append(o);
+    }
+
+    QJsonObject obj;
+    obj["stages"] = stages;
+    obj["milestones"] = milestones;
+    return obj;
+}
+
+//---------------------------------------------------------------------------------------
+void StartupProfiler::printReport() const
+{
+    qDebug().noquote() << "========== STARTUP PROFILE ==========";
+
+    for (const StageResult &r : m_results) {
+        qDebug().noquote() << QString("%1 %2 start %3 ms | %4 ms")
+                                  .arg(r.phase == Phase::Critical ? "[C]" : "[D]")
+                                  .arg(r.name.leftJustified(16, ' '))
+                                  .arg(r.startMs, 5)
+                                  .arg(double(r.durationUs) / 1000.0, 0, 'f', 2);
+    }
+
+    for (const Milestone &m : m_milestones) {
+        qDebug().noquote() << QString("* %1 : %2 ms (uptime %3 ms)")
+                                  .arg(m.name)
+                                  .arg(m.sinceStartMs)
+                                  .arg(m.uptimeMs);
+    }
+
+    qDebug().noquote() << "=====================================";
+}
+
+//---------------------------------------------------------------------------------------
+qint64 StartupProfiler::systemUptimeMs()
+{
+#ifdef Q_OS_LINUX
+    QFile file(QStringLiteral("/proc/uptime"));
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+
+    // Format: "<uptime detik> <idle detik>"
+    const QByteArray first = file.readLine().split(' ').value(0);
+
+    bool ok = false;
+    const double seconds = first.toDouble(&ok);
+
+    return ok ? qint64(seconds * 1000.0) : -1;
+#else
+    return -1;
+#endif
+}
+
+//---------------------------------------------------------------------------------------
+bool StartupProfiler::dependenciesDone(const Stage &stage) const
+{
+    for (const QString &dep : stage.dependsOn) {
+        if (!isStageDone(dep))
+            return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+int StartupProfiler::nextReadyStage(Phase phase) const
+{
+    for (int i = 0; i < m_stages.size(); ++i) {
+        const Stage &stage = m_stages[i];
+
+        if (stage.phase == phase && !stage.done && dependenciesDone(stage))
+            return i;
+    }
+
+    return -1;
+}
+
+//---------------------------------------------------------------------------------------
+void StartupProfiler::runStage(Stage &stage)
+{
+    StageResult r;
+    r.name = stage.name;
+    r.phase = stage.phase;
+    r.startMs = m_clock.elapsed();
+
+    QElapsedTimer t;
+    t.start();
+
+    if (stage.fn)
+        stage.fn();
+
+    r.durationUs = t.nsecsElapsed() / 1000;
+    stage.done = true;
+
+    m_results.append(r);
+
+    qDebug().noquote() << QString("[Startup] %1 done in %2 ms")
+                              .arg(stage.name)
+                              .arg(double(r.durationUs) / 1000.0, 0, 'f', 2);
+
+    emit stageFinished(stage.name, r.durationUs);
+}
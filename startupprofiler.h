@@ -0,0 +1,97 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+/*
+ * Penjadwal inisialisasi subsystem saat startup.
+ *
+ * - Stage Critical dijalankan langsung (sinkron) di run(), urut sesuai dependency.
+ *   Dipakai untuk jalur radar + alarm (GPIO, suara, Socket.IO, radar).
+ * - Stage Deferred dijalankan satu per satu lewat event loop setelah run()
+ *   selesai, sehingga window tampil dan radar sudah aktif lebih dulu.
+ *
+ * Setiap stage diukur durasinya; milestone (mis. "fall monitoring active")
+ * dicatat relatif ke start profiler dan ke uptime sistem (waktu sejak power-on).
+ */
+class StartupProfiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Phase {
+        Critical,
+        Deferred
+    };
+
+    struct StageResult {
+        QString name;
+        Phase phase = Phase::Critical;
+        qint64 startMs = -1;     // relatif ke start profiler
+        qint64 durationUs = -1;
+    };
+
+    struct Milestone {
+        QString name;
+        qint64 sinceStartMs = -1;
+        qint64 uptimeMs = -1;    // -1 kalau /proc/uptime tidak tersedia
+    };
+
+    explicit StartupProfiler(QObject *parent = nullptr);
+
+    void addStage(const QString &name,
+                  Phase phase,
+                  const QStringList &dependsOn,
+                  std::function<void()> fn);
+
+    void run();
+    void markMilestone(const QString &name);
+
+    bool isStageDone(const QString &name) const;
+    bool isFinished() const { return m_finished; }
+    qint64 elapsedMs() const { return m_clock.elapsed(); }
+
+    QVector<StageResult> results() const { return m_results; }
+    QVector<Milestone> milestones() const { return m_milestones; }
+    QJsonObject report() const;
+    void printReport() const;
+
+    static qint64 systemUptimeMs();
+
+signals:
+    void stageFinished(const QString &name, qint64 durationUs);
+    void milestoneReached(const QString &name, qint64 sinceStartMs, qint64 uptimeMs);
+    void allStagesFinished();
+
+private slots:
+    void runNextDeferred();
+
+private:
+    struct Stage {
+        QString name;
+        Phase phase = Phase::Critical;
+        QStringList dependsOn;
+        std::function<void()> fn;
+        bool done = false;
+    };
+
+    QVector<Stage> m_stages;
+    QVector<StageResult> m_results;
+    QVector<Milestone> m_milestones;
+    QElapsedTimer m_clock;
+    bool m_running = false;
+    bool m_finished = false;
+
+    bool dependenciesDone(const Stage &stage) const;
+    int nextReadyStage(Phase phase) const;
+    void runStage(Stage &stage);
+};
+
+#endif // STARTUPPROFILER_H
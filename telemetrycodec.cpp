@@ -0,0 +1,127 @@
+#include "telemetrycodec.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace telemetry {
+
+namespace {
+
+constexpr int HEADER_SIZE = 4;
+
+void putHeader(uchar *p, RecordType type)
+{
+    p[0] = 'R';
+    p[1] = 'T';
+    p[2] = FORMAT_VERSION;
+    p[3] = quint8(type);
+}
+
+void putFloat(uchar *p, float v)
+{
+    quint32 bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    qToLittleEndian<quint32>(bits, p);
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------------------
+QByteArray encodePower(const PowerSample &sample)
+{
+    constexpr int FLOAT_COUNT = 10;
+    constexpr int SIZE = HEADER_SIZE + 8 + 4 + FLOAT_COUNT * 4;
+
+    QByteArray out(SIZE, '\0');
+    uchar *p = reinterpret_cast<uchar *>(out.data());
+
+    putHeader(p, RecordType::Power);
+    qToLittleEndian<quint64>(quint64(sample.timestampMs), p + 4);
+    p[12] = sample.alarm ? 0x01 : 0x00;
+
+    const float values[FLOAT_COUNT] = {
+        sample.temperatureC,
+        sample.pressureHpa,
+        sample.humidityPercent,
+        sample.cpuTemperatureC,
+        sample.voltage,
+        sample.current,
+        sample.power,
+        sample.frequency,
+        sample.powerFactor,
+        sample.energy
+    };
+
+    uchar *f = p + 16;
+    for (float v : values) {
+        putFloat(f, v);
+        f += 4;
+    }
+
+    return out;
+}
+
+//---------------------------------------------------------------------------------------
+QByteArray encodeRadarTargets(qint64 timestampMs, const QVector<RadarFrame> &frames)
+{
+    constexpr int TARGET_SIZE = 10;
+
+    int size = HEADER_SIZE + 8 + 1;
+    for (const RadarFrame &f : frames)
+        size += 2 + int(qMin<qsizetype>(f.targets.size(), 255)) * TARGET_SIZE;
+
+    QByteArray out(size, '\0');
+    uchar *p = reinterpret_cast<uchar *>(out.data());
+
+    putHeader(p, RecordType::RadarTargets);
+    qToLittleEndian<quint64>(quint64(timestampMs), p + 4);
+    p[12] = quint8(qMin<qsizetype>(frames.size(), 255));
+
+    uchar *w = p + 13;
+
+    for (const RadarFrame &f : frames) {
+        const int count = int(qMin<qsizetype>(f.targets.size(), 255));
+
+        *w++ = f.radarIndex;
+        *w++ = quint8(count);
+
+        for (int i = 0; i < count; ++i) {
+            const RadarTarget &t = f.targets.at(i);
+
+            w[0] = t.trackId;
+            qToLittleEndian<qint16>(t.x, w + 1);
+            qToLittleEndian<qint16>(t.y, w + 3);
+            qToLittleEndian<qint16>(t.height, w + 5);
+            qToLittleEndian<qint16>(t.velocity, w + 7);
+            w[9] = t.state;
+            w += TARGET_SIZE;
+        }
+    }
+
+    return out;
+}
+
+//---------------------------------------------------------------------------------------
+QByteArray encodeVoiceChunk(const VoiceChunk &chunk)
+{
+    constexpr int BODY_OFFSET = HEADER_SIZE + 4 + 4 + 4 + 2 + 2 + 1 + 1;
+
+    QByteArray out(BODY_OFFSET + chunk.adpcm.size(), '\0');
+    uchar *p = reinterpret_cast<uchar *>(out.data());
+
+    putHeader(p, RecordType::VoiceChunk);
+    qToLittleEndian<quint32>(chunk.session, p + 4);
+    qToLittleEndian<quint32>(chunk.seq, p + 8);
+    qToLittleEndian<quint32>(chunk.sampleIndex, p + 12);
+    qToLittleEndian<quint16>(chunk.samples, p + 16);
+    qToLittleEndian<qint16>(chunk.predictor, p + 18);
+    p[20] = chunk.stepIndex;
+    p[21] = chunk.last ? 0x01 : 0x00;
+
+    std::memcpy(p + BODY_OFFSET, chunk.adpcm.constData(), size_t(chunk.adpcm.size()));
+
+    return out;
+}
+
+} // namespace telemetry
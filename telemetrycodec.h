@@ -0,0 +1,89 @@
+#ifndef TELEMETRYCODEC_H
+#define TELEMETRYCODEC_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+
+#include "payloadprocessor.h"
+
+/*
+ * Encoding biner telemetry untuk attachment Socket.IO (paket 45 / binary event).
+ *
+ * Setiap frame diawali header 4 byte:
+ *   'R' 'T' <versi> <RecordType>
+ * diikuti body fixed-layout little-endian sesuai RecordType.
+ *
+ * Dipakai hanya kalau server sudah setuju lewat event TELEMETRY_FORMAT
+ * (client mengirim CAPABILITY di auth CONNECT). Tanpa negosiasi, event
+ * yang sama tetap dikirim sebagai JSON.
+ */
+namespace telemetry {
+
+constexpr quint8 FORMAT_VERSION = 1;
+constexpr char CAPABILITY[] = "telemetry-bin-v1";
+
+enum class RecordType : quint8 {
+    Power = 1,          // DEVICE_POWER_INFO
+    RadarTargets = 2,   // RADAR_TARGETS
+    VoiceChunk = 3      // VOICE_RECORD_CHUNK
+};
+
+/*
+ * Power: 56 byte (JSON setara ~260 byte)
+ *   header(4) | timestamp ms u64 | flags u8 (bit0 alarm) | pad(3)
+ *   | 10 x float32: temperature, pressure, humidity, cpu_temperature,
+ *     voltage, current, power_cons, frequency, pf, energy
+ */
+struct PowerSample {
+    qint64 timestampMs = 0;
+    float temperatureC = 0;
+    float pressureHpa = 0;
+    float humidityPercent = 0;
+    float cpuTemperatureC = 0;
+    float voltage = 0;
+    float current = 0;
+    float power = 0;
+    float frequency = 0;
+    float powerFactor = 0;
+    float energy = 0;
+    bool alarm = false;
+};
+
+QByteArray encodePower(const PowerSample &sample);
+
+/*
+ * RadarTargets: header(4) | timestamp ms u64 | jumlah radar u8
+ *   per radar: index radar u8 | jumlah target u8
+ *     per target (10 byte): trackId u8 | x i16 | y i16 | height i16 | velocity i16 | state u8
+ */
+struct RadarFrame {
+    quint8 radarIndex = 0;
+    QVector<RadarTarget> targets;
+};
+
+QByteArray encodeRadarTargets(qint64 timestampMs, const QVector<RadarFrame> &frames);
+
+/*
+ * VoiceChunk: header(4) | session u32 | seq u32 | sample index u32
+ *   | jumlah sampel u16 | predictor i16 | step index u8 | flags u8 (bit0 last)
+ *   | data IMA ADPCM (lihat imaadpcm.h)
+ * Predictor / step index = state encoder di awal chunk: tiap chunk bisa
+ * di-decode sendiri walaupun chunk sebelumnya hilang.
+ */
+struct VoiceChunk {
+    quint32 session = 0;
+    quint32 seq = 0;
+    quint32 sampleIndex = 0;
+    quint16 samples = 0;
+    qint16 predictor = 0;
+    quint8 stepIndex = 0;
+    bool last = false;
+    QByteArray adpcm;
+};
+
+QByteArray encodeVoiceChunk(const VoiceChunk &chunk);
+
+} // namespace telemetry
+
+#endif // TELEMETRYCODEC_H
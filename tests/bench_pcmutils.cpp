@@ -0,0 +1,107 @@
+/*
+ * bench_pcmutils: ns/sample kernel pcmutils yang ada di hot path audio.
+ *
+ *   bench_pcmutils [samples] [rounds]
+ *
+ * Default 480 sampel (10 ms @ 48 kHz, ukuran period engine) supaya data di
+ * L1 seperti saat jalan; hasil terbaik dari beberapa putaran dilaporkan.
+ * Bukan bagian ctest: jalankan manual di device (NEON) dan di host.
+ */
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QStringList>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "pcmutils.h"
+
+namespace {
+
+constexpr int DEFAULT_SAMPLES = 480;
+constexpr int DEFAULT_ROUNDS = 20;
+
+// Target waktu per putaran: cukup panjang untuk resolusi QElapsedTimer
+constexpr qint64 ROUND_NS = 20 * 1000 * 1000;
+
+// Mencegah compiler membuang hasil kernel
+volatile float g_sink = 0.0f;
+
+double bestNsPerSample(int samples, int rounds, const std::function<void()> &run)
+{
+    // Kalibrasi jumlah iterasi per putaran
+    int iterations = 1;
+    for (;;) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i)
+            run();
+        if (timer.nsecsElapsed() >= ROUND_NS / 10 || iterations >= (1 << 24))
+            break;
+        iterations *= 2;
+    }
+    iterations *= 10;
+
+    double best = std::numeric_limits<double>::max();
+    for (int r = 0; r < rounds; ++r) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i)
+            run();
+        best = std::min(best, double(timer.nsecsElapsed()) / (double(iterations) * samples));
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const QStringList args = app.arguments();
+    const int samples = args.size() > 1 ? qMax(1, args.at(1).toInt()) : DEFAULT_SAMPLES;
+    const int rounds = args.size() > 2 ? qMax(1, args.at(2).toInt()) : DEFAULT_ROUNDS;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1.1f, 1.1f);
+    std::uniform_int_distribution<qint32> mix(-60000, 60000);
+
+    std::vector<float> f(samples);
+    std::vector<qint16> s(samples);
+    std::vector<qint32> acc(samples);
+    for (int i = 0; i < samples; ++i) {
+        f[i] = dist(rng);
+        acc[i] = mix(rng);
+    }
+    pcm::floatToS16(f.data(), s.data(), samples);
+
+    std::vector<float> fOut(samples);
+    std::vector<qint16> sOut(samples);
+
+    qInfo().noquote() << "pcm kernel:" << pcm::kernelName() << "|" << samples << "sampel," << rounds << "putaran";
+
+    const struct {
+        const char *name;
+        std::function<void()> run;
+    } cases[] = {
+        {"levels(float)", [&]() { g_sink = g_sink + pcm::levels(f.data(), samples, 0.99f).peak; }},
+        {"levels(s16)", [&]() { g_sink = g_sink + pcm::levels(s.data(), samples, 0.99f).peak; }},
+        {"s16ToFloat", [&]() { pcm::s16ToFloat(s.data(), fOut.data(), samples); g_sink = g_sink + fOut[0]; }},
+        {"floatToS16", [&]() { pcm::floatToS16(f.data(), sOut.data(), samples); g_sink = g_sink + sOut[0]; }},
+        {"saturateS32ToS16",
+         [&]() { g_sink = g_sink + float(pcm::saturateS32ToS16(acc.data(), sOut.data(), samples)); }},
+    };
+
+    for (const auto &c : cases) {
+        const double ns = bestNsPerSample(samples, rounds, c.run);
+        qInfo().noquote() << QStringLiteral("%1 %2 ns/sample").arg(QLatin1String(c.name), -18).arg(ns, 0, 'f', 3);
+    }
+
+    return 0;
+}
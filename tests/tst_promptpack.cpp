@@ -0,0 +1,220 @@
+/*
+ * PromptPack: write -> open -> pcm harus kembali byte per byte sama, PCM
+ * rata ALIGN di mapping, dan file terpotong / rusak ditolak saat open.
+ */
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QtEndian>
+
+#include "promptpack.h"
+
+namespace {
+
+constexpr int SAMPLE_RATE = 48000;
+constexpr int CHANNELS = 1;
+
+QByteArray makePcm(int samples, int seed)
+{
+    QByteArray pcm(samples * 2, Qt::Uninitialized);
+    qint16 *s = reinterpret_cast<qint16 *>(pcm.data());
+    for (int i = 0; i < samples; ++i)
+        s[i] = qint16((i * 7919 + seed * 104729) % 65536 - 32768);
+
+    // Nilai ekstrem supaya byte order ikut teruji
+    if (samples > 1) {
+        s[0] = -32768;
+        s[samples - 1] = 32767;
+    }
+    return pcm;
+}
+
+PromptPack::Entry entry(const QString &lang, int index, int samples)
+{
+    PromptPack::Entry e;
+    e.lang = lang;
+    e.sentenceIndex = index;
+    e.pcm = makePcm(samples, index + lang.size());
+    return e;
+}
+
+// Panjang ganjil (bukan kelipatan ALIGN) supaya padding antar entry teruji
+QVector<PromptPack::Entry> sampleEntries()
+{
+    return {
+        entry(QStringLiteral("sv"), 1, 1000),
+        entry(QStringLiteral("sv"), 7, 33),
+        entry(QStringLiteral("id"), 1, 4801),
+        entry(QStringLiteral("id"), 255, 1),
+        entry(QStringLiteral("en"), 3, 64),
+    };
+}
+
+} // namespace
+
+class TestPromptPack : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTripIsByteEqualAndAligned();
+    void truncatedFileIsRejected();
+    void corruptHeaderIsRejected();
+    void wrappingEntryOffsetIsRejected();
+    void invalidEntryIsNotWritten();
+};
+
+void TestPromptPack::roundTripIsByteEqualAndAligned()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QLatin1String(PromptPack::FILE_NAME));
+
+    const QVector<PromptPack::Entry> entries = sampleEntries();
+
+    QString error;
+    QVERIFY2(PromptPack::write(path, entries, SAMPLE_RATE, CHANNELS, &error), qPrintable(error));
+
+    PromptPack pack;
+    QVERIFY2(pack.open(path, &error), qPrintable(error));
+    QVERIFY(pack.isOpen());
+    QCOMPARE(pack.sampleRate(), SAMPLE_RATE);
+    QCOMPARE(pack.channels(), CHANNELS);
+    QCOMPARE(pack.count(), int(entries.size()));
+    QCOMPARE(pack.mappedBytes(), QFile(path).size());
+
+    QStringList languages = pack.languages();
+    languages.sort();
+    QCOMPARE(languages, (QStringList{QStringLiteral("en"), QStringLiteral("id"), QStringLiteral("sv")}));
+
+    for (const PromptPack::Entry &e : entries) {
+        const QByteArray pcm = pack.pcm(e.sentenceIndex, e.lang);
+        const QString at = e.lang + QLatin1Char('/') + QString::number(e.sentenceIndex);
+
+        QVERIFY2(pcm == e.pcm, qPrintable(at));
+
+        // Mapping mulai di batas halaman, jadi offset rata ALIGN = alamat rata ALIGN
+        QVERIFY2(quintptr(pcm.constData()) % PromptPack::ALIGN == 0, qPrintable(at));
+
+        // Zero-copy: dua lookup menunjuk ke halaman mapping yang sama
+        QVERIFY2(pack.pcm(e.sentenceIndex, e.lang).constData() == pcm.constData(), qPrintable(at));
+    }
+
+    // Slot tanpa prompt dan bahasa yang tidak ada
+    QVERIFY(pack.pcm(2, QStringLiteral("sv")).isEmpty());
+    QVERIFY(pack.pcm(1, QStringLiteral("en")).isEmpty());
+    QVERIFY(pack.pcm(1, QStringLiteral("de")).isEmpty());
+    QVERIFY(pack.pcm(-1, QStringLiteral("sv")).isEmpty());
+
+    pack.close();
+    QVERIFY(!pack.isOpen());
+    QVERIFY(pack.pcm(1, QStringLiteral("sv")).isEmpty());
+}
+
+void TestPromptPack::truncatedFileIsRejected()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QLatin1String(PromptPack::FILE_NAME));
+
+    QString error;
+    QVERIFY2(PromptPack::write(path, sampleEntries(), SAMPLE_RATE, CHANNELS, &error), qPrintable(error));
+
+    const qint64 fullSize = QFile(path).size();
+    const qint64 cuts[] = {fullSize - 1, fullSize - PromptPack::ALIGN, PromptPack::HEADER_SIZE + 1,
+                           PromptPack::HEADER_SIZE, PromptPack::HEADER_SIZE - 1, 4, 0};
+
+    for (qint64 size : cuts) {
+        QVERIFY(QFile::resize(path, size));
+
+        PromptPack pack;
+        error.clear();
+        QVERIFY2(!pack.open(path, &error), qPrintable(QStringLiteral("size %1 diterima").arg(size)));
+        QVERIFY(!pack.isOpen());
+        QVERIFY(!error.isEmpty());
+        QCOMPARE(pack.count(), 0);
+    }
+}
+
+void TestPromptPack::corruptHeaderIsRejected()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QLatin1String(PromptPack::FILE_NAME));
+
+    QString error;
+    QVERIFY2(PromptPack::write(path, sampleEntries(), SAMPLE_RATE, CHANNELS, &error), qPrintable(error));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray good = file.readAll();
+    file.close();
+
+    // magic, versi, bits per sample, offset PCM entry pertama tidak rata ALIGN
+    const struct {
+        int offset;
+        char value;
+    } patches[] = {{0, 'X'}, {4, 2}, {14, 8}, {PromptPack::HEADER_SIZE + 16, 1}};
+
+    for (const auto &patch : patches) {
+        QByteArray bad = good;
+        bad[patch.offset] = patch.value;
+
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QCOMPARE(file.write(bad), qint64(bad.size()));
+        file.close();
+
+        PromptPack pack;
+        QVERIFY2(!pack.open(path, &error), qPrintable(QStringLiteral("patch @%1 diterima").arg(patch.offset)));
+        QVERIFY(!pack.isOpen());
+    }
+}
+
+void TestPromptPack::wrappingEntryOffsetIsRejected()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QLatin1String(PromptPack::FILE_NAME));
+
+    QString error;
+    QVERIFY2(PromptPack::write(path, sampleEntries(), SAMPLE_RATE, CHANNELS, &error), qPrintable(error));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const QByteArray header = file.read(PromptPack::HEADER_SIZE);
+    const quint32 tableOffset = qFromLittleEndian<quint32>(header.constData() + 20);
+
+    // Offset rata ALIGN dekat 2^64: offset + bytes wrap ke nilai kecil < ukuran file
+    uchar field[8];
+    qToLittleEndian<quint32>(quint32(2 * PromptPack::ALIGN), field);
+    QVERIFY(file.seek(tableOffset + 12));
+    QCOMPARE(file.write(reinterpret_cast<const char *>(field), 4), qint64(4));
+    qToLittleEndian<quint64>(~quint64(PromptPack::ALIGN - 1), field);
+    QVERIFY(file.seek(tableOffset + 16));
+    QCOMPARE(file.write(reinterpret_cast<const char *>(field), 8), qint64(8));
+    file.close();
+
+    PromptPack pack;
+    QVERIFY(!pack.open(path, &error));
+    QVERIFY(!pack.isOpen());
+    QVERIFY(!error.isEmpty());
+}
+
+void TestPromptPack::invalidEntryIsNotWritten()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QLatin1String(PromptPack::FILE_NAME));
+
+    QString error;
+    QVERIFY(!PromptPack::write(path, {entry(QStringLiteral("toolonglang"), 1, 8)}, SAMPLE_RATE, CHANNELS, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!PromptPack::write(path, {entry(QStringLiteral("sv"), 256, 8)}, SAMPLE_RATE, CHANNELS, &error));
+
+    // QSaveFile: tidak ada file setengah jadi
+    QVERIFY(!QFile::exists(path));
+}
+
+QTEST_GUILESS_MAIN(TestPromptPack)
+#include "tst_promptpack.moc"
@@ -0,0 +1,226 @@
+/*
+ * Event reliable (enqueueReliableEvent) lewat jalur live: tanpa ACK event
+ * dikirim ulang dengan backoff dan tetap di journal, setelah ACK dihapus.
+ *
+ * Server Socket.IO palsu (QWebSocketServer lokal) hanya menjawab handshake
+ * EIO=4 dan meng-ACK event yang dipilih.
+ */
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QWebSocket>
+#include <QWebSocketServer>
+
+#include "eventjournal.h"
+#include "socketioclient.h"
+#include "socketiopacket.h"
+
+namespace {
+
+// Sama dengan SocketIOClient::RELIABLE_ACK_TIMEOUT_MS / RELIABLE_BACKOFF_BASE_MS
+constexpr int ACK_TIMEOUT_MS = 3000;
+constexpr int BACKOFF_BASE_MS = 1000;
+
+// Toleransi timer event loop
+constexpr int SLACK_MS = 200;
+
+const QString FALL_EVENT = QStringLiteral("INCIDENT_FALL_EVENT_DETECTED");
+
+struct ReceivedEvent {
+    QString name;
+    QJsonObject data;
+    qint64 ackId = -1;
+    qint64 atMs = 0;
+};
+
+class FakeSocketIOServer : public QObject
+{
+public:
+    FakeSocketIOServer()
+        : m_server(QStringLiteral("fake"), QWebSocketServer::NonSecureMode)
+    {
+        m_clock.start();
+        connect(&m_server, &QWebSocketServer::newConnection, this, [this]() {
+            m_socket = m_server.nextPendingConnection();
+            m_socket->setParent(this);
+            connect(m_socket, &QWebSocket::textMessageReceived, this, [this](const QString &m) { onMessage(m); });
+            m_socket->sendTextMessage(
+                QStringLiteral("0{\"sid\":\"e1\",\"upgrades\":[],\"pingInterval\":25000,\"pingTimeout\":20000}"));
+        });
+    }
+
+    bool listen() { return m_server.listen(QHostAddress::LocalHost, 0); }
+    quint16 port() const { return m_server.serverPort(); }
+
+    // Event `name` di-ACK mulai kiriman ke-`attempt` (1 = langsung)
+    void ackFromAttempt(const QString &name, int attempt) { m_ackFrom.insert(name, attempt); }
+
+    QVector<ReceivedEvent> events(const QString &name) const
+    {
+        QVector<ReceivedEvent> out;
+        for (const ReceivedEvent &e : m_events) {
+            if (e.name == name)
+                out.append(e);
+        }
+        return out;
+    }
+
+private:
+    void onMessage(const QString &message)
+    {
+        const QByteArray raw = message.toUtf8();
+        socketio::Packet packet;
+        if (!socketio::parsePacket(raw, packet) || packet.engineType != 4)
+            return;
+
+        if (packet.socketType == 0) {
+            m_socket->sendTextMessage(QStringLiteral("40{\"sid\":\"s1\"}"));
+            return;
+        }
+
+        if (packet.socketType != 2)
+            return;
+
+        const QJsonArray arr = QJsonDocument::fromJson(packet.payload).array();
+
+        ReceivedEvent e;
+        e.name = arr.at(0).toString();
+        e.data = arr.at(1).toObject();
+        e.ackId = packet.ackId;
+        e.atMs = m_clock.elapsed();
+        m_events.append(e);
+
+        const int attempt = events(e.name).size();
+        if (e.ackId >= 0 && m_ackFrom.contains(e.name) && attempt >= m_ackFrom.value(e.name))
+            m_socket->sendTextMessage(QStringLiteral("43%1[{\"ok\":true}]").arg(e.ackId));
+    }
+
+    QWebSocketServer m_server;
+    QWebSocket *m_socket = nullptr;
+    QElapsedTimer m_clock;
+    QHash<QString, int> m_ackFrom;
+    QVector<ReceivedEvent> m_events;
+};
+
+// Isi journal di disk (mapping MAP_SHARED: tulisan client langsung terlihat)
+QStringList journalKeys(const QString &path)
+{
+    EventJournal journal(path);
+    if (!journal.open())
+        return {};
+
+    QStringList keys;
+    for (const EventJournal::Entry &entry : journal.pendingEntries())
+        keys.append(entry.data.value("idempotency_key").toString());
+    return keys;
+}
+
+} // namespace
+
+class TestReliableEvent : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void missingAckRetriesWithBackoffUntilAcked();
+    void ackMapCapKeepsReliableCallbacks();
+};
+
+void TestReliableEvent::missingAckRetriesWithBackoffUntilAcked()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString journalPath = dir.filePath(QStringLiteral("outbox.journal"));
+
+    FakeSocketIOServer server;
+    QVERIFY(server.listen());
+    server.ackFromAttempt(FALL_EVENT, 2);
+
+    SocketIOClient client(journalPath);
+    QSignalSpy connected(&client, &SocketIOClient::connected);
+    QSignalSpy delivered(&client, &SocketIOClient::eventDelivered);
+
+    client.connectToServer(QStringLiteral("127.0.0.1"), server.port());
+    QVERIFY(connected.wait(5000));
+
+    const QString key = client.enqueueReliableEvent(FALL_EVENT, QJsonObject{{"room", "bedroom"}});
+    QVERIFY(!key.isEmpty());
+
+    // Kiriman pertama tanpa ACK: event tetap di journal
+    QTRY_COMPARE_WITH_TIMEOUT(server.events(FALL_EVENT).size(), 1, 2000);
+    QVERIFY(server.events(FALL_EVENT).first().ackId >= 0);
+    QVERIFY(journalKeys(journalPath).contains(key));
+
+    // Kiriman ulang setelah ACK timeout + backoff, key sama
+    QTRY_COMPARE_WITH_TIMEOUT(server.events(FALL_EVENT).size(), 2, ACK_TIMEOUT_MS + 2 * BACKOFF_BASE_MS + 2000);
+
+    const QVector<ReceivedEvent> sent = server.events(FALL_EVENT);
+    QCOMPARE(sent.at(0).data.value("idempotency_key").toString(), key);
+    QCOMPARE(sent.at(1).data.value("idempotency_key").toString(), key);
+    QVERIFY(sent.at(1).ackId != sent.at(0).ackId);
+    QVERIFY2(sent.at(1).atMs - sent.at(0).atMs >= ACK_TIMEOUT_MS + BACKOFF_BASE_MS - SLACK_MS,
+             qPrintable(QStringLiteral("retry after %1 ms").arg(sent.at(1).atMs - sent.at(0).atMs)));
+
+    // Kiriman kedua di-ACK: delivered, hilang dari journal, tidak ada retry lagi
+    QTRY_COMPARE_WITH_TIMEOUT(delivered.size(), 1, 2000);
+    QCOMPARE(delivered.first().at(0).toString(), FALL_EVENT);
+    QCOMPARE(delivered.first().at(1).toString(), key);
+    QVERIFY(!journalKeys(journalPath).contains(key));
+
+    QTest::qWait(ACK_TIMEOUT_MS + BACKOFF_BASE_MS);
+    QCOMPARE(server.events(FALL_EVENT).size(), 2);
+}
+
+void TestReliableEvent::ackMapCapKeepsReliableCallbacks()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString journalPath = dir.filePath(QStringLiteral("outbox.journal"));
+
+    FakeSocketIOServer server;
+    QVERIFY(server.listen());
+    server.ackFromAttempt(FALL_EVENT, 2);
+
+    SocketIOClient client(journalPath);
+    QSignalSpy connected(&client, &SocketIOClient::connected);
+    QSignalSpy delivered(&client, &SocketIOClient::eventDelivered);
+
+    client.connectToServer(QStringLiteral("127.0.0.1"), server.port());
+    QVERIFY(connected.wait(5000));
+
+    const QString key = client.enqueueReliableEvent(FALL_EVENT, QJsonObject{{"room", "bedroom"}});
+    QTRY_COMPARE_WITH_TIMEOUT(server.events(FALL_EVENT).size(), 1, 2000);
+
+    // Banjir ACK non-reliable yang tidak pernah dijawab server: lewat batas
+    // map, callback tertua digagalkan eksplisit, callback reliable tidak.
+    constexpr int NOISE = 1100;
+    constexpr int NOISE_TIMEOUT_MS = 60000;
+    int failed = 0;
+    QStringList reasons;
+
+    for (int i = 0; i < NOISE; ++i) {
+        client.emitEventWithAck(QStringLiteral("NOISE"), QJsonObject{{"i", i}},
+                                [&failed, &reasons](bool ok, QJsonValue value) {
+                                    if (!ok) {
+                                        failed++;
+                                        reasons.append(value.toString());
+                                    }
+                                },
+                                NOISE_TIMEOUT_MS);
+    }
+
+    // 1 callback reliable + NOISE callback, sisa maksimal 1000
+    QCOMPARE(failed, NOISE + 1 - 1000);
+    QVERIFY(!reasons.contains(QStringLiteral("ack timeout")));
+
+    // Timeout reliable tetap jalan: retry, di-ACK, keluar dari journal
+    QTRY_COMPARE_WITH_TIMEOUT(delivered.size(), 1, ACK_TIMEOUT_MS + 2 * BACKOFF_BASE_MS + 2000);
+    QCOMPARE(delivered.first().at(1).toString(), key);
+    QCOMPARE(server.events(FALL_EVENT).size(), 2);
+    QVERIFY(!journalKeys(journalPath).contains(key));
+}
+
+QTEST_GUILESS_MAIN(TestReliableEvent)
+#include "tst_reliableevent.moc"
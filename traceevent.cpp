@@ -0,0 +1,184 @@
+#include "traceevent.h"
+
+#include <QCoreApplication>
+#include <QSaveFile>
+
+#include <atomic>
+#include <chrono>
+
+namespace trace {
+
+namespace {
+
+constexpr quint64 RING_SIZE = 8192; // harus pangkat dua
+constexpr quint64 RING_MASK = RING_SIZE - 1;
+
+/*
+ * Seqlock per slot: seq ganjil selama writer menulis, genap (2 * (index+1))
+ * setelah selesai. Reader menyalin slot lalu membaca seq lagi; record dibuang
+ * kalau seq berubah / ganjil (ditimpa writer di tengah salinan). Field data
+ * atomic relaxed supaya salinan yang bersaing dengan writer bukan data race.
+ */
+struct Slot {
+    std::atomic<quint64> seq{0};
+    std::atomic<qint64> tsNs{0};
+    std::atomic<qint64> durNs{0};
+    std::atomic<qint64> value{0};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<quint32> tid{0};
+    std::atomic<char> phase{0};
+};
+
+// Salinan slot yang konsisten untuk dump()
+struct Record {
+    qint64 tsNs;
+    qint64 durNs;
+    qint64 value;
+    const char *name;
+    quint32 tid;
+    char phase;
+};
+
+constexpr quint64 doneSeq(quint64 idx)
+{
+    return (idx + 1) * 2;
+}
+
+bool readSlot(const Slot &slot, quint64 idx, Record &out)
+{
+    const quint64 before = slot.seq.load(std::memory_order_acquire);
+
+    // Sedang ditulis (ganjil), kosong, atau milik putaran lain
+    if (before != doneSeq(idx))
+        return false;
+
+    out.tsNs = slot.tsNs.load(std::memory_order_relaxed);
+    out.durNs = slot.durNs.load(std::memory_order_relaxed);
+    out.value = slot.value.load(std::memory_order_relaxed);
+    out.name = slot.name.load(std::memory_order_relaxed);
+    out.tid = slot.tid.load(std::memory_order_relaxed);
+    out.phase = slot.phase.load(std::memory_order_relaxed);
+
+    // Salinan di atas tidak boleh di-reorder setelah pembacaan seq kedua
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return slot.seq.load(std::memory_order_relaxed) == before && out.name;
+}
+
+Slot s_ring[RING_SIZE];
+std::atomic<quint64> s_head{0};
+std::atomic<quint32> s_nextTid{1};
+
+quint32 currentTid()
+{
+    static thread_local const quint32 tid = s_nextTid.fetch_add(1, std::memory_order_relaxed);
+    return tid;
+}
+
+} // namespace
+
+//---------------------------------------------------------------------------------------
+qint64 nowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+//---------------------------------------------------------------------------------------
+void record(Phase phase, const char *name, qint64 tsNs, qint64 durNs, qint64 value)
+{
+    const quint64 idx = s_head.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = s_ring[idx & RING_MASK];
+
+    // Ganjil dulu; fence release menahan tulisan data di belakangnya
+    slot.seq.store(doneSeq(idx) - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.tsNs.store(tsNs, std::memory_order_relaxed);
+    slot.durNs.store(durNs, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.tid.store(currentTid(), std::memory_order_relaxed);
+    slot.phase.store(char(phase), std::memory_order_relaxed);
+
+    slot.seq.store(doneSeq(idx), std::memory_order_release);
+}
+
+//---------------------------------------------------------------------------------------
+void clear()
+{
+    for (Slot &slot : s_ring)
+        slot.seq.store(0, std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------------------
+bool dump(const QString &path, QString *error)
+{
+    const quint64 head = s_head.load(std::memory_order_acquire);
+    const quint64 first = head > RING_SIZE ? head - RING_SIZE : 0;
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QByteArray out;
+    out.reserve(int(RING_SIZE) * 96);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool firstEvent = true;
+
+    for (quint64 i = first; i < head; ++i) {
+        Record slot;
+
+        // Slot sedang ditulis atau sudah ditimpa putaran berikutnya.
+        if (!readSlot(s_ring[i & RING_MASK], i, slot))
+            continue;
+
+        if (!firstEvent)
+            out += ',';
+        firstEvent = false;
+
+        out += "{\"name\":\"";
+        out += slot.name;
+        out += "\",\"ph\":\"";
+        out += slot.phase;
+        out += "\",\"pid\":";
+        out += QByteArray::number(pid);
+        out += ",\"tid\":";
+        out += QByteArray::number(slot.tid);
+        out += ",\"ts\":";
+        out += QByteArray::number(double(slot.tsNs) / 1000.0, 'f', 3);
+
+        if (slot.phase == char(Phase::Complete)) {
+            out += ",\"dur\":";
+            out += QByteArray::number(double(slot.durNs) / 1000.0, 'f', 3);
+        } else if (slot.phase == char(Phase::Instant)) {
+            out += ",\"s\":\"t\",\"args\":{\"value\":";
+            out += QByteArray::number(slot.value);
+            out += '}';
+        } else if (slot.phase == char(Phase::Counter)) {
+            out += ",\"args\":{\"value\":";
+            out += QByteArray::number(slot.value);
+            out += '}';
+        }
+
+        out += '}';
+    }
+
+    out += "]}";
+
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = "Failed to open trace file: " + file.errorString();
+        return false;
+    }
+
+    file.write(out);
+
+    if (!file.commit()) {
+        if (error) *error = "Failed to write trace file: " + file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace trace
@@ -0,0 +1,83 @@
+#ifndef TRACEEVENT_H
+#define TRACEEVENT_H
+
+#include <QString>
+#include <QtGlobal>
+
+/*
+ * Trace-event ring buffer (format Chrome trace / Perfetto).
+ *
+ * Event disimpan sebagai record biner fixed-size di ring buffer global
+ * (lock-free, slot ditimpa saat penuh). Tidak ada format string saat
+ * recording; konversi ke JSON hanya terjadi saat dump().
+ *
+ * Macro TRACE_* hanya aktif kalau dibuild dengan -DRADARSCAN_TRACE=ON,
+ * selain itu macro menjadi no-op dan tidak ada biaya runtime.
+ *
+ * Nama event HARUS string literal / static (pointer disimpan, bukan isi).
+ */
+namespace trace {
+
+enum class Phase : char {
+    Complete = 'X',
+    Instant = 'i',
+    Counter = 'C'
+};
+
+constexpr bool compiledIn()
+{
+#ifdef RADARSCAN_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 nowNs();
+
+void record(Phase phase, const char *name, qint64 tsNs, qint64 durNs = 0, qint64 value = 0);
+
+inline void instant(const char *name, qint64 value = 0)
+{
+    record(Phase::Instant, name, nowNs(), 0, value);
+}
+
+inline void counter(const char *name, qint64 value)
+{
+    record(Phase::Counter, name, nowNs(), 0, value);
+}
+
+// Durasi scope dicatat sebagai satu event 'X'.
+class Scope
+{
+public:
+    explicit Scope(const char *name) : m_name(name), m_startNs(nowNs()) {}
+    ~Scope() { record(Phase::Complete, m_name, m_startNs, nowNs() - m_startNs); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_name;
+    qint64 m_startNs;
+};
+
+// Tulis isi ring ke file JSON yang bisa dibuka di chrome://tracing / ui.perfetto.dev.
+bool dump(const QString &path, QString *error = nullptr);
+void clear();
+
+} // namespace trace
+
+#ifdef RADARSCAN_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_INSTANT(name, value) trace::instant(name, value)
+#define TRACE_COUNTER(name, value) trace::counter(name, value)
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_INSTANT(name, value) do {} while (0)
+#define TRACE_COUNTER(name, value) do {} while (0)
+#endif
+
+#endif // TRACEEVENT_H
@@ -0,0 +1,381 @@
+#include "voicerecorder.h"
+
+#include "metrics.h"
+#include "socketioclient.h"
+#include "telemetrycodec.h"
+
+#include <QDebug>
+#include <QJsonObject>
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr quint64 RING_MASK = VoiceRecorder::RING_SAMPLES - 1;
+}
+
+//---------------------------------------------------------------------------------------
+VoiceRecorder::VoiceRecorder(SocketIOClient *client, QObject *parent)
+    : QObject(parent)
+    , m_client(client)
+{
+    m_ring.resize(RING_SAMPLES);
+    m_chunkPcm.resize(CHUNK_SAMPLES);
+
+    m_drainTimer.setInterval(DRAIN_MS);
+    connect(&m_drainTimer, &QTimer::timeout, this, [this]() { drain(false); });
+
+    // Pengaman kalau mode berikutnya tidak pernah datang
+    m_limitTimer.setSingleShot(true);
+    m_limitTimer.setInterval(MAX_RECORD_MS);
+    connect(&m_limitTimer, &QTimer::timeout, this, [this]() {
+        qWarning() << "VoiceRecorder: batas durasi tercapai, rekaman dihentikan";
+        stop();
+    });
+
+    for (const char *name : {"VOICE_RECORD_START", "VOICE_RECORD_CHUNK", "VOICE_RECORD_END"}) {
+        m_client->setEventLane(name, SocketIOClient::EventLane::Control);
+        m_client->setEventPersistent(name, false);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+VoiceRecorder::~VoiceRecorder()
+{
+    teardown();
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::stop()
+{
+    finish(QString());
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::finish(const QString &error)
+{
+    if (!m_recording)
+        return;
+
+    m_drainTimer.stop();
+    m_limitTimer.stop();
+
+    // Thread pulse berhenti dulu, baru sisa ring dikirim sebagai chunk terakhir
+    teardown();
+    drain(true);
+
+    m_recording = false;
+
+    const quint64 overrun = m_overrun.load(std::memory_order_relaxed);
+
+    QJsonObject obj;
+    obj["session"] = qint64(m_session);
+    obj["chunks"] = qint64(m_seq);
+    obj["samples"] = qint64(m_samplesSent);
+    obj["duration_ms"] = qint64(m_samplesSent * 1000 / SAMPLE_RATE);
+    obj["overrun_samples"] = qint64(overrun);
+    if (!error.isEmpty())
+        obj["error"] = error;
+    m_client->enqueueEvent("VOICE_RECORD_END", obj);
+
+    if (overrun > 0)
+        METRIC_COUNTER("voice.overrun_samples").inc(overrun);
+
+    qDebug() << "VoiceRecorder stopped: session" << m_session << "chunks" << m_seq
+             << "samples" << m_samplesSent << "overrun" << overrun;
+
+    if (!error.isEmpty())
+        emit failed(error);
+
+    emit stopped(m_session, m_seq, qint64(m_samplesSent));
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::capture(const qint16 *x, int n)
+{
+    // Producer tunggal (thread pulse). x == nullptr = hole -> silence supaya timeline utuh.
+    const quint64 w = m_written.load(std::memory_order_relaxed);
+    const quint64 r = m_read.load(std::memory_order_acquire);
+    const int room = RING_SAMPLES - int(w - r);
+    const int take = std::min(n, room);
+
+    if (take < n)
+        m_overrun.fetch_add(quint64(n - take), std::memory_order_relaxed);
+
+    const int pos = int(w & RING_MASK);
+    const int first = std::min(take, RING_SAMPLES - pos);
+    qint16 *ring = m_ring.data();
+
+    if (x) {
+        std::memcpy(ring + pos, x, size_t(first) * sizeof(qint16));
+        std::memcpy(ring, x + first, size_t(take - first) * sizeof(qint16));
+    } else {
+        std::fill(ring + pos, ring + pos + first, qint16(0));
+        std::fill(ring, ring + (take - first), qint16(0));
+    }
+
+    m_written.store(w + quint64(take), std::memory_order_release);
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::drain(bool final)
+{
+    const qint16 *ring = m_ring.constData();
+
+    for (;;) {
+        const quint64 w = m_written.load(std::memory_order_acquire);
+        const quint64 r = m_read.load(std::memory_order_relaxed);
+        const int avail = int(w - r);
+
+        // Chunk penuh saja selama merekam; sisa parsial hanya saat selesai
+        if (avail <= 0 || (avail < CHUNK_SAMPLES && !final))
+            break;
+
+        const int n = std::min(avail, CHUNK_SAMPLES);
+        const int pos = int(r & RING_MASK);
+        const int first = std::min(n, RING_SAMPLES - pos);
+
+        std::memcpy(m_chunkPcm.data(), ring + pos, size_t(first) * sizeof(qint16));
+        std::memcpy(m_chunkPcm.data() + first, ring, size_t(n - first) * sizeof(qint16));
+
+        m_read.store(r + quint64(n), std::memory_order_release);
+
+        sendChunk(m_chunkPcm.constData(), n, final && n == avail);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::sendChunk(const qint16 *pcm, int n, bool last)
+{
+    telemetry::VoiceChunk chunk;
+    chunk.session = m_session;
+    chunk.seq = m_seq;
+    chunk.sampleIndex = quint32(m_samplesSent);
+    chunk.samples = quint16(n);
+    chunk.predictor = m_adpcm.predictor;
+    chunk.stepIndex = m_adpcm.stepIndex;
+    chunk.last = last;
+    chunk.adpcm.resize(adpcm::encodedSize(n));
+
+    adpcm::encode(pcm, n, m_adpcm, reinterpret_cast<uchar *>(chunk.adpcm.data()));
+
+    // Bentuk JSON tetap lengkap: dipakai kalau format biner belum / tidak lagi disetujui
+    QJsonObject obj;
+    obj["session"] = qint64(chunk.session);
+    obj["seq"] = qint64(chunk.seq);
+    obj["sample_index"] = qint64(chunk.sampleIndex);
+    obj["samples"] = n;
+    obj["predictor"] = chunk.predictor;
+    obj["step_index"] = chunk.stepIndex;
+    obj["last"] = last;
+    obj["data"] = QString::fromLatin1(chunk.adpcm.toBase64());
+
+    m_client->enqueueTelemetry("VOICE_RECORD_CHUNK", obj, telemetry::encodeVoiceChunk(chunk));
+
+    if (m_seq == 0)
+        METRIC_HISTOGRAM("voice.first_chunk_ms").record(quint64(m_clock.elapsed()));
+
+    METRIC_COUNTER("voice.chunks").inc();
+    METRIC_COUNTER("voice.adpcm_bytes").inc(quint64(chunk.adpcm.size()));
+
+    m_seq++;
+    m_samplesSent += quint64(n);
+}
+
+#ifdef PLATFORM_LINUX
+
+//---------------------------------------------------------------------------------------
+bool VoiceRecorder::start(const QString &sourceName)
+{
+    if (m_recording)
+        return true;
+
+    m_sourceName = sourceName;
+
+    // Thread pulse belum jalan: ring dan encoder aman di-reset dari sini
+    m_written.store(0, std::memory_order_relaxed);
+    m_read.store(0, std::memory_order_relaxed);
+    m_overrun.store(0, std::memory_order_relaxed);
+    m_adpcm = adpcm::State();
+    m_seq = 0;
+    m_samplesSent = 0;
+    m_session = QRandomGenerator::global()->generate();
+
+    m_mainloop = pa_threaded_mainloop_new();
+    m_context = pa_context_new(pa_threaded_mainloop_get_api(m_mainloop), "radarScanVoice");
+    pa_context_set_state_callback(m_context, contextStateCallback, this);
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    if (pa_threaded_mainloop_start(m_mainloop) < 0
+        || pa_context_connect(m_context, nullptr, PA_CONTEXT_NOFAIL, nullptr) < 0) {
+        pa_threaded_mainloop_unlock(m_mainloop);
+        qWarning() << "VoiceRecorder: gagal konek PulseAudio";
+        teardown();
+        return false;
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    m_recording = true;
+    m_clock.start();
+    m_drainTimer.start();
+    m_limitTimer.start();
+
+    QJsonObject obj;
+    obj["session"] = qint64(m_session);
+    obj["codec"] = "ima_adpcm";
+    obj["sample_rate"] = SAMPLE_RATE;
+    obj["channels"] = 1;
+    obj["chunk_ms"] = CHUNK_MS;
+    m_client->enqueueEvent("VOICE_RECORD_START", obj);
+
+    qDebug() << "VoiceRecorder started: session" << m_session << "on"
+             << (sourceName.isEmpty() ? QStringLiteral("default source") : sourceName);
+
+    emit started(m_session);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::teardown()
+{
+    if (!m_mainloop)
+        return;
+
+    pa_threaded_mainloop_lock(m_mainloop);
+
+    if (m_stream) {
+        pa_stream_set_state_callback(m_stream, nullptr, nullptr);
+        pa_stream_set_read_callback(m_stream, nullptr, nullptr);
+        pa_stream_set_overflow_callback(m_stream, nullptr, nullptr);
+        pa_stream_disconnect(m_stream);
+        pa_stream_unref(m_stream);
+        m_stream = nullptr;
+    }
+
+    if (m_context) {
+        pa_context_set_state_callback(m_context, nullptr, nullptr);
+        pa_context_disconnect(m_context);
+        pa_context_unref(m_context);
+        m_context = nullptr;
+    }
+
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    pa_threaded_mainloop_stop(m_mainloop);
+    pa_threaded_mainloop_free(m_mainloop);
+    m_mainloop = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::postFailure(const QString &error)
+{
+    const quint32 session = m_session;
+
+    QMetaObject::invokeMethod(this, [this, session, error]() {
+        if (m_recording && m_session == session)
+            finish(error);
+    }, Qt::QueuedConnection);
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::contextStateCallback(pa_context *c, void *userdata)
+{
+    auto *self = static_cast<VoiceRecorder *>(userdata);
+
+    switch (pa_context_get_state(c)) {
+    case PA_CONTEXT_READY:
+        break;
+
+    case PA_CONTEXT_FAILED:
+    case PA_CONTEXT_TERMINATED:
+        self->postFailure(QStringLiteral("Koneksi PulseAudio gagal"));
+        return;
+
+    default:
+        return;
+    }
+
+    if (self->m_stream)
+        return;
+
+    pa_sample_spec spec;
+    spec.format = PA_SAMPLE_S16LE;
+    spec.rate = SAMPLE_RATE;
+    spec.channels = 1;
+
+    self->m_stream = pa_stream_new(c, "voiceRecord", &spec, nullptr);
+    if (!self->m_stream) {
+        self->postFailure(QStringLiteral("Gagal membuat stream record"));
+        return;
+    }
+
+    pa_stream_set_state_callback(self->m_stream, streamStateCallback, self);
+    pa_stream_set_read_callback(self->m_stream, readCallback, self);
+    pa_stream_set_overflow_callback(self->m_stream, overflowCallback, self);
+
+    pa_buffer_attr attr;
+    attr.maxlength = uint32_t(-1);
+    attr.tlength = uint32_t(-1);
+    attr.prebuf = uint32_t(-1);
+    attr.minreq = uint32_t(-1);
+    attr.fragsize = uint32_t(pa_usec_to_bytes(CAPTURE_FRAGMENT_MS * PA_USEC_PER_MSEC, &spec));
+
+    const QByteArray device = self->m_sourceName.toUtf8();
+
+    if (pa_stream_connect_record(self->m_stream, device.isEmpty() ? nullptr : device.constData(), &attr,
+                                 PA_STREAM_ADJUST_LATENCY) < 0) {
+        self->postFailure(QStringLiteral("Gagal konek stream record"));
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::streamStateCallback(pa_stream *s, void *userdata)
+{
+    const pa_stream_state_t state = pa_stream_get_state(s);
+
+    if (state == PA_STREAM_FAILED || state == PA_STREAM_TERMINATED)
+        static_cast<VoiceRecorder *>(userdata)->postFailure(QStringLiteral("Stream record berhenti"));
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::readCallback(pa_stream *s, size_t, void *userdata)
+{
+    auto *self = static_cast<VoiceRecorder *>(userdata);
+
+    while (pa_stream_readable_size(s) > 0) {
+        const void *data = nullptr;
+        size_t len = 0;
+
+        if (pa_stream_peek(s, &data, &len) < 0 || len == 0)
+            break;
+
+        self->capture(static_cast<const qint16 *>(data), int(len / sizeof(qint16)));
+
+        pa_stream_drop(s);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void VoiceRecorder::overflowCallback(pa_stream *, void *userdata)
+{
+    // Buffer server penuh: sampel hilang di sisi server, tidak bisa ditambal
+    static_cast<VoiceRecorder *>(userdata)->m_overrun.fetch_add(
+        quint64(SAMPLE_RATE * CAPTURE_FRAGMENT_MS / 1000), std::memory_order_relaxed);
+}
+
+#else
+
+//---------------------------------------------------------------------------------------
+bool VoiceRecorder::start(const QString &)
+{
+    return false;
+}
+
+void VoiceRecorder::teardown()
+{
+}
+
+#endif
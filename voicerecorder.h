@@ -0,0 +1,107 @@
+#ifndef VOICERECORDER_H
+#define VOICERECORDER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include <atomic>
+
+#include "imaadpcm.h"
+
+#ifdef PLATFORM_LINUX
+    #include <pulse/pulseaudio.h>
+#endif
+
+class SocketIOClient;
+
+/*
+ * Rekaman suara mode RECORDING yang di-stream ke backend selama merekam.
+ *
+ * Stream record libpulse (s16 mono SAMPLE_RATE) menulis ke ring PCM
+ * RING_SAMPLES yang dialokasikan sekali dan dipakai ulang tiap sesi (SPSC:
+ * thread pulse menulis, thread GUI membaca, tanpa lock). Tiap DRAIN_MS
+ * thread GUI mengambil chunk CHUNK_MS, meng-encode IMA ADPCM secara
+ * inkremental dan mengirimnya sebagai VOICE_RECORD_CHUNK (attachment biner
+ * telemetry::VoiceChunk, atau JSON base64 kalau format biner belum
+ * disetujui server). Backend bisa mulai memproses sebelum rekaman selesai.
+ *
+ * Urutan event per sesi: VOICE_RECORD_START, VOICE_RECORD_CHUNK (seq
+ * 0..n), VOICE_RECORD_END. Semua lane control, tidak dijournal.
+ */
+class VoiceRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VoiceRecorder(SocketIOClient *client, QObject *parent = nullptr);
+    ~VoiceRecorder();
+
+    bool isRecording() const { return m_recording; }
+    quint32 session() const { return m_session; }
+
+    static constexpr int SAMPLE_RATE = 16000;
+    static constexpr int CHUNK_MS = 200;
+    static constexpr int CHUNK_SAMPLES = SAMPLE_RATE * CHUNK_MS / 1000;
+    static constexpr int DRAIN_MS = 100;
+    static constexpr int CAPTURE_FRAGMENT_MS = 20;
+    static constexpr int RING_SAMPLES = 1 << 15;        // ~2 s, pangkat dua
+    static constexpr int MAX_RECORD_MS = 60000;
+
+public slots:
+    // sourceName kosong = default source
+    bool start(const QString &sourceName = QString());
+    void stop();
+
+signals:
+    void started(quint32 session);
+    void stopped(quint32 session, quint32 chunks, qint64 samples);
+    void failed(const QString &error);
+
+private:
+    void drain(bool final);
+    void sendChunk(const qint16 *pcm, int n, bool last);
+    void finish(const QString &error);
+    void teardown();
+
+    // Thread pulse
+    void capture(const qint16 *x, int n);
+
+#ifdef PLATFORM_LINUX
+    static void contextStateCallback(pa_context *c, void *userdata);
+    static void streamStateCallback(pa_stream *s, void *userdata);
+    static void readCallback(pa_stream *s, size_t nbytes, void *userdata);
+    static void overflowCallback(pa_stream *s, void *userdata);
+
+    void postFailure(const QString &error);
+
+    pa_threaded_mainloop *m_mainloop = nullptr;
+    pa_context *m_context = nullptr;
+    pa_stream *m_stream = nullptr;
+#endif
+
+    SocketIOClient *m_client;
+    QString m_sourceName;
+
+    // Ring PCM (pool, dipakai ulang antar sesi)
+    QVector<qint16> m_ring;
+    std::atomic<quint64> m_written{0};
+    std::atomic<quint64> m_read{0};
+    std::atomic<quint64> m_overrun{0};
+
+    // Thread GUI
+    QVector<qint16> m_chunkPcm;
+    adpcm::State m_adpcm;
+    quint32 m_session = 0;
+    quint32 m_seq = 0;
+    quint64 m_samplesSent = 0;
+
+    QTimer m_drainTimer;
+    QTimer m_limitTimer;
+    QElapsedTimer m_clock;
+    bool m_recording = false;
+};
+
+#endif // VOICERECORDER_H
@@ -11,6 +11,8 @@
     #include <pulse/pulseaudio.h>
 #endif
 
+// Kontrol volume lewat proses pactl (blocking). Aplikasi memakai
+// VolumeMonitor (libpulse async); kelas ini hanya untuk debug manual.
 class volume : public QObject
 {
     Q_OBJECT